@@ -0,0 +1,26 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Declarations of the benchmark cases of the simulation and geometry.       *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_BENCHMARK_BENCHMARK_CASES_H_
+#define WANDERERS_BENCHMARK_BENCHMARK_CASES_H_
+
+/* Internal Includes */
+#include "benchmark_suite.h"
+
+namespace wanderers {
+namespace benchmark {
+
+/* Adds the cases of orbits, orbital systems, orientations and the catalog, over populations generated from the seed. */
+void addSimulationCases(BenchmarkSuite& suite, const BenchmarkOptions& options);
+
+/* Adds the cases generating meshes: subdivided icosahedrons, smoothed normals, surfaces and stars. */
+void addGeometryCases(BenchmarkSuite& suite, const BenchmarkOptions& options);
+
+} // namespace benchmark
+} // namespace wanderers
+
+#endif // WANDERERS_BENCHMARK_BENCHMARK_CASES_H_
@@ -0,0 +1,112 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Class to time benchmark cases and report the times.                       *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_BENCHMARK_BENCHMARK_SUITE_H_
+#define WANDERERS_BENCHMARK_BENCHMARK_SUITE_H_
+
+/* STL Includes */
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace wanderers {
+namespace benchmark {
+
+/* Options for what is benchmarked and how, the population sizes are the items of the cases. */
+struct BenchmarkOptions {
+	/* Untimed runs of each case before the timed repetitions. */
+	int warmup{ 2 };
+	int repetitions{ 10 };
+
+	/* Only cases whose name contains the filter are run. */
+	std::string filter{};
+	/* File the results are written to as JSON, "-" for the standard output. Not written if empty. */
+	std::string json_output{};
+
+	/* Seed of the generated populations, so every run times the same work. */
+	unsigned int seed{ 1 };
+
+	/* Orbits for the orbit cases. */
+	int orbits{ 100'000 };
+	/* Solar systems, each with a solar and planets, every other planet with moons. */
+	int systems{ 1'000 };
+	int planets{ 8 };
+	int moons{ 2 };
+
+	/* Orientations for the orientation and rotation cases. */
+	int orientations{ 100'000 };
+
+	/* Sub division levels of the subdivided icosahedrons, up to the max level. */
+	int max_sub_division{ 6 };
+	/* Sub division level of the mesh whose normals are smoothed, the smoothing is quadratic in the vertices. */
+	int normals_sub_division{ 3 };
+	/* Sub division level of the generated surface. */
+	int surface_sub_division{ 5 };
+
+	int stars{ 100'000 };
+};
+
+/* Parse the benchmark options from the command line arguments. */
+BenchmarkOptions parseOptions(int argc, char** args);
+
+/*
+ * Class running benchmark cases and reporting their times.
+ * Each case is run untimed for the warm-up and then timed for each repetition, with its setup run
+ *   untimed before every run. The times are reported in milliseconds per repetition and in
+ *   nanoseconds per item, the items being the size of the population the case runs over.
+ */
+class BenchmarkSuite {
+public:
+	BenchmarkSuite(BenchmarkOptions options);
+
+	/* Adds a case running the function over the items, the setup runs before each run without being timed. */
+	void addCase(const std::string& name, std::size_t items, std::function<void(void)> function,
+	             std::function<void(void)> setup = nullptr);
+
+	/* Runs the cases matching the filter, writing the time of each as it is done. */
+	void run(std::ostream& out);
+
+	/* Writes the options and the times of the cases run as JSON. */
+	void writeJson(std::ostream& out);
+
+	/* Keeps a result from being optimized away. */
+	static void consume(double value);
+
+private:
+	struct Case {
+		std::string name;
+		std::size_t items;
+		std::function<void(void)> function;
+		std::function<void(void)> setup;
+		/* Milliseconds of each timed repetition, empty if not run. */
+		std::vector<double> times;
+	};
+
+	/* Summary of the times of a case. */
+	struct Statistics {
+		double min;
+		double median;
+		double mean;
+		double max;
+		double deviation;
+		/* Nanoseconds per item of the median. */
+		double item_time;
+	};
+
+	static Statistics summarize(const Case& benchmark_case);
+
+	BenchmarkOptions options_;
+
+	std::vector<Case> cases_;
+};
+
+} // namespace benchmark
+} // namespace wanderers
+
+#endif // WANDERERS_BENCHMARK_BENCHMARK_SUITE_H_
@@ -0,0 +1,45 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Main execution entry point for the Wanderers benchmarks.                  *
+ * Times the simulation and geometry without a window or a context.          *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Internal Includes */
+#include "benchmark_cases.h"
+#include "benchmark_suite.h"
+
+/* STL Includes */
+#include <fstream>
+#include <iostream>
+
+/*
+ * Main function, entry point for execution.
+ * - Add the cases over the populations of the options.
+ * - Run them, writing the times as they are done.
+ * - Write the results as JSON if asked for.
+ */
+int main(int argc, char** args) {
+	wanderers::benchmark::BenchmarkOptions options{ wanderers::benchmark::parseOptions(argc, args) };
+
+	wanderers::benchmark::BenchmarkSuite suite{ options };
+	wanderers::benchmark::addSimulationCases(suite, options);
+	wanderers::benchmark::addGeometryCases(suite, options);
+
+	suite.run(std::cout);
+
+	if (options.json_output == "-") {
+		suite.writeJson(std::cout);
+	} else if (!options.json_output.empty()) {
+		std::ofstream json{ options.json_output };
+		if (!json) {
+			std::cout << "Error: Could not open " << options.json_output << " for writing." << std::endl;
+			return 1;
+		}
+		suite.writeJson(json);
+	}
+
+	return 0;
+}
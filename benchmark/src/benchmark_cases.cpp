@@ -0,0 +1,248 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the benchmark cases of the simulation and geometry.     *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "benchmark_cases.h"
+
+/* External Includes */
+#include "glm/gtc/quaternion.hpp"
+
+/* Internal Includes */
+#include "common/orientation.h"
+#include "simulation/object/aggregate_object.h"
+#include "simulation/object/model/icosahedron.h"
+#include "simulation/object/model/surface.h"
+#include "simulation/object/orbit.h"
+#include "simulation/object/orbital_system.h"
+#include "simulation/object/planet.h"
+#include "simulation/object/solar.h"
+#include "simulation/object/stars.h"
+#include "simulation/space_simulation.h"
+
+/* STL Includes */
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace wanderers {
+namespace benchmark {
+
+namespace object = simulation::object;
+
+namespace {
+
+/* Seconds of a simulation step. */
+constexpr double kTimeStep{ 1.0 / 60.0 };
+
+/* Exposes the generation of the icosahedron vertices to the cases. */
+class IcosahedronGenerator : public object::model::Icosahedron {
+public:
+	using Icosahedron::generateIcosahedron;
+	using Icosahedron::subDivide;
+};
+
+/* Returns the number of vertices of the icosahedron subdivided to the level, three per triangle. */
+std::size_t subDividedVertices(int level) {
+	return std::size_t{ 60 } << (2 * level);
+}
+
+/* Objects the simulation cases run over, generated once. */
+struct SimulationPopulation {
+	std::vector<object::Orbit> orbits;
+	/* The solar systems are held by value, their objects point back at them so they are never moved. */
+	std::deque<object::OrbitalSystem> system_storage;
+	std::vector<object::OrbitalSystem*> systems;
+	/* Solars and planets of the systems. */
+	std::vector<object::AstronomicalObject*> catalog;
+
+	std::vector<common::Orientation> orientations;
+	std::vector<glm::quat> rotations;
+	std::vector<glm::quat> turns;
+	std::vector<glm::quat> composed;
+	std::vector<glm::mat4> matrices;
+};
+
+/* Returns a random unit vector. */
+glm::vec3 randomDirection(std::minstd_rand& random) {
+	std::normal_distribution<float> component{ 0.0f, 1.0f };
+	glm::vec3 direction{ component(random), component(random), component(random) };
+	return glm::length(direction) > 0.0001f ? glm::normalize(direction) : object::AbstractObject::kUp;
+}
+
+/* Returns an orbit between the radii, as the solar system generator does. */
+object::Orbit* randomOrbit(std::minstd_rand& random, float lower_radius, float upper_radius, float velocity_factor) {
+	std::uniform_real_distribution<float> angle{ 0.0f, glm::radians(360.0f) };
+	std::uniform_real_distribution<float> inclination{ 0.0f, glm::radians(10.0f) };
+	float semimajor_axis{ std::uniform_real_distribution<float>{ lower_radius, upper_radius }(random) };
+	float eccentricity{ std::uniform_real_distribution<float>{ 0.0f, 0.3f }(random) };
+	return new object::Orbit{ eccentricity, semimajor_axis, inclination(random), angle(random), angle(random), angle(random),
+	                          1000.0f * velocity_factor / (semimajor_axis * semimajor_axis) };
+}
+
+/* Returns a planet rotating around an axis tilted from up. */
+object::Planet* randomPlanet(std::minstd_rand& random, float radius) {
+	std::uniform_real_distribution<float> angle{ -360.0f, 360.0f };
+	std::uniform_real_distribution<float> tilt{ -0.5f, 0.5f };
+	std::uniform_real_distribution<float> color{ 0.0f, 1.0f };
+	object::AstronomicalObject astronomical_object{
+		object::AbstractObject{ object::AbstractObject::kOrigo, object::AbstractObject::kUp, object::AbstractObject::kFace, glm::vec3{ radius } },
+		new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } },
+		angle(random), angle(random), glm::normalize(glm::vec3{ tilt(random), 1.0f, tilt(random) }), object::AbstractObject::kFace };
+	return new object::Planet{ astronomical_object, glm::vec3{ color(random), color(random), color(random) } };
+}
+
+/*
+ * Fills the solar system with a solar and the planets, every other planet being a system with the moons.
+ */
+void randomSolarSystem(std::minstd_rand& random, const BenchmarkOptions& options, object::OrbitalSystem* solar_system) {
+	solar_system->addOrbit(new object::Solar{ 5.0f, 5800.0f });
+
+	float distance{ 10.0f };
+	for (int planet = 0; planet < options.planets; planet++) {
+		object::Orbit* orbit{ randomOrbit(random, distance, distance + 10.0f, 5.0f) };
+		distance += 10.0f;
+		if (planet % 2 == 1 && options.moons > 0) {
+			object::OrbitalSystem* planet_system{ new object::OrbitalSystem{ randomPlanet(random, 1.0f) } };
+			for (int moon = 0; moon < options.moons; moon++)
+				planet_system->addOrbit(randomPlanet(random, 0.2f), randomOrbit(random, 2.0f + moon, 2.5f + moon, 1.0f));
+			solar_system->addOrbit(planet_system, orbit);
+		} else {
+			solar_system->addOrbit(randomPlanet(random, 1.0f), orbit);
+		}
+	}
+}
+
+} // namespace
+
+/*
+ * addSimulationCases:
+ * - Generate the orbits, the solar systems and the orientations from the seed.
+ * - Add the cases, each sharing the population.
+ */
+void addSimulationCases(BenchmarkSuite& suite, const BenchmarkOptions& options) {
+	std::shared_ptr<SimulationPopulation> population{ std::make_shared<SimulationPopulation>() };
+	std::minstd_rand random{ options.seed };
+
+	population->orbits.reserve(options.orbits);
+	for (int i = 0; i < options.orbits; i++) {
+		std::unique_ptr<object::Orbit> orbit{ randomOrbit(random, 10.0f, 100.0f, 5.0f) };
+		population->orbits.push_back(*orbit);
+	}
+
+	for (int i = 0; i < options.systems; i++) {
+		population->system_storage.emplace_back();
+		population->systems.push_back(&population->system_storage.back());
+		randomSolarSystem(random, options, population->systems.back());
+	}
+	for (object::OrbitalSystem* system : population->systems)
+		simulation::constructCatalog(population->catalog, system);
+
+	for (int i = 0; i < options.orientations; i++) {
+		glm::vec3 normal{ randomDirection(random) };
+		population->orientations.push_back(common::Orientation{ normal, glm::cross(normal, randomDirection(random)) });
+		population->rotations.push_back(population->orientations.back().getRotation());
+		population->turns.push_back(glm::angleAxis(0.01f, randomDirection(random)));
+	}
+	population->composed.resize(options.orientations);
+	population->matrices.resize(options.orientations);
+
+	suite.addCase("Orbit::elapseTime", population->orbits.size(), [population]() {
+		for (object::Orbit& orbit : population->orbits)
+			orbit.elapseTime(kTimeStep);
+	});
+	suite.addCase("Orbit::getMatrix", population->orbits.size(), [population]() {
+		float sum{ 0.0f };
+		for (object::Orbit& orbit : population->orbits)
+			sum += orbit.getMatrix()[3][0];
+		BenchmarkSuite::consume(sum);
+	});
+
+	suite.addCase("OrbitalSystem::elapseTime", population->catalog.size(), [population]() {
+		for (object::OrbitalSystem* system : population->systems)
+			system->elapseTime(kTimeStep);
+	});
+	// Interpolating also evaluates the matrices of the bodies.
+	suite.addCase("OrbitalSystem::interpolate", population->catalog.size(), [population]() {
+		float sum{ 0.0f };
+		for (object::OrbitalSystem* system : population->systems) {
+			system->interpolate(0.5f);
+			sum += system->getBodyMatrices()[0][0][3];
+		}
+		BenchmarkSuite::consume(sum);
+	});
+
+	suite.addCase("constructCatalog", population->catalog.size(), [population]() {
+		std::vector<object::AstronomicalObject*> catalog{};
+		for (object::OrbitalSystem* system : population->systems)
+			simulation::constructCatalog(catalog, system);
+		BenchmarkSuite::consume(static_cast<double>(catalog.size()));
+	});
+
+	suite.addCase("Orientation::orientationMatrix", population->orientations.size(), [population]() {
+		float sum{ 0.0f };
+		for (common::Orientation& orientation : population->orientations)
+			sum += orientation.orientationMatrix()[0][1];
+		BenchmarkSuite::consume(sum);
+	});
+	suite.addCase("composeRotations", population->rotations.size(), [population]() {
+		common::composeRotations(population->turns.data(), population->rotations.data(), population->composed.data(),
+		                         population->rotations.size());
+		BenchmarkSuite::consume(population->composed.empty() ? 0.0f : population->composed.back().w);
+	});
+	suite.addCase("rotationMatrices", population->rotations.size(), [population]() {
+		common::rotationMatrices(population->rotations.data(), population->matrices.data(), population->rotations.size());
+		BenchmarkSuite::consume(population->matrices.empty() ? 0.0f : population->matrices.back()[0][1]);
+	});
+}
+
+/*
+ * addGeometryCases:
+ * - Add a subdivision case for each level up to the max level.
+ * - Add the normals case, its setup copying the subdivided vertices the mesh takes ownership of.
+ * - Add the surface and star cases, deleting what they generate.
+ */
+void addGeometryCases(BenchmarkSuite& suite, const BenchmarkOptions& options) {
+	for (int level = 0; level <= options.max_sub_division; level++) {
+		suite.addCase("Icosahedron::subDivide/" + std::to_string(level), subDividedVertices(level), [level]() {
+			std::vector<glm::vec3>* vertices{ IcosahedronGenerator::subDivide(IcosahedronGenerator::generateIcosahedron(), level) };
+			BenchmarkSuite::consume(vertices->back().x);
+			delete vertices;
+		});
+	}
+
+	// The mesh generates flat normals and smooths them when constructed as triangles.
+	std::shared_ptr<std::vector<glm::vec3>> subdivided{
+		IcosahedronGenerator::subDivide(IcosahedronGenerator::generateIcosahedron(), options.normals_sub_division) };
+	std::shared_ptr<std::vector<glm::vec3>*> vertices{ std::make_shared<std::vector<glm::vec3>*>(nullptr) };
+	suite.addCase("Mesh::smoothNormals/" + std::to_string(options.normals_sub_division), subdivided->size(), [vertices]() {
+		object::model::Icosahedron mesh{ *vertices };
+		*vertices = nullptr;
+		BenchmarkSuite::consume(mesh.getNormals()->back().x);
+	}, [subdivided, vertices]() {
+		*vertices = new std::vector<glm::vec3>{ *subdivided };
+	});
+
+	const int surface_level{ options.surface_sub_division };
+	const unsigned int seed{ options.seed };
+	suite.addCase("Surface::generateGeometry/" + std::to_string(surface_level), subDividedVertices(surface_level), [surface_level, seed]() {
+		object::model::Surface::Geometry geometry{ object::model::Surface::generateGeometry(surface_level, 0.5f, seed) };
+		BenchmarkSuite::consume(geometry.normals->back().x);
+		delete geometry.vertices;
+		delete geometry.normals;
+	});
+
+	const int stars{ options.stars };
+	suite.addCase("Stars::generateGalaxyDisc", stars, [stars]() {
+		object::model::Points* points{ object::Stars::generateGalaxyDisc(stars) };
+		BenchmarkSuite::consume(static_cast<double>(points->count()));
+		delete points;
+	});
+}
+
+} // namespace benchmark
+} // namespace wanderers
@@ -0,0 +1,183 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the BenchmarkSuite class.                               *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "benchmark_suite.h"
+
+/* STL Includes */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+namespace wanderers {
+namespace benchmark {
+
+/* Sink of the consumed results, volatile so the results are computed. */
+static volatile double result_sink{ 0.0 };
+
+/*
+ *  parseOptions:
+ *  - For each argument:
+ *    - Set the option it names, reading its value from the next argument.
+ *  - Return the options.
+ */
+BenchmarkOptions parseOptions(int argc, char** args) {
+	BenchmarkOptions options{};
+	for (int i = 1; i < argc; i++) {
+		const char* option{ args[i] };
+		const char* value{ i + 1 < argc ? args[i + 1] : "" };
+		if (std::strcmp(option, "--warmup") == 0) {
+			options.warmup = std::atoi(value); i++;
+		} else if (std::strcmp(option, "--repetitions") == 0) {
+			options.repetitions = std::atoi(value); i++;
+		} else if (std::strcmp(option, "--filter") == 0) {
+			options.filter = value; i++;
+		} else if (std::strcmp(option, "--json") == 0) {
+			options.json_output = value; i++;
+		} else if (std::strcmp(option, "--seed") == 0) {
+			options.seed = static_cast<unsigned int>(std::strtoul(value, nullptr, 10)); i++;
+		} else if (std::strcmp(option, "--orbits") == 0) {
+			options.orbits = std::atoi(value); i++;
+		} else if (std::strcmp(option, "--systems") == 0) {
+			options.systems = std::atoi(value); i++;
+		} else if (std::strcmp(option, "--planets") == 0) {
+			options.planets = std::atoi(value); i++;
+		} else if (std::strcmp(option, "--moons") == 0) {
+			options.moons = std::atoi(value); i++;
+		} else if (std::strcmp(option, "--orientations") == 0) {
+			options.orientations = std::atoi(value); i++;
+		} else if (std::strcmp(option, "--max-sub-division") == 0) {
+			options.max_sub_division = std::atoi(value); i++;
+		} else if (std::strcmp(option, "--normals-sub-division") == 0) {
+			options.normals_sub_division = std::atoi(value); i++;
+		} else if (std::strcmp(option, "--surface-sub-division") == 0) {
+			options.surface_sub_division = std::atoi(value); i++;
+		} else if (std::strcmp(option, "--stars") == 0) {
+			options.stars = std::atoi(value); i++;
+		} else {
+			std::cout << "Warning: Unknown option " << option << "." << std::endl;
+		}
+	}
+	options.repetitions = std::max(options.repetitions, 1);
+	options.warmup = std::max(options.warmup, 0);
+	return options;
+}
+
+BenchmarkSuite::BenchmarkSuite(BenchmarkOptions options) : options_{ options }, cases_{} {}
+
+void BenchmarkSuite::addCase(const std::string& name, std::size_t items, std::function<void(void)> function,
+                             std::function<void(void)> setup) {
+	cases_.push_back({ name, items, function, setup, {} });
+}
+
+/*
+ * BenchmarkSuite run:
+ * - For each case matching the filter:
+ *   - Run the warm-up untimed.
+ *   - Time each repetition, running the setup before it untimed.
+ *   - Write the median and the spread of the times.
+ */
+void BenchmarkSuite::run(std::ostream& out) {
+	out << std::left << std::setw(40) << "Case" << std::right << std::setw(12) << "Items" << std::setw(12) << "Median ms"
+	    << std::setw(12) << "Min ms" << std::setw(12) << "Max ms" << std::setw(14) << "ns per item" << "\n";
+	for (Case& benchmark_case : cases_) {
+		if (benchmark_case.name.find(options_.filter) == std::string::npos)
+			continue;
+
+		for (int i = 0; i < options_.warmup; i++) {
+			if (benchmark_case.setup)
+				benchmark_case.setup();
+			benchmark_case.function();
+		}
+
+		benchmark_case.times.clear();
+		for (int i = 0; i < options_.repetitions; i++) {
+			if (benchmark_case.setup)
+				benchmark_case.setup();
+			std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+			benchmark_case.function();
+			std::chrono::steady_clock::time_point end{ std::chrono::steady_clock::now() };
+			benchmark_case.times.push_back(std::chrono::duration<double, std::milli>{ end - start }.count());
+		}
+
+		Statistics statistics{ summarize(benchmark_case) };
+		out << std::left << std::setw(40) << benchmark_case.name << std::right << std::fixed
+		    << std::setw(12) << benchmark_case.items << std::setprecision(3) << std::setw(12) << statistics.median
+		    << std::setw(12) << statistics.min << std::setw(12) << statistics.max
+		    << std::setprecision(2) << std::setw(14) << statistics.item_time << std::endl;
+	}
+}
+
+/*
+ * BenchmarkSuite writeJson:
+ * - Write the run options and the population sizes.
+ * - Write the statistics and the times of each case run.
+ */
+void BenchmarkSuite::writeJson(std::ostream& out) {
+	out << std::setprecision(6) << std::fixed;
+	out << "{\n"
+	    << "  \"warmup\": " << options_.warmup << ",\n"
+	    << "  \"repetitions\": " << options_.repetitions << ",\n"
+	    << "  \"seed\": " << options_.seed << ",\n"
+	    << "  \"population\": { \"orbits\": " << options_.orbits << ", \"systems\": " << options_.systems
+	    << ", \"planets\": " << options_.planets << ", \"moons\": " << options_.moons
+	    << ", \"orientations\": " << options_.orientations << ", \"max_sub_division\": " << options_.max_sub_division
+	    << ", \"normals_sub_division\": " << options_.normals_sub_division
+	    << ", \"surface_sub_division\": " << options_.surface_sub_division << ", \"stars\": " << options_.stars << " },\n"
+	    << "  \"cases\": [";
+
+	bool first{ true };
+	for (const Case& benchmark_case : cases_) {
+		if (benchmark_case.times.empty())
+			continue;
+		Statistics statistics{ summarize(benchmark_case) };
+		out << (first ? "\n" : ",\n")
+		    << "    { \"name\": \"" << benchmark_case.name << "\", \"items\": " << benchmark_case.items
+		    << ", \"min_ms\": " << statistics.min << ", \"median_ms\": " << statistics.median
+		    << ", \"mean_ms\": " << statistics.mean << ", \"max_ms\": " << statistics.max
+		    << ", \"stddev_ms\": " << statistics.deviation << ", \"ns_per_item\": " << statistics.item_time
+		    << ", \"times_ms\": [";
+		for (std::size_t i = 0; i < benchmark_case.times.size(); i++)
+			out << (i > 0 ? ", " : "") << benchmark_case.times[i];
+		out << "] }";
+		first = false;
+	}
+	out << "\n  ]\n}" << std::endl;
+}
+
+void BenchmarkSuite::consume(double value) {
+	result_sink = result_sink + value;
+}
+
+/*
+ * BenchmarkSuite summarize:
+ * - Sort the times for the min, median and max.
+ * - Find the mean and the standard deviation.
+ */
+BenchmarkSuite::Statistics BenchmarkSuite::summarize(const Case& benchmark_case) {
+	std::vector<double> times{ benchmark_case.times };
+	std::sort(times.begin(), times.end());
+	const std::size_t count{ times.size() };
+
+	Statistics statistics{};
+	statistics.min = times.front();
+	statistics.max = times.back();
+	statistics.median = count % 2 == 1 ? times[count / 2] : 0.5 * (times[count / 2 - 1] + times[count / 2]);
+	for (double time : times)
+		statistics.mean += time / count;
+	for (double time : times)
+		statistics.deviation += (time - statistics.mean) * (time - statistics.mean) / count;
+	statistics.deviation = std::sqrt(statistics.deviation);
+	statistics.item_time = benchmark_case.items > 0 ? statistics.median * 1e6 / benchmark_case.items : 0.0;
+	return statistics;
+}
+
+} // namespace benchmark
+} // namespace wanderers
@@ -0,0 +1,32 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Tag following an input event until the frame showing it is presented.     *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_COMMON_INPUT_STAMP_H_
+#define WANDERERS_COMMON_INPUT_STAMP_H_
+
+namespace wanderers {
+namespace common {
+
+/* Types of input, latency is measured for each type. */
+enum class InputType {
+	Key, CursorPosition, Scroll, Count
+};
+
+static constexpr int kInputTypeCount{ static_cast<int>(InputType::Count) };
+
+/* Sequence number and time of an input event. */
+struct InputStamp {
+	/* Sequence number of the event, increasing with each event. 0 if there is no event. */
+	unsigned long long sequence;
+	/* Time of the event in seconds, as given by glfwGetTime. */
+	double time;
+};
+
+} // namespace common
+} // namespace wanderers
+
+#endif // WANDERERS_COMMON_INPUT_STAMP_H_
@@ -0,0 +1,27 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Functions for evaluating noise over many points at once.                  *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_COMMON_NOISE_H_
+#define WANDERERS_COMMON_NOISE_H_
+
+/* STL Includes */
+#include <cstddef>
+
+namespace wanderers {
+namespace common {
+
+/*
+ * Classic Perlin noise for count points, the same algorithm as glm::perlin.
+ * The points are given as separate coordinate arrays, which lets four points be computed at a time with SSE.
+ * NOTE: Falls back to glm::perlin for each point when SSE2 is not available.
+ */
+void perlin(const float* x, const float* y, const float* z, float* result, std::size_t count);
+
+} // namespace common
+} // namespace wanderers
+
+#endif // WANDERERS_COMMON_NOISE_H_
@@ -10,6 +10,10 @@
 
 /* External Includes */
 #include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+/* STL Includes */
+#include <cstddef>
 
 namespace wanderers {
 namespace common {
@@ -17,6 +21,9 @@ namespace common {
 
 /*
  * Class for representing orientation in space. 
+ * The orientation is stored as the rotation of the default orientation, where the normal is up,
+ *   the tangent is front and the bitangent is right. The axes are rotated out of it when asked for.
+ * The rotation is only normalized when rotating it has made it drift from unit length.
  */
 class Orientation {
 public:
@@ -32,6 +39,9 @@ public:
 
 	Orientation(glm::vec3 normal, glm::vec3 tangent);
 
+	/* Orientation rotated by the passed rotation from the default orientation. */
+	explicit Orientation(glm::quat rotation);
+
 	/* Sets the orientation with the matrix over the passed orientation. */
 	void transform(glm::mat4 matrix, Orientation orientation);
 	
@@ -63,6 +73,9 @@ public:
 	/* Get the matrix for the orientation from the passed orientation. */
 	glm::mat4 orientationMatrix(Orientation from);
 
+	/* Returns the rotation from the default orientation. */
+	glm::quat getRotation() const;
+
 protected:
 	/* Normalized a vector, asserts error if vector is zero. */
 	glm::vec3 normalize(glm::vec3 vector);
@@ -70,17 +83,46 @@ protected:
 	/* Returns a vector that is orthogonal to the normal based on the vector given. */
 	glm::vec3 orthogonalize(glm::vec3 vector, glm::vec3 normal);
 
-	/* Sets the passed normal to axis, and sets passed tangent and bitangent correspondingly. */
-	void setAxis(glm::vec3 axis, glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent);
+	/* Sets the orientation from a normal and a tangent orthogonal to it. */
+	void setAxes(glm::vec3 normal, glm::vec3 tangent);
+
+	/*
+	 * Rotates the orientation so the axis, default_axis in the default orientation, points along the passed axis.
+	 * If opposite, turns it around the axis that is flip_axis in the default orientation.
+	 */
+	void setAxis(glm::vec3 axis, glm::vec3 default_axis, glm::vec3 flip_axis);
 
-	/* Rotate tangent and bitangent around the normal and return the passed vector rotated. */
-	glm::vec3 rotation(float angle_in_radians, glm::vec3 vector, glm::vec3 normal, glm::vec3& tangent, glm::vec3& bitangent);
+	/* Rotate the orientation around the axis, default_axis in the default orientation, and return the passed vector rotated. */
+	glm::vec3 rotation(float angle_in_radians, glm::vec3 vector, glm::vec3 default_axis);
 
-	glm::vec3 normal_;
-	glm::vec3 tangent_;
-	glm::vec3 bitangent_;
+	/* Normalizes the rotation if it has drifted from unit length. */
+	void renormalize();
+
+	glm::quat rotation_;
+
+	/* Drift of the squared length of the rotation from one before it is normalized. */
+	static constexpr float kDriftTolerance{ 1e-5f };
+	/* Distance of the cosine between an axis and the axis set from minus one below which they are taken as opposite. */
+	static constexpr float kOppositeTolerance{ 1e-3f };
 };
 
+/* Returns the rotation matrix of the rotation, which does not have to be normalized. */
+glm::mat4 rotationMatrix(glm::quat rotation);
+
+/*
+ * Composes count pairs of rotations, result[i] = lhs[i] * rhs[i].
+ * Four rotations are composed at a time with SSE.
+ * NOTE: Falls back to composing one at a time when SSE2 is not available.
+ */
+void composeRotations(const glm::quat* lhs, const glm::quat* rhs, glm::quat* result, std::size_t count);
+
+/*
+ * Converts count rotations into rotation matrices, like rotationMatrix.
+ * Four rotations are converted at a time with SSE.
+ * NOTE: Falls back to converting one at a time when SSE2 is not available.
+ */
+void rotationMatrices(const glm::quat* rotations, glm::mat4* matrices, std::size_t count);
+
 static const Orientation kXOrientation{Orientation::kRight, Orientation::kUp};
 static const Orientation kYOrientation{Orientation::kUp, Orientation::kFront};
 static const Orientation kZOrientation{Orientation::kFront, Orientation::kUp};
@@ -0,0 +1,77 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Lock-free queue between one producing and one consuming thread.           *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_COMMON_RING_BUFFER_H_
+#define WANDERERS_COMMON_RING_BUFFER_H_
+
+/* STL Includes */
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace wanderers {
+namespace common {
+
+/*
+ * Class for passing values from one thread to another without locking.
+ * The producer only writes the head and the consumer only writes the tail, each published
+ *   with release and read with acquire, so neither waits on the other.
+ * NOTE: Only one thread may push and only one thread may pop. The capacity has to be a power of two.
+ */
+template <typename T, std::size_t kCapacity>
+class RingBuffer {
+public:
+	static_assert(kCapacity > 0 && (kCapacity & (kCapacity - 1)) == 0, "Capacity has to be a power of two.");
+
+	RingBuffer() : head_{ 0 }, tail_{ 0 }, values_{} {}
+
+	/* Adds the value to the queue. Returns false if the queue is full. Called by the producer. */
+	bool push(const T& value) {
+		const std::size_t head{ head_.load(std::memory_order_relaxed) };
+		if (head - tail_.load(std::memory_order_acquire) == kCapacity)
+			return false;
+		values_[head & (kCapacity - 1)] = value;
+		head_.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/* Takes the oldest value from the queue. Returns false if the queue is empty. Called by the consumer. */
+	bool pop(T& value) {
+		const std::size_t tail{ tail_.load(std::memory_order_relaxed) };
+		if (head_.load(std::memory_order_acquire) == tail)
+			return false;
+		value = values_[tail & (kCapacity - 1)];
+		tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/* Returns the number of values in the queue, which may have changed when it returns. */
+	std::size_t size() const {
+		return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+	}
+
+	bool full() const { return size() >= kCapacity; }
+
+private:
+	/* Size of a cache line, the head and tail are kept on separate lines so the threads do not share one. */
+	static constexpr std::size_t kCacheLineSize{ 64 };
+
+	/* Position of the next push, only written by the producer. */
+	std::atomic<std::size_t> head_;
+	char head_padding_[kCacheLineSize - sizeof(std::atomic<std::size_t>)];
+
+	/* Position of the next pop, only written by the consumer. */
+	std::atomic<std::size_t> tail_;
+	char tail_padding_[kCacheLineSize - sizeof(std::atomic<std::size_t>)];
+
+	std::array<T, kCapacity> values_;
+};
+
+} // namespace common
+} // namespace wanderers
+
+#endif // WANDERERS_COMMON_RING_BUFFER_H_
@@ -0,0 +1,106 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Per thread stack of memory for short lived allocations.                   *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_COMMON_SCRATCH_ALLOCATOR_H_
+#define WANDERERS_COMMON_SCRATCH_ALLOCATOR_H_
+
+/* STL Includes */
+#include <cstddef>
+#include <vector>
+
+namespace wanderers {
+namespace common {
+
+/*
+ * Class for allocating memory that only lives within a scope, without locking or freeing.
+ * Each thread has its own allocator, memory is taken from the end of the current block and
+ *   released all at once when the scope that took it ends. The blocks are kept for reuse.
+ * NOTE: Only use the allocator of the calling thread, and do not keep memory past its scope.
+ */
+class ScratchAllocator {
+public:
+	/* Position in the allocator, memory taken after it is released by rewinding to it. */
+	struct Marker {
+		std::size_t block;
+		std::size_t offset;
+	};
+
+	/* Returns size bytes aligned to the alignment, valid until the allocator is rewound past it. */
+	void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+	Marker getMarker();
+	void rewind(Marker marker);
+
+	/* Returns the bytes of all blocks. */
+	std::size_t getCapacity();
+
+	/* Getter for the allocator of the calling thread. */
+	static ScratchAllocator* getThreadScratch();
+
+	~ScratchAllocator();
+private:
+	ScratchAllocator();
+
+	struct Block {
+		unsigned char* data;
+		std::size_t size;
+	};
+
+	std::vector<Block> blocks_;
+	std::size_t block_;
+	std::size_t offset_;
+
+	/* Smallest block, larger allocations get a block of their own size. */
+	static constexpr std::size_t kBlockSize{ 64 * 1024 };
+};
+
+/*
+ * Releases the scratch memory of the calling thread taken during the lifetime of the scope.
+ */
+class ScratchScope {
+public:
+	ScratchScope();
+	~ScratchScope();
+
+	ScratchScope(const ScratchScope&) = delete;
+	ScratchScope& operator=(const ScratchScope&) = delete;
+private:
+	ScratchAllocator::Marker marker_;
+};
+
+/*
+ * Allocator taking memory from the scratch allocator of the calling thread, for containers living within a scratch scope.
+ */
+template <typename T>
+class ScratchStlAllocator {
+public:
+	typedef T value_type;
+
+	ScratchStlAllocator() {}
+	template <typename U>
+	ScratchStlAllocator(const ScratchStlAllocator<U>&) {}
+
+	T* allocate(std::size_t count) {
+		return static_cast<T*>(ScratchAllocator::getThreadScratch()->allocate(sizeof(T) * count, alignof(T)));
+	}
+	/* Memory is released by the scope. */
+	void deallocate(T*, std::size_t) {}
+};
+
+template <typename T, typename U>
+bool operator==(const ScratchStlAllocator<T>&, const ScratchStlAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const ScratchStlAllocator<T>&, const ScratchStlAllocator<U>&) { return false; }
+
+/* Vector with its elements in scratch memory. */
+template <typename T>
+using ScratchVector = std::vector<T, ScratchStlAllocator<T>>;
+
+} // namespace common
+} // namespace wanderers
+
+#endif // WANDERERS_COMMON_SCRATCH_ALLOCATOR_H_
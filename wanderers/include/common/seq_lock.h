@@ -0,0 +1,72 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Value published by writers and read without blocking by readers.         *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_COMMON_SEQ_LOCK_H_
+#define WANDERERS_COMMON_SEQ_LOCK_H_
+
+/* STL Includes */
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace wanderers {
+namespace common {
+
+/*
+ * Class for publishing a value to readers on other threads without locking.
+ * The sequence is odd while the value is written. A reader copies the value and retries if the
+ *   sequence was odd or changed during the copy, so readers never block the writer and a reader
+ *   only waits while a copy is being written.
+ * NOTE: Only one thread may store at a time, writers have to be serialized by the caller.
+ */
+template <typename T>
+class SeqLock {
+public:
+	static_assert(std::is_trivially_copyable<T>::value, "The value is copied byte by byte, so it has to be trivially copyable.");
+
+	SeqLock() : sequence_{ 0 }, value_{} {}
+
+	/* Publishes the value. */
+	void store(const T& value) {
+		const unsigned long long sequence{ sequence_.load(std::memory_order_relaxed) };
+		sequence_.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		std::memcpy(&value_, &value, sizeof(T));
+		sequence_.store(sequence + 2, std::memory_order_release);
+	}
+
+	/* Returns a copy of the last published value. */
+	T load() const {
+		T value;
+		while (true) {
+			const unsigned long long sequence{ sequence_.load(std::memory_order_acquire) };
+			if (sequence & 1) {
+				std::this_thread::yield();
+				continue;
+			}
+			std::memcpy(&value, &value_, sizeof(T));
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (sequence_.load(std::memory_order_relaxed) == sequence)
+				return value;
+		}
+	}
+
+	/* Returns the number of values published. */
+	unsigned long long getVersion() const {
+		return sequence_.load(std::memory_order_acquire) / 2;
+	}
+
+private:
+	std::atomic<unsigned long long> sequence_;
+	T value_;
+};
+
+} // namespace common
+} // namespace wanderers
+
+#endif // WANDERERS_COMMON_SEQ_LOCK_H_
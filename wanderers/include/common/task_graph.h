@@ -0,0 +1,100 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Class to run tasks with dependencies on the thread pool.                  *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_COMMON_TASK_GRAPH_H_
+#define WANDERERS_COMMON_TASK_GRAPH_H_
+
+/* STL Includes */
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace wanderers {
+namespace common {
+
+/*
+ * Class for running a graph of tasks, each task runs when the tasks it depends on are done.
+ * Ready tasks are run by helpers on the thread pool and by the thread waiting for the graph,
+ *   so the graph finishes even if no worker is free. Each task runs in a scratch scope.
+ * The time of each task is measured, and the longest chain of dependent tasks of the last run
+ *   can be reported to see what bounds the time of the graph.
+ * NOTE: Add tasks, start and wait from one thread, the report can be written from any thread.
+ *   Tasks can only depend on earlier tasks.
+ */
+class TaskGraph {
+public:
+	typedef std::size_t TaskId;
+
+	TaskGraph();
+
+	/* Adds a task running after its dependencies, returns its id. Only add tasks while the graph is not running. */
+	TaskId addTask(const std::string& name, std::function<void(void)> function, const std::vector<TaskId>& dependencies = {});
+
+	/* Removes all tasks, waiting for the graph if running. */
+	void clear();
+
+	/* Starts running the tasks on the thread pool. */
+	void start();
+
+	/* Runs ready tasks on the calling thread until all tasks are done. Returns at once if not started. */
+	void wait();
+
+	/* Runs all tasks and waits for them. */
+	void run();
+
+	bool isRunning();
+
+	/* Writes the time of the last finished run, and the tasks on its critical path. */
+	void report(std::ostream& out);
+
+	~TaskGraph();
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	struct Task {
+		std::string name;
+		std::function<void(void)> function;
+		std::vector<TaskId> dependencies;
+		std::vector<TaskId> dependents;
+		/* Dependencies not yet done, while running. */
+		std::size_t remaining;
+		Clock::time_point start_time;
+		Clock::time_point end_time;
+	};
+
+	/* Tasks of the graph and the state of a run, shared with the helpers as they may run after the graph is done. */
+	struct Run {
+		std::vector<Task> tasks;
+		std::deque<TaskId> ready;
+		std::size_t done_tasks;
+		std::mutex mutex;
+		std::condition_variable condition;
+		Clock::time_point start_time;
+		Clock::time_point end_time;
+	};
+
+	/* Run tasks while any is ready, readying the dependents of each task run. */
+	static void runTasks(std::shared_ptr<Run> run);
+
+	std::shared_ptr<Run> run_;
+	/* The last finished run, kept for the report. */
+	std::shared_ptr<Run> finished_;
+	std::mutex finished_mutex_;
+	bool is_running_;
+};
+
+} // namespace common
+} // namespace wanderers
+
+#endif // WANDERERS_COMMON_TASK_GRAPH_H_
@@ -0,0 +1,64 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Class to spread work over a set of worker threads.                        *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_COMMON_THREAD_POOL_H_
+#define WANDERERS_COMMON_THREAD_POOL_H_
+
+/* STL Includes */
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wanderers {
+namespace common {
+
+/*
+ * Class for running tasks on a fixed set of worker threads.
+ */
+class ThreadPool {
+public:
+	/* Starts the workers, by default one less than the number of hardware threads. */
+	ThreadPool(unsigned int thread_count = defaultThreadCount());
+
+	/* Queues the task to run on a worker. */
+	void submit(std::function<void(void)> task);
+
+	/* 
+	 * Runs the function for batches [begin, end) of the range [0, count) on the workers and the calling thread.
+	 * Returns when all batches are done. Can be called from within a task.
+	 */
+	void parallelFor(std::size_t count, std::size_t batch_size, std::function<void(std::size_t, std::size_t)> function);
+
+	unsigned int getThreadCount();
+
+	/* Getter for the thread pool shared by the program. */
+	static ThreadPool* getThreadPool();
+
+	static unsigned int defaultThreadCount();
+
+	~ThreadPool();
+private:
+	/* Run the worker loop, running tasks until stopped. */
+	void runWorker();
+
+	std::vector<std::thread> workers_;
+
+	std::deque<std::function<void(void)>> tasks_;
+
+	bool should_stop_;
+	std::mutex mutex_;
+	std::condition_variable condition_;
+};
+
+} // namespace common
+} // namespace wanderers
+
+#endif // WANDERERS_COMMON_THREAD_POOL_H_
@@ -13,6 +13,8 @@
 #include "glfw/glfw3.h"
 
 /* Internal Includes */
+#include "common/input_stamp.h"
+#include "common/ring_buffer.h"
 #include "render/camera.h"
 #include "simulation/space_simulation.h"
 #include "render/space_renderer.h"
@@ -21,7 +23,9 @@
 /* STL Includes */
 #include <set>
 #include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 namespace wanderers {
@@ -32,6 +36,8 @@ namespace control {
 /* 
  * Class for which to store key and mouse input changes and interpret them
  *   in the context of the program.
+ * The input callbacks push timestamped events into a lock-free queue, which the controller
+ *   thread drains once per rendered frame.
  */
 class Controller : public ControlInterface{
 public:
@@ -43,45 +49,51 @@ public:
 	/* Getter for the controller singleton. */
 	static Controller* getController();
 
+	/* Lets the controller handle the input of the frame. Called by the render loop after the events are polled. */
+	void notifyFrame();
+
 	~Controller();
 private:
 	std::vector<ControlInterface*> controls_;
 
+	/* Camera the handled input is stamped on, so its latency can be measured. */
+	render::Camera* camera_;
+
 	/* Boolean for stopping the controller thread. */
 	std::atomic<bool> should_stop_;
 
-	/* Class to store cursor position change. */
-	class CursorPosition {
-	public:
-		CursorPosition();
-
-		/* Set cursor position and update cursor change. */
-		void updatePosition(glm::vec2 position);
-		/* Set cursor position without updating cursor change. */
-		void setPosition(glm::vec2 position);
+	/* Input from the callbacks, stored in the order it happened. */
+	struct InputEvent {
+		common::InputType type;
+		/* Sequence number and time of the event, following it to the frame showing it. */
+		common::InputStamp stamp;
+		int key;
+		int action;
+		/* Cursor position or scroll offset. */
+		glm::vec2 value;
+	};
 
-		glm::vec2 getPosition();
+	/* Number of events that can wait to be handled, enough for several frames of fast mouse movement. */
+	static constexpr std::size_t kInputCapacity{ 4096 };
 
-		/* Get the change in cursor position since last fetch. */
-		glm::vec2 fetchDelta();
-	private:
-		std::mutex cursor_position_mutex_;
+	/* Events passed from the callbacks on the main thread to the controller thread. */
+	common::RingBuffer<InputEvent, kInputCapacity> input_events_;
 
-		glm::vec2 position_;
+	/* Sequence number of the next event, only used by the callbacks. */
+	unsigned long long input_sequence_;
 
-		/* Change in cursor position. */
-		glm::vec2 delta_;
-	} cursor_position_; // Cursor position object.
-
-	/* Change in scrolling. */
-	glm::vec2 scroll_offset_;
-
-	/* Key changes. */
+	/* The state below is only used by the controller thread. */
+	glm::vec2 cursor_position_;
 	std::set<int> pressed_keys_;
-	std::set<int> released_keys_;
-	std::set<int> triggered_keys_;
+	std::vector<int> released_keys_;
+	std::vector<int> triggered_keys_;
+
+	/* Number of frames rendered, the controller handles the input once per frame. */
+	long long frame_;
+	std::mutex frame_mutex_;
+	std::condition_variable frame_condition_;
 
-	std::mutex controller_mutex_;
+	std::thread controller_thread_;
 
 	/* Constructor for singleton. */
 	Controller(GLFWwindow* window, render::Camera* camera, simulation::SpaceSimulation* simulation, render::SpaceRenderer* renderer);
@@ -89,13 +101,11 @@ private:
 	/* Run the controller handling loop. */
 	void runController();
 
-	/* Handle changes to control inputs. */
+	/* Handle the input events of the frame and the keys held down. */
 	void handleControls(double seconds);
 
-	/* Store key, mouse and scroll changes for interpretation. */
-	void updateKey(int key, int action);
-	void updateCursorPosition(double x_position, double y_position);
-	void updateScrollOffset(double x_offset, double y_offset);
+	/* Stamp an input event and pass it to the controller thread, waiting for room if the queue is full. */
+	void pushInput(InputEvent input_event);
 
 	/* Interpret key changes and change state of the program. */
 	void enactKeyTrigger(int key, double seconds);
@@ -106,8 +116,8 @@ private:
 	/* Interpret scroll offset changes and change state of the program. */
 	void enactScrollOffset(glm::vec2 offset, double seconds);
 
-	/* Number of possible different key presses. */
-	static constexpr int kNumKeys{ GLFW_KEY_LAST };
+	/* Longest time the controller waits for a frame before handling the input anyway. */
+	static constexpr int kFrameTimeoutMilliseconds{ 100 };
 
 	friend void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 	friend void cursorPositionCallback(GLFWwindow* window, double xpos, double ypos);
@@ -0,0 +1,75 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * This class moves the Camera along a scripted path.                        *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_CONTROL_FLYTHROUGH_H_
+#define WANDERERS_CONTROL_FLYTHROUGH_H_
+
+/* External Includes */
+#include "glm/glm.hpp"
+
+/* Internal Includes */
+#include "render/camera.h"
+#include "simulation/space_simulation.h"
+
+/* STL Includes */
+#include <string>
+#include <vector>
+
+namespace wanderers {
+namespace control {
+
+/*
+ * Class for moving the Camera along a path of keyframes, so every run shows the same frames.
+ * The focus, camera mode and simulation speed change when a keyframe is reached, the position
+ *   of the camera is interpolated from the keyframe to the next and the camera faces the focus.
+ * A script has a keyframe on each line as "time focus mode x y z speed", with the time in seconds,
+ *   the focus as the id in the catalog of the simulation, the mode as free, center, orbital or
+ *   rotational and the position relative the focus in radii of the focus. Lines starting with #
+ *   are comments.
+ */
+class Flythrough {
+public:
+	using CameraMode = simulation::object::CameraObject::CameraMode;
+
+	/* A point on the path. */
+	struct Keyframe {
+		/* Seconds from the start of the path. */
+		double time;
+		unsigned int focus_id;
+		CameraMode mode;
+		/* Position of the camera relative the focus, in radii of the focus. */
+		glm::vec3 offset;
+		double speed;
+	};
+
+	/* Constructs the default path, touring the home system and a neighbouring system. */
+	Flythrough();
+
+	/* Loads the path from the script, returns 0 if successful. */
+	int load(const std::string& path);
+
+	/* Moves the camera to where it is on the path at the time, changing the focus and speed when a keyframe is reached. */
+	void apply(double time, simulation::SpaceSimulation* simulation, render::Camera* camera);
+
+	/* Returns the seconds of the path, the time of the last keyframe. */
+	double getDuration();
+
+private:
+	/* Returns the mode named in the script, or Count if not a mode. */
+	static CameraMode parseMode(const std::string& name);
+
+	/* Keyframes ordered by time. */
+	std::vector<Keyframe> keyframes_;
+
+	/* Keyframe last reached, the size of the keyframes before the first is reached. */
+	std::size_t current_;
+};
+
+} // namespace control
+} // namespace wanderers
+
+#endif // WANDERERS_CONTROL_FLYTHROUGH_H_
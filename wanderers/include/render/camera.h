@@ -12,17 +12,44 @@
 #include "glm/glm.hpp"
 
 /* Internal Includes */
+#include "common/input_stamp.h"
+#include "common/seq_lock.h"
 #include "render/camera_view.h"
 #include "simulation/object/camera_object.h"
 
 /* STL Includes */
-#include <functional>
+#include <atomic>
 
 namespace wanderers {
 namespace render {
 
+/* Snapshot of the pose and view of the camera. */
+struct CameraState {
+	glm::vec3 position;
+	glm::vec3 direction;
+	glm::vec3 up;
+
+	float field_of_view;
+	float near_plane;
+	float far_plane;
+
+	/* Number of times the camera has been changed. */
+	unsigned long long version;
+
+	/* Latest input of each type handled before the state was published, to measure input latency. */
+	common::InputStamp input_stamps[common::kInputTypeCount];
+
+	/* Returns matrix describing the cameras position and direction in world space. */
+	glm::mat4 getViewMatrix() const;
+
+	/* Returns matrix describing the perspective projection of the camera with the aspect ratio. */
+	glm::mat4 getProjectionMatrix(float aspect_ratio) const;
+};
+
 /*
  * Class for the Camera.
+ * Changes are made between lock and unlock, and are published as a state when unlocked.
+ *   The renderer reads the last published state without locking, so changes never block it.
  */
 class Camera : public simulation::object::CameraObject, public CameraView {
 public:
@@ -41,18 +68,29 @@ public:
 	void setShouldClear(bool should_clear);
 	bool getShouldClear();
 
-	/* Disable camera from changing. */
+	/* Disable camera from being changed by other threads. */
 	void lock();
 
-	/* Enables camera from changing. */
+	/* Enables camera from being changed by other threads, and publishes the changes. */
 	void unlock();
 
-	void withMutext(std::function<void(void)> func);
+	/* Returns the last published state of the camera. Does not lock, can be called from any thread. */
+	CameraState getState();
+
+	/* Sets the latest handled input of the type, published with the state. NOTE: Camera has to be locked. */
+	void setInputStamp(common::InputType input_type, common::InputStamp input_stamp);
 protected:
-	bool should_clear_ = true;
+	/* Publishes the state of the camera. NOTE: Camera has to be locked. */
+	void publish();
+
+	std::atomic<bool> should_clear_{ true };
 
 	glm::mat4 view_;
 	glm::mat4 projection_;
+
+	common::InputStamp input_stamps_[common::kInputTypeCount];
+
+	common::SeqLock<CameraState> state_;
 };
 
 } // namespace render
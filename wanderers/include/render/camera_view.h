@@ -11,7 +11,6 @@
 /* External Includes */
 #include "glm/glm.hpp"
 
-#include <functional>
 #include <mutex>
 
 namespace wanderers {
@@ -37,8 +36,6 @@ public:
 	void setNear(float near);
 	void setFar(float far);
 
-	void withMutext(std::function<void(void)> func);
-
 protected:
 
 	float field_of_view_;
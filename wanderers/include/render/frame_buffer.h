@@ -0,0 +1,60 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * This class is an offscreen render target.                                 *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_RENDER_FRAME_BUFFER_H_
+#define WANDERERS_RENDER_FRAME_BUFFER_H_
+
+namespace wanderers {
+namespace render {
+
+/*
+ * Class for rendering into a framebuffer object instead of the window.
+ * When multisampled, the frame is rendered into a multisampled framebuffer
+ *   and resolved into a single sampled one that can be read back.
+ */
+class FrameBuffer {
+public:
+	FrameBuffer(int width, int height, int samples = 0);
+
+	/* Binds the framebuffer as the render target. */
+	void bind();
+	/* Binds the default framebuffer as the render target. */
+	void unbind();
+
+	/* Resolves the multisampled frame, has to be done before the frame is read. */
+	void resolve();
+
+	/* Binds the resolved frame for reading. */
+	void bindRead();
+
+	int getWidth();
+	int getHeight();
+
+	~FrameBuffer();
+private:
+	/* Generates a framebuffer with color and depth renderbuffers. */
+	void generateBuffers(unsigned int& FBO, unsigned int& color_RBO, unsigned int& depth_RBO, int samples);
+
+	int width_;
+	int height_;
+	int samples_;
+
+	/* Framebuffer rendered into. */
+	unsigned int render_FBO_;
+	unsigned int render_color_RBO_;
+	unsigned int render_depth_RBO_;
+
+	/* Framebuffer the multisampled frame is resolved into. Same as the render framebuffer without multisampling. */
+	unsigned int resolve_FBO_;
+	unsigned int resolve_color_RBO_;
+	unsigned int resolve_depth_RBO_;
+};
+
+} // namespace render
+} // namespace wanderers
+
+#endif // WANDERERS_RENDER_FRAME_BUFFER_H_
@@ -0,0 +1,117 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * This class captures rendered frames without stalling the render loop.     *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_RENDER_FRAME_CAPTURE_H_
+#define WANDERERS_RENDER_FRAME_CAPTURE_H_
+
+/* Internal Includes */
+#include "render/frame_writer.h"
+
+/* STL Includes */
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wanderers {
+namespace render {
+
+/*
+ * Class for capturing frames asynchronously.
+ * Each frame is read into the next pixel pack buffer of a ring and fenced. The buffers
+ *   are mapped once their fence has signaled, which is a number of frames later, and the
+ *   pixels are handed to a writer thread that writes them to disk.
+ * NOTE: All functions except setCapturing has to be called from the thread owning the context.
+ */
+class FrameCapture {
+public:
+	/* If drop_when_busy is set, frames are dropped instead of waiting on the GPU or the writer. */
+	FrameCapture(std::string output_directory, FrameWriter::FrameFormat frame_format, int ring_size = 3, bool drop_when_busy = true);
+
+	/* Request capturing to start or stop, takes effect on the next captured frame. Can be called from any thread. */
+	void setCapturing(bool capturing);
+	bool getCapturing();
+
+	/* Reads the bound read framebuffer into the ring if capturing and passes finished frames to the writer. */
+	void capture(int width, int height);
+
+	/* Waits for all captured frames to be read back and written. */
+	void flush();
+
+	int getCapturedFrames();
+	int getDroppedFrames();
+
+	~FrameCapture();
+private:
+	/* A pixel pack buffer of the ring and the fence of the read into it. */
+	struct PixelPackBuffer {
+		unsigned int PBO;
+		void* fence;
+		int frame_number;
+	};
+
+	/* A frame read back from the GPU, waiting to be written. */
+	struct Frame {
+		int frame_number;
+		std::vector<unsigned char> pixels;
+	};
+
+	/* Generates the ring of pixel pack buffers for the frame size. */
+	void generateBuffers(int width, int height);
+	void deleteBuffers();
+
+	/* Maps the buffers that are read back and passes them to the writer. Waits on the GPU for the oldest buffer only if wait is set. */
+	void collect(bool wait);
+
+	/* Passes a frame to the writer thread. Returns false if the frame was dropped. */
+	bool enqueue(PixelPackBuffer& buffer);
+
+	/* Run the writer loop, writing frames until stopped. */
+	void runWriter();
+
+	std::string output_directory_;
+	FrameWriter::FrameFormat frame_format_;
+
+	const bool drop_when_busy_;
+
+	std::vector<PixelPackBuffer> ring_;
+	/* Oldest and next buffer of the ring, and number of buffers waiting to be read back. */
+	int ring_tail_;
+	int ring_head_;
+	int ring_pending_;
+
+	int width_;
+	int height_;
+
+	int frame_number_;
+	int dropped_frames_;
+
+	std::atomic<bool> capturing_requested_;
+	bool capturing_;
+
+	/* Frames waiting to be written, and frames that can be reused. */
+	std::deque<Frame> write_queue_;
+	std::vector<Frame> free_frames_;
+	std::size_t max_queued_frames_;
+	/* Number of frames taken from the queue but not yet written. */
+	int frames_writing_;
+
+	FrameWriter* frame_writer_;
+
+	bool should_stop_;
+	std::mutex writer_mutex_;
+	std::condition_variable writer_condition_;
+	std::thread writer_thread_;
+};
+
+} // namespace render
+} // namespace wanderers
+
+#endif // WANDERERS_RENDER_FRAME_CAPTURE_H_
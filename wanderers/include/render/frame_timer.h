@@ -0,0 +1,74 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * This class measures the CPU and GPU time of each frame.                   *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_RENDER_FRAME_TIMER_H_
+#define WANDERERS_RENDER_FRAME_TIMER_H_
+
+/* STL Includes */
+#include <deque>
+#include <ostream>
+#include <vector>
+
+namespace wanderers {
+namespace render {
+
+/*
+ * Class for measuring the CPU and GPU time of frames.
+ * The CPU time of a frame is the real time between beginFrame and endFrame, the GPU time is
+ *   measured by a timer query around the same commands. The queries are read when their results
+ *   are available, so measuring does not stall the GPU unless all queries are in flight.
+ * NOTE: Has to be used from the thread owning the context.
+ */
+class FrameTimer {
+public:
+	FrameTimer();
+
+	/* Starts timing a frame, waiting for the oldest query if all are in flight. */
+	void beginFrame();
+
+	/* Stops timing the frame, and records the GPU times of the frames that are done. */
+	void endFrame();
+
+	/* Waits for the GPU times of all frames timed. */
+	void finish();
+
+	/* Returns the number of frames with both times recorded. */
+	std::size_t getFrameCount();
+
+	/* Writes the number of frames and the percentiles of their CPU and GPU time in milliseconds. */
+	void report(std::ostream& out);
+
+	/* Writes the percentiles and the times of each frame in milliseconds as JSON. */
+	void writeJson(std::ostream& out);
+
+	/* Removes the recorded times. */
+	void reset();
+
+	~FrameTimer();
+private:
+	/* Records the GPU times of the frames done, waiting for the oldest if asked to. */
+	void collect(bool wait);
+
+	/* Queries not in flight, and queries in flight from the oldest frame. */
+	std::vector<unsigned int> free_queries_;
+	std::deque<unsigned int> pending_queries_;
+
+	/* Real time in seconds the frame being timed began. */
+	double begin_time_;
+
+	/* Times in seconds of each frame. */
+	std::vector<double> cpu_times_;
+	std::vector<double> gpu_times_;
+
+	/* Frames timed on the GPU at once, enough that the results of a frame are ready well before its query is reused. */
+	static constexpr std::size_t kQueryCount{ 8 };
+};
+
+} // namespace render
+} // namespace wanderers
+
+#endif // WANDERERS_RENDER_FRAME_TIMER_H_
@@ -0,0 +1,52 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * This class writes rendered frames to disk as an image sequence.           *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_RENDER_FRAME_WRITER_H_
+#define WANDERERS_RENDER_FRAME_WRITER_H_
+
+/* STL Includes */
+#include <string>
+#include <vector>
+
+namespace wanderers {
+namespace render {
+
+/*
+ * Class for writing frames read back from the GPU to numbered files.
+ * NOTE: Frames are expected as tightly packed RGB rows, bottom row first.
+ */
+class FrameWriter {
+public:
+	/* Format of the written frames. */
+	enum class FrameFormat {
+		/* Binary portable pixmap, top row first. Readable by most video encoders. */
+		Ppm,
+		/* Raw RGB bytes as read from the GPU, bottom row first. */
+		Raw
+	};
+
+	FrameWriter(std::string output_directory, FrameFormat frame_format, int width, int height);
+
+	/* Writes the frame with the given number. Returns 0 if successful. */
+	int write(int frame_number, const std::vector<unsigned char>& pixels);
+
+	/* Returns the path the frame with the given number is written to. */
+	std::string framePath(int frame_number);
+
+private:
+	std::string output_directory_;
+
+	FrameFormat frame_format_;
+
+	int width_;
+	int height_;
+};
+
+} // namespace render
+} // namespace wanderers
+
+#endif // WANDERERS_RENDER_FRAME_WRITER_H_
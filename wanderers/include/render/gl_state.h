@@ -0,0 +1,99 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * This class caches the OpenGL state to remove redundant calls.             *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_RENDER_GL_STATE_H_
+#define WANDERERS_RENDER_GL_STATE_H_
+
+/* STL Includes */
+#include <atomic>
+#include <map>
+#include <ostream>
+
+namespace wanderers {
+namespace render {
+
+/*
+ * Class keeping the OpenGL state last set, so a call is only made when the value changes.
+ * The program, vertex array, buffer bindings, capabilities, depth, blend and point size
+ *   state are cached. Every call that is not made is counted, to see how much it saves.
+ * Element array buffers are part of the vertex array, so they are always bound.
+ * NOTE: Has to be used from the thread owning the context, and all changes to the cached
+ *   state have to go through it. Call invalidate if the state is changed some other way.
+ */
+class GLState {
+public:
+	void useProgram(unsigned int program);
+	void bindVertexArray(unsigned int VAO);
+	void bindBuffer(unsigned int target, unsigned int buffer);
+	/* Binds the buffer to the indexed binding, which also binds it to the target. */
+	void bindBufferBase(unsigned int target, unsigned int index, unsigned int buffer);
+
+	/* Enables or disables the capability, e.g. GL_DEPTH_TEST. */
+	void enable(unsigned int capability);
+	void disable(unsigned int capability);
+
+	void depthFunc(unsigned int function);
+	void depthMask(bool write);
+	void depthRange(float near_value, float far_value);
+	void blendFunc(unsigned int source_factor, unsigned int destination_factor);
+	void pointSize(float size);
+
+	/* Forgets the object if it is bound, as deleting it unbinds it. */
+	void releaseProgram(unsigned int program);
+	void releaseVertexArray(unsigned int VAO);
+	void releaseBuffer(unsigned int buffer);
+
+	/* Forgets all cached state, the next call of each kind is always made. */
+	void invalidate();
+
+	/* Returns the number of calls made and the number removed as redundant. */
+	long long getIssuedCalls();
+	long long getRemovedCalls();
+	void resetCounters();
+
+	/* Writes the number of calls made and removed. */
+	void report(std::ostream& out);
+
+	/* Getter for the GL state singleton. */
+	static GLState* getGLState();
+
+private:
+	GLState();
+
+	/* Counts the call, returns true if it has to be made. */
+	bool changed(bool is_changed);
+
+	/* Value of a binding or state that is not known. */
+	static constexpr unsigned int kUnknown{ 0xFFFFFFFF };
+
+	unsigned int program_;
+	unsigned int VAO_;
+	/* Buffer bound to each target, targets that are not in the map are not known. */
+	std::map<unsigned int, unsigned int> buffers_;
+	/* If each capability is enabled, capabilities that are not in the map are not known. */
+	std::map<unsigned int, bool> capabilities_;
+
+	unsigned int depth_function_;
+	/* 1 if depth is written, 0 if not, -1 if not known. */
+	int depth_mask_;
+	float depth_near_;
+	float depth_far_;
+	bool depth_range_known_;
+	unsigned int blend_source_;
+	unsigned int blend_destination_;
+	/* Negative if not known. */
+	float point_size_;
+
+	/* Counted on the threads using the state, and read and reset on the controller thread. */
+	std::atomic<long long> issued_calls_;
+	std::atomic<long long> removed_calls_;
+};
+
+} // namespace render
+} // namespace wanderers
+
+#endif // WANDERERS_RENDER_GL_STATE_H_
@@ -0,0 +1,124 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * This class draws distant objects as cached billboards.                    *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_RENDER_IMPOSTOR_RENDERER_H_
+#define WANDERERS_RENDER_IMPOSTOR_RENDERER_H_
+
+/* External Includes */
+#include "glm/glm.hpp"
+
+/* Internal Includes */
+#include "render/shader/shader_program.h"
+
+/* STL Includes */
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace wanderers {
+namespace render {
+
+/*
+ * Class to render objects that are small on screen as impostors.
+ * An impostor is the object rendered into a tile of a texture atlas, drawn as a billboard
+ *   facing the camera. The tiles are refreshed when the direction to the object has changed or
+ *   after a number of frames, at most a budget of tiles each frame. Impostors not added for as
+ *   many frames are evicted, so their tiles can be taken by other objects.
+ * All impostors of a frame are drawn with a single instanced draw call.
+ */
+class ImpostorRenderer {
+public:
+	/* Renders the object with the given view, projection and render height. */
+	typedef std::function<void(glm::mat4 view, glm::mat4 projection, int render_height)> RenderFunction;
+
+	ImpostorRenderer(int tile_size = 128, int tiles_per_side = 8, int refresh_budget = 2);
+
+	/* Starts collecting the impostors of a frame seen with the given view and projection, evicting the impostors not used. */
+	void begin(glm::mat4 view, glm::mat4 projection, int render_height);
+
+	/*
+	 * Adds the object with the bounding sphere as an impostor, refreshing its tile if needed and within budget.
+	 * Returns false if the object is too large on screen or has no tile, then it has to be rendered as geometry.
+	 */
+	bool add(const void* object, glm::vec3 center, float radius, RenderFunction render_object);
+
+	/* Draws all collected impostors. */
+	void draw();
+
+	/* Returns the number of impostors drawn and tiles refreshed in the last frame. */
+	int getImpostorCount();
+	int getRefreshCount();
+
+	~ImpostorRenderer();
+private:
+	/* Tile of the atlas and the view it was rendered from. */
+	struct Impostor {
+		int tile;
+		glm::vec3 direction;
+		glm::vec3 right;
+		glm::vec3 up;
+		float half_size;
+		int refreshed_frame;
+		/* Last frame the object was added as impostor. */
+		int added_frame;
+	};
+
+	/* Impostor as stored in the shader storage buffer. NOTE: has to match the std430 layout in the shader. */
+	struct ImpostorInstance {
+		glm::vec4 center_half_size;
+		glm::vec4 right;
+		glm::vec4 up;
+		glm::vec4 tile_rect;
+	};
+
+	/* Renders the object into the tile of the impostor, seen from the camera. Restores the bound framebuffer and viewport. */
+	void refresh(Impostor& impostor, glm::vec3 center, float radius, RenderFunction& render_object);
+
+	/* Maximum size in pixels of an object drawn as impostor, larger objects would lose detail. */
+	float maxPixelSize();
+
+	/* Angle in radians the direction to an object may change before its impostor is refreshed. */
+	static constexpr float kRefreshAngle{ 0.01f };
+	/* Frames until an impostor is refreshed for the object to move, and until an impostor not added is evicted. */
+	static constexpr int kRefreshFrames{ 60 };
+
+	shader::ShaderProgram* shader_;
+
+	const int tile_size_;
+	const int tiles_per_side_;
+	const int refresh_budget_;
+
+	/* Atlas texture, its depth buffer and the framebuffer rendering into the tiles. */
+	unsigned int atlas_;
+	unsigned int depth_RBO_;
+	unsigned int FBO_;
+	/* Empty vertex array object, the vertices are generated in the shader. */
+	unsigned int VAO_;
+	/* Shader storage buffer object, storing the impostor instances. */
+	unsigned int SSBO_;
+	std::size_t capacity_;
+
+	std::map<const void*, Impostor> impostors_;
+	std::vector<int> free_tiles_;
+
+	std::vector<ImpostorInstance> instances_;
+
+	glm::mat4 view_projection_;
+	glm::vec3 camera_position_;
+	glm::vec3 camera_up_;
+	/* Pixels per unit of length at unit distance from the camera. */
+	float pixel_scale_;
+
+	int frame_;
+	int refresh_count_;
+	int impostor_count_;
+};
+
+} // namespace render
+} // namespace wanderers
+
+#endif // WANDERERS_RENDER_IMPOSTOR_RENDERER_H_
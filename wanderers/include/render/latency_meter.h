@@ -0,0 +1,81 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * This class measures the latency from input to presented frame.            *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_RENDER_LATENCY_METER_H_
+#define WANDERERS_RENDER_LATENCY_METER_H_
+
+/* Internal Includes */
+#include "common/input_stamp.h"
+
+/* STL Includes */
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace wanderers {
+namespace render {
+
+/*
+ * Class for measuring the time from an input event to the presentation of the first frame showing its effect.
+ * Each frame is submitted with the stamps of the latest input it shows, and a timestamp query is
+ *   recorded after the swap. The GPU clock is calibrated against the CPU clock when submitted, so
+ *   the time the GPU reached the query is known on the CPU clock however late the result is read.
+ *   The latency of each input not shown by an earlier frame is recorded up to that time.
+ * NOTE: Frames have to be submitted and collected from the thread owning the context,
+ *   the measurement can be enabled, reported and reset from any thread.
+ */
+class LatencyMeter {
+public:
+	LatencyMeter();
+
+	/* Functions to control if latency is measured. Stopping the measurement does not remove the recorded latencies. */
+	void setEnabled(bool enabled);
+	bool getEnabled();
+
+	/* Fences the presented frame, showing the inputs with the stamps. Call after the swap. */
+	void submitFrame(const common::InputStamp (&input_stamps)[common::kInputTypeCount]);
+
+	/* Records the latencies of the frames that have been presented. */
+	void collect();
+
+	/* Writes the number of inputs and the percentiles of their latency in milliseconds, for each type of input. */
+	void report(std::ostream& out);
+
+	/* Removes the recorded latencies. */
+	void reset();
+
+	~LatencyMeter();
+private:
+	/* A presented frame waiting for its timestamp. */
+	struct PendingFrame {
+		unsigned int query;
+		/* Seconds from the GPU clock to the CPU clock when the frame was submitted. */
+		double clock_offset;
+		common::InputStamp input_stamps[common::kInputTypeCount];
+	};
+
+	std::atomic<bool> enabled_;
+
+	/* Sequence of the latest input of each type submitted with a frame. */
+	unsigned long long submitted_sequences_[common::kInputTypeCount];
+
+	std::deque<PendingFrame> pending_frames_;
+
+	/* Latencies in seconds for each type of input, recorded on the render thread and reported on the controller thread. */
+	std::vector<double> latencies_[common::kInputTypeCount];
+	std::mutex latencies_mutex_;
+
+	/* Frames waiting for their timestamps before new frames stop being measured, so a stalled GPU does not grow the queue. */
+	static constexpr std::size_t kMaxPendingFrames{ 16 };
+};
+
+} // namespace render
+} // namespace wanderers
+
+#endif // WANDERERS_RENDER_LATENCY_METER_H_
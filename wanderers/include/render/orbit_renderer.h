@@ -0,0 +1,85 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * This class renders the orbit lines of the space simulation.               *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_RENDER_ORBIT_RENDERER_H_
+#define WANDERERS_RENDER_ORBIT_RENDERER_H_
+
+/* External Includes */
+#include "glm/glm.hpp"
+
+/* Internal Includes */
+#include "render/shader/shader_program.h"
+
+/* STL Includes */
+#include <vector>
+
+namespace wanderers {
+namespace render {
+
+/*
+ * Class to render all orbits of a frame with a single draw call.
+ * The orbits are collected during the frame and stored in a shader storage buffer. The ellipses
+ *   are generated in the vertex shader from the vertex id, one line strip instance per orbit.
+ * The number of segments of each orbit depends on how large it is on screen.
+ */
+class OrbitRenderer {
+public:
+	OrbitRenderer();
+
+	/* Starts collecting the orbits of a frame seen with the given view and projection. */
+	void begin(glm::mat4 view, glm::mat4 projection, int render_height);
+
+	/* Adds an orbit, given by the matrix transforming the unit circle into the orbit ellipse. */
+	void add(glm::mat4 orbit_matrix, glm::vec3 color);
+
+	/* Draws all collected orbits. */
+	void draw();
+
+	/* Returns the number of orbits drawn by the last draw. */
+	int getOrbitCount();
+
+	~OrbitRenderer();
+private:
+	/* Orbit as stored in the shader storage buffer. NOTE: has to match the std430 layout in the shader. */
+	struct OrbitInstance {
+		glm::mat4 orbit_matrix;
+		glm::vec3 color;
+		unsigned int segments;
+	};
+
+	/* Returns the number of segments for the orbit to look smooth, or 0 if it is not visible. */
+	unsigned int segmentCount(const glm::mat4& orbit_matrix);
+
+	static constexpr unsigned int kMinSegments{ 16 };
+	static constexpr unsigned int kMaxSegments{ 2048 };
+	/* Allowed distance in pixels between a segment and the true ellipse. */
+	static constexpr float kPixelTolerance{ 0.25f };
+
+	shader::ShaderProgram* shader_;
+
+	/* Empty vertex array object, the vertices are generated in the shader. */
+	unsigned int VAO_;
+	/* Shader storage buffer object, storing the orbit instances. */
+	unsigned int SSBO_;
+	/* Number of orbit instances the buffer can hold. */
+	std::size_t capacity_;
+
+	std::vector<OrbitInstance> orbits_;
+	unsigned int max_segments_;
+
+	glm::mat4 view_projection_;
+	/* Pixels per unit of length at unit distance from the camera. */
+	float pixel_scale_;
+	glm::vec3 camera_position_;
+
+	int orbit_count_;
+};
+
+} // namespace render
+} // namespace wanderers
+
+#endif // WANDERERS_RENDER_ORBIT_RENDERER_H_
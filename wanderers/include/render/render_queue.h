@@ -0,0 +1,101 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * This class collects the draws of a frame and sorts them by state.         *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_RENDER_RENDER_QUEUE_H_
+#define WANDERERS_RENDER_RENDER_QUEUE_H_
+
+/* External Includes */
+#include "glm/glm.hpp"
+
+/* Internal Includes */
+#include "simulation/object/model/mesh.h"
+
+/* STL Includes */
+#include <cstdint>
+#include <vector>
+
+namespace wanderers {
+namespace render {
+
+/* A draw of a mesh, with the uniforms it is drawn with. */
+struct RenderItem {
+	simulation::object::model::Mesh* mesh;
+	/* Primitive type the mesh is drawn as. */
+	unsigned int primitive_type;
+	glm::mat4 model;
+	glm::vec3 color;
+	bool is_sun;
+	/* Terrain of the planet, only used by the terrain shader. */
+	glm::vec3 terrain_offset;
+	float roughness;
+};
+
+/*
+ * Class to collect the draws of a frame and order them so state changes are minimal.
+ * Each item gets a 64-bit sort key of, from the most significant bits, pass, shader, mesh and depth.
+ *   The keys are sorted with a radix sort, so draws using the same shader and mesh end up next
+ *   to each other, and opaque draws of the same mesh are drawn front to back.
+ * The queue does not touch OpenGL, so it can be built on any thread.
+ */
+class RenderQueue {
+public:
+	/* Passes of the frame, drawn in order. */
+	enum class Pass : unsigned int {
+		/* Drawn front to back. */
+		Opaque,
+		/* Drawn back to front. */
+		Transparent
+	};
+
+	RenderQueue();
+
+	/* Removes all items, keeping the memory. */
+	void clear();
+
+	/* Adds an item drawn in the pass with the shader, at the given distance from the camera. */
+	void add(Pass pass, unsigned int shader, float depth, const RenderItem& item);
+
+	/* Sorts the items by their keys. */
+	void sort();
+
+	/* Returns the number of items. */
+	std::size_t size() const;
+
+	/* Returns the item at the position in sorted order, and its shader. Only valid after sort. */
+	const RenderItem& at(std::size_t position) const;
+	unsigned int getShader(std::size_t position) const;
+
+	/* Returns the sort key of the item drawn in the pass with the shader and mesh at the given distance. */
+	static std::uint64_t makeKey(Pass pass, unsigned int shader, unsigned int mesh_id, float depth);
+
+private:
+	/* Key of an item and its index in the items. */
+	struct SortEntry {
+		std::uint64_t key;
+		std::uint32_t index;
+	};
+
+	/* Bits of the key, from the most significant. */
+	static constexpr int kPassBits{ 4 };
+	static constexpr int kShaderBits{ 4 };
+	static constexpr int kMeshBits{ 24 };
+	static constexpr int kDepthBits{ 32 };
+
+	/* Bits sorted by each pass of the radix sort. */
+	static constexpr int kRadixBits{ 8 };
+
+	std::vector<RenderItem> items_;
+
+	std::vector<SortEntry> entries_;
+	/* Scratch buffer the radix sort ping pongs with. */
+	std::vector<SortEntry> sort_buffer_;
+};
+
+} // namespace render
+} // namespace wanderers
+
+#endif // WANDERERS_RENDER_RENDER_QUEUE_H_
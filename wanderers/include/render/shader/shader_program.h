@@ -22,17 +22,17 @@ namespace wanderers {
 namespace render {
 namespace shader {
 
-// TODO: Generalize to different shader program types.
-
 /*
  * Class for which to link and make shader program with shaders.
  * Also used to set uniform variables in the shaders.
- * NOTE: Only supports vertex-fragment shader for the time being.
+ * NOTE: Supports vertex-fragment shaders, optionally with tessellation shaders in between.
  */
 class ShaderProgram{
 public:
 	ShaderProgram(std::string vertex_path, std::string fragment_path);
 
+	ShaderProgram(std::string vertex_path, std::string tess_control_path, std::string tess_evaluation_path, std::string fragment_path);
+
 	/* Links shaders and creates */
 	int link();
 
@@ -43,6 +43,7 @@ public:
 	void setUniform(glm::mat4 matrix, const char* name);
 	void setUniform(glm::vec3 vector, const char* name);
 	void setUniform(int integer, const char* name);
+	void setUniform(float scalar, const char* name);
 
 	unsigned int getProgramID();
 private:
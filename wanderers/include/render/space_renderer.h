@@ -14,6 +14,13 @@
 /* Internal Includes*/
 #include "render/shader/shader_program.h"
 #include "render/camera.h"
+#include "render/frame_buffer.h"
+#include "render/frame_capture.h"
+#include "render/impostor_renderer.h"
+#include "render/latency_meter.h"
+#include "render/orbit_renderer.h"
+#include "render/render_queue.h"
+#include "render/star_skybox.h"
 
 #include "simulation/space_simulation.h"
 #include "simulation/object/orbital_system.h"
@@ -22,12 +29,18 @@
 #include "simulation/object/planet.h"
 #include "simulation/object/astronomical_object.h"
 
+/* STL Includes */
+#include <functional>
+#include <utility>
+#include <vector>
+
 namespace wanderers {
 namespace render {
 
 /*
  * Class to render the space simulation with the given shader program from the given camera.
- * It renders the whole simulation by going down the simulation structure and drawing each part.
+ * The objects of the simulation are collected into a render queue in one pass down the simulation
+ *   structure, and the queue is drawn in sorted order.
  */
 class SpaceRenderer {
 public:
@@ -44,36 +57,129 @@ public:
 	/* Renders all the stars of the sky. */
 	void render(simulation::object::Stars* stars);
 
-	/* Renders the objects of an orbital system. */
+	/* Renders the objects of an orbital system, through a queue of its own. */
 	void render(simulation::object::OrbitalSystem* orbital_system, glm::mat4 transform = glm::mat4{ 1.0f });
 
-	/* Renders the orbit. */
+	/* Adds the orbit to the orbits drawn at the end of the frame. */
 	void render(simulation::object::Orbit* orbit, glm::vec3 color, glm::mat4 transform = glm::mat4{ 1.0f });
 
-	/* Renders the solar object. */
-	void render(simulation::object::Solar* solar, glm::mat4 transform = glm::mat4{ 1.0f });
-	/* Renders the planet object. */
-	void render(simulation::object::Planet* planet, glm::mat4 transform = glm::mat4{ 1.0f });
-	/* Inteprets the type of astronomical object and renders it accordingly. */
-	void render(simulation::object::AstronomicalObject* object, glm::mat4 transform = glm::mat4{ 1.0f });
+	/* Render into the framebuffer instead of the window. Passing nullptr renders to the window. */
+	void setFrameBuffer(render::FrameBuffer* frame_buffer);
+	render::FrameBuffer* getFrameBuffer();
+
+	/* Capture each rendered frame with the frame capture. Passing nullptr disables capturing. */
+	void setFrameCapture(render::FrameCapture* frame_capture);
+	render::FrameCapture* getFrameCapture();
+
+	/*
+	 * Call the function once the frame no longer reads the simulation, before the frame is drawn.
+	 * The next step of the simulation can be started there to run while the frame is submitted.
+	 * Passing nullptr removes the function.
+	 */
+	void setFramePrepared(std::function<void(void)> frame_prepared);
+
+	/* Returns the meter measuring the latency from input to presented frame. */
+	render::LatencyMeter* getLatencyMeter();
+
+	/* Functions to control if planet terrain is tessellated on the GPU, or generated on the CPU. */
+	void setTessellateTerrain(bool tessellate_terrain);
+	bool getTessellateTerrain();
+
+	/* Functions to control if the far stars are baked into the sky, or rendered each frame. */
+	void setBakeSky(bool bake_sky);
+	bool getBakeSky();
+
+	/* Functions to control if distant solar systems are drawn as impostors. */
+	void setUseImpostors(bool use_impostors);
+	bool getUseImpostors();
 
 	/* Functions to control if orbits should be rendered. */
 	bool showOrbits();
 	void setShowOrbits(bool show_orbits);
 	bool getShowOrbits();
 
+	~SpaceRenderer();
 private:
+	/* Bakes the far stars into the sky if the camera has moved enough. */
+	void bakeSky(simulation::SpaceSimulation* space_simulation);
+
+	/* Adds the solar system as an impostor if it is small on screen. Returns false if it has to be rendered as geometry. */
+	bool renderImpostor(simulation::object::OrbitalSystem* solar_system);
+
+	/* Adds the objects of the orbital system and its subsystems to the queue, and their orbits to the orbit renderer. */
+	void enqueue(simulation::object::OrbitalSystem* orbital_system, glm::mat4 transform, RenderQueue& queue);
+	/* Adds the models of the solar object to the queue, transform being the matrix of the object. */
+	void enqueue(simulation::object::Solar* solar, glm::mat4 transform, RenderQueue& queue);
+	/* Adds the models of the planet object to the queue, as patches if tessellating, transform being the matrix of the object. */
+	void enqueue(simulation::object::Planet* planet, glm::mat4 transform, RenderQueue& queue);
+
+	/* Draws the sorted queue, switching shader and mesh only when they change. */
+	void submit(const RenderQueue& queue);
+
+	/* Renders the stars with the view and projection, point_scale being the point size of a star of unit size. */
+	void renderStars(simulation::object::Stars* stars, glm::mat4 view, glm::mat4 projection, float point_scale, bool twinkle);
+
 	int render_width_{};
 	int render_height_{};
 
 	render::shader::ShaderProgram* shader_;
 
+	/* Shader displacing the planet terrain with tessellation. */
+	render::shader::ShaderProgram* terrain_shader_;
+
+	/* Shader decoding the star directions. */
+	render::shader::ShaderProgram* stars_shader_;
+
+	/* Sky the far stars are baked into. */
+	render::StarSkybox* star_skybox_;
+
+	/* Draws the distant solar systems of the frame. */
+	render::ImpostorRenderer* impostor_renderer_;
+
+	/* Draws the orbits collected during the frame. */
+	render::OrbitRenderer* orbit_renderer_;
+
+	render::LatencyMeter* latency_meter_;
+
+	std::function<void(void)> frame_prepared_;
+
+	/* Objects of the frame, and of an orbital system rendered on its own. */
+	render::RenderQueue frame_queue_;
+	render::RenderQueue system_queue_;
+
+	/* Orbital systems left to visit while building a queue, with their transforms. */
+	std::vector<std::pair<simulation::object::OrbitalSystem*, glm::mat4>> system_stack_;
+
 	render::Camera* camera_;
+	/* Camera as it was when the frame started. */
+	render::CameraState camera_state_;
+	float aspect_ratio_;
+
+	/* Offscreen render target, nullptr when rendering to the window. */
+	render::FrameBuffer* frame_buffer_;
+
+	render::FrameCapture* frame_capture_;
 
 	glm::mat4 projection_;
 	glm::mat4 view_;
 
 	bool show_orbits_;
+
+	bool tessellate_terrain_;
+
+	bool bake_sky_;
+
+	bool use_impostors_;
+
+	/* Shaders of the render queue items. */
+	static constexpr unsigned int kStandardShader{ 0 };
+	static constexpr unsigned int kTerrainShader{ 1 };
+
+	/* Sub division level of the terrain generated on the CPU. */
+	static constexpr int kSurfaceLevel{ 3 };
+
+	/* Distance factor from which stars are baked into the sky, their parallax being below a pixel. */
+	static constexpr float kSkyDistance{ 10'000.0f };
 };
 
 } // namespace render
@@ -0,0 +1,73 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * This class bakes the far stars into a cubemap drawn as the sky.           *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_RENDER_STAR_SKYBOX_H_
+#define WANDERERS_RENDER_STAR_SKYBOX_H_
+
+/* External Includes */
+#include "glm/glm.hpp"
+
+/* Internal Includes */
+#include "render/shader/shader_program.h"
+
+/* STL Includes */
+#include <functional>
+
+namespace wanderers {
+namespace render {
+
+/*
+ * Class to draw stars that are too far away to move on screen as a cubemap.
+ * The stars are rendered into the six faces of the cubemap once, and baked again only when
+ *   the camera has moved so far that the stars would move a texel, or the field of view changed.
+ * The sky is then drawn as a single full-screen pass.
+ */
+class StarSkybox {
+public:
+	StarSkybox(int face_size = 2048);
+
+	/* Returns if the sky has to be baked again, given the distance of the closest baked stars. */
+	bool needsBake(glm::vec3 camera_position, float field_of_view, float min_distance);
+
+	/* 
+	 * Bakes the sky seen from the camera position. render_face renders the stars with the view and projection of each face.
+	 * NOTE: Leaves the framebuffer of the skybox bound.
+	 */
+	void bake(glm::vec3 camera_position, float field_of_view, std::function<void(glm::mat4 view, glm::mat4 projection)> render_face);
+
+	/* Draws the sky behind everything with the rotation of the view. */
+	void draw(glm::mat4 view, glm::mat4 projection);
+
+	/* Makes the next needsBake return true. */
+	void invalidate();
+
+	int getFaceSize();
+
+	/* Returns the number of times the sky has been baked. */
+	int getBakeCount();
+
+	~StarSkybox();
+private:
+	shader::ShaderProgram* shader_;
+
+	int face_size_;
+
+	/* Cubemap texture, framebuffer rendering into its faces and empty vertex array object. */
+	unsigned int cubemap_;
+	unsigned int FBO_;
+	unsigned int VAO_;
+
+	bool baked_;
+	glm::vec3 baked_position_;
+	float baked_field_of_view_;
+	int bake_count_;
+};
+
+} // namespace render
+} // namespace wanderers
+
+#endif // WANDERERS_RENDER_STAR_SKYBOX_H_
@@ -0,0 +1,113 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * This class uploads buffers on its own thread with a shared context.       *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_RENDER_UPLOAD_THREAD_H_
+#define WANDERERS_RENDER_UPLOAD_THREAD_H_
+
+/* External Includes */
+#include "glfw/glfw3.h"
+
+/* STL Includes */
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wanderers {
+namespace render {
+
+/* Data to upload into a new buffer, and the buffer and its fence when uploaded. */
+struct UploadRequest {
+	std::vector<unsigned char> data;
+	/* Set by the upload thread when the copy into the buffer is issued, after the buffer and fence. */
+	std::atomic<bool> issued;
+	unsigned int buffer;
+	/* Signaled when the copy is done, consumed by the thread using the buffer. */
+	void* fence;
+};
+
+/*
+ * Class for uploading buffers without blocking the render thread.
+ * The thread owns a hidden window whose context shares objects with the render context.
+ *   Data is copied into a persistently mapped staging buffer used as a ring, and from there
+ *   into a new buffer by the GPU. Each request gets a fence the render thread polls before
+ *   using the buffer, and each region of the ring is reused when the copy from it is done.
+ * NOTE: Start and stop the thread from the main thread, as windows are created and destroyed there.
+ *   Vertex array objects are not shared between contexts, so they are made by the render thread.
+ */
+class UploadThread {
+public:
+	/* Starts the upload thread, sharing objects with the context of the window. */
+	static void initUploadThread(GLFWwindow* window);
+	/* Uploads the queued requests and stops the upload thread. */
+	static void deinitUploadThread();
+
+	/* Getter for the upload thread singleton, nullptr if not started. */
+	static UploadThread* getUploadThread();
+
+	/* Queues the data to be uploaded into a new buffer. Can be called from any thread. */
+	std::shared_ptr<UploadRequest> upload(std::vector<unsigned char> data);
+
+	/*
+	 * Returns true if the buffer of the request is uploaded, consuming its fence. Call from the thread using the buffer.
+	 * Can be used after the thread is stopped, as all requests are issued then.
+	 */
+	static bool poll(UploadRequest& request);
+	/* Waits until the buffer of the request is uploaded, consuming its fence. Call from the thread using the buffer. */
+	static void wait(UploadRequest& request);
+
+	/* Returns the number of bytes uploaded. */
+	std::size_t getUploadedBytes();
+
+	~UploadThread();
+private:
+	UploadThread(GLFWwindow* window);
+
+	/* Run the upload loop, uploading requests until stopped and all are uploaded. */
+	void runUploader();
+
+	/* Creates the buffer of the request and issues the copy of its data, through the staging ring if it fits. */
+	void uploadRequest(UploadRequest& request);
+
+	/* Region of the staging ring being copied from, free when the fence has signaled. */
+	struct StagingRegion {
+		std::size_t begin;
+		std::size_t end;
+		void* fence;
+	};
+
+	/* Hidden window owning the context of the thread. */
+	GLFWwindow* upload_window_;
+
+	std::thread upload_thread_;
+
+	std::deque<std::shared_ptr<UploadRequest>> requests_;
+	bool should_stop_;
+	std::mutex mutex_;
+	std::condition_variable request_condition_;
+	std::condition_variable issued_condition_;
+
+	/* Staging buffer and its mapping, only used by the upload thread. */
+	unsigned int staging_buffer_;
+	unsigned char* staging_data_;
+	std::size_t staging_head_;
+	std::deque<StagingRegion> staging_regions_;
+
+	std::size_t uploaded_bytes_;
+
+	/* Byte size of the staging ring, larger requests are uploaded directly. */
+	static constexpr std::size_t kStagingSize{ 16 * 1024 * 1024 };
+};
+
+} // namespace render
+} // namespace wanderers
+
+#endif // WANDERERS_RENDER_UPLOAD_THREAD_H_
@@ -18,6 +18,9 @@ namespace wanderers {
 namespace simulation {
 namespace generator {
 
+/* Seeds the random generator of the calling thread, the same seed generates the same objects. */
+void seedRandomizer(unsigned int seed);
+
 /* Generates the solarsystem. */
 object::OrbitalSystem* generateTheSolarSystem();
 
@@ -58,6 +58,15 @@ public:
 
 	virtual void elapseTime(double seconds);
 
+	/*
+	 * Sets the state to the one at the simulated time in seconds, and the previous step to the one the given seconds before.
+	 * The state only depends on the time, so it is the same however many steps it was reached in.
+	 */
+	virtual void setTime(double time, double seconds);
+
+	/* Sets the state used for rendering to the fraction alpha of the way from the previous step to the last one. */
+	virtual void interpolate(float alpha);
+
 protected:
 	glm::vec3 position_;
 
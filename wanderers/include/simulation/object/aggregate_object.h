@@ -38,6 +38,12 @@ public:
 	/* Elapse time for all contained objects. */
 	virtual void elapseTime(double seconds);
 
+	/* Set the time of all contained objects. */
+	virtual void setTime(double time, double seconds);
+
+	/* Interpolate all contained objects. */
+	virtual void interpolate(float alpha);
+
 private:
 	std::vector<std::pair<Object*, glm::vec3>> objects_;
 };
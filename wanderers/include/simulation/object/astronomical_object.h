@@ -49,6 +49,9 @@ public:
 	void setRotationalAngle(float rotational_angle);
 	float getRotationalAngle();
 
+	/* Returns the rotational angle between the last two steps that is rendered. */
+	float getInterpolatedRotationalAngle();
+
 	void setAngularVelocity(float angular_velocity);
 	float getAngularVelocity();
 
@@ -62,8 +65,22 @@ public:
 
 	virtual glm::mat4 getMatrix();
 
+	/* Advance the simulation by setting the time the seconds after the last one. */
 	virtual void elapseTime(double seconds);
 
+	/* Set the rotation at the time, and the time of the physical object. */
+	virtual void setTime(double time, double seconds);
+
+	/* Interpolate the rotation and the physical object. */
+	virtual void interpolate(float alpha);
+
+protected:
+	/* Returns the angle in degrees the fraction alpha of the shortest way from the previous angle to the current. */
+	static float interpolateAngle(float previous_angle, float current_angle, float alpha);
+
+	/* Simulated time in seconds of the last step. */
+	double time_;
+
 private:
 	/* Object that represents the physical representation of the astronomical object. */
 	AggregateObject* physical_object_;
@@ -72,12 +89,21 @@ private:
 	common::Orientation rotational_orientation_;
 
 	float rotational_angle_;
+	/* Rotational angle of the step before, and the angle between the two that is rendered. */
+	float previous_rotational_angle_;
+	float interpolated_rotational_angle_;
 	float angular_velocity_;
+	/* Rotational angle in degrees at simulated time zero, the angle at a time is derived from it. */
+	double rotational_epoch_;
+
+	/* Returns the rotational angle in degrees at the simulated time. */
+	float rotationalAngleAt(double time);
 
 	AstronomicalObject* parent_;
 };
 
-static const AstronomicalObject kAbstractAstronomicalObject{ kDefaultObject, new AggregateObject{kDefaultAggregate} };
+/* Astronomical object without a physical representation, defined once in astronomical_object.cpp. */
+extern const AstronomicalObject kAbstractAstronomicalObject;
 
 } // namespace object
 } // namespace simulation
@@ -0,0 +1,84 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Class to evaluate the body matrices of an orbital system together.        *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_SIMULATION_OBJECT_BODY_TRANSFORMS_H_
+#define WANDERERS_SIMULATION_OBJECT_BODY_TRANSFORMS_H_
+
+/* External Includes */
+#include "glm/glm.hpp"
+
+/* STL Includes */
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace wanderers {
+namespace simulation {
+namespace object {
+
+class AstronomicalObject;
+class Orbit;
+
+/*
+ * Class evaluating the matrix of each body of an orbital system, the matrix of its orbit times its own matrix.
+ * The orbit matrix is a rotation and a translation along the ellipse, sin and cos of the orbital angle away,
+ *   and by Rodrigues' formula the rotation of the body is a constant plus cos and sin of its angle times constants.
+ * The constants are found once when built and kept in one array per element (SoA), so each matrix
+ *   is a few dozen multiply-adds from the two angles. Four bodies are evaluated at a time with SSE.
+ * Each matrix is affine and kept as its three rows, the columns of a glm::mat3x4.
+ * NOTE: Build again if an orbit, the rotational axis or the placement of a body changes.
+ *   Falls back to evaluating one body at a time when SSE2 is not available.
+ */
+class BodyTransforms {
+public:
+	BodyTransforms();
+
+	/* Finds the constants of the bodies in the orbits. */
+	void build(const std::vector<std::pair<AstronomicalObject*, Orbit*>>& orbits);
+
+	/* Evaluates the matrices of the bodies at their interpolated orbital and rotational angles. */
+	void evaluate(const std::vector<std::pair<AstronomicalObject*, Orbit*>>& orbits);
+
+	std::size_t getCount();
+
+	/* Returns the rows of the matrix of each body, in the order of the orbits. */
+	const glm::mat3x4* getMatrices();
+
+	/* Returns the rows of an affine matrix as the matrix. */
+	static glm::mat4 toMatrix(const glm::mat3x4& rows);
+
+private:
+	/* Arrays of the constants and angles, each holding a value per body. */
+	enum Array {
+		/* Matrix of the body is kRotationAligned + cos(angle) kRotationCos + sin(angle) kRotationSin, as 3x4 rows. */
+		kRotationAligned = 0,
+		kRotationCos = 12,
+		kRotationSin = 24,
+		/* Translation of the orbit is sin(angle) kOrbitSin + cos(angle) kOrbitCos - kOrbitFocus. */
+		kOrbitSin = 36,
+		kOrbitCos = 39,
+		kOrbitFocus = 42,
+		/* Interpolated angles in degrees. */
+		kOrbitalAngle = 45,
+		kRotationalAngle = 46,
+		kArrayCount = 47
+	};
+
+	float* getArray(int array);
+
+	std::size_t count_;
+	/* Bodies rounded up to a group of four, the length of each array. */
+	std::size_t stride_;
+	std::vector<float> arrays_;
+	std::vector<glm::mat3x4> matrices_;
+};
+
+} // namespace object
+} // namespace simulation
+} // namespace wanderers
+
+#endif // WANDERERS_SIMULATION_OBJECT_BODY_TRANSFORMS_H_
@@ -17,7 +17,6 @@
 
 /* STL Includes */
 #include <mutex>
-#include <functional>
 
 namespace wanderers {
 namespace simulation {
@@ -76,7 +75,12 @@ public:
 
 	void focus();
 
-	void withMutext(std::function<void(void)> func);
+	/* Returns the center of the focus in world space. */
+	glm::vec3 getFocusPosition();
+
+	/* Disable camera from being changed by other threads, so the camera can be used with std::lock_guard. */
+	virtual void lock();
+	virtual void unlock();
 
 protected:
 	/* Updates the camera mode and camera focus. */
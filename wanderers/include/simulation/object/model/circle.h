@@ -36,17 +36,8 @@ protected:
 	std::vector<glm::vec3>* generateCircle(int num_of_points);
 };
 
-/*
- * getCircle:
- * - Construct a Circle singleton if not constructed.
- */
-static Circle* getCircle() {
-	static Circle* circle; 
-	if (!circle) {
-		circle = new Circle{};
-	}
-	return circle;
-}
+/* Returns the shared Circle. */
+MeshHandle getCircle();
 
 } // namespace model
 } // namespace object
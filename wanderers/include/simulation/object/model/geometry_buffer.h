@@ -0,0 +1,127 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * This class stores vertex and index buffers described by vertex layouts.   *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_SIMULATION_OBJECT_MODEL_GEOMETRY_BUFFER_H_
+#define WANDERERS_SIMULATION_OBJECT_MODEL_GEOMETRY_BUFFER_H_
+
+/* STL Includes */
+#include <cstddef>
+#include <vector>
+
+namespace wanderers {
+namespace simulation {
+namespace object {
+namespace model {
+
+/* Attribute locations shared by the shaders. */
+static const unsigned int kPositionLocation{ 0 };
+static const unsigned int kNormalLocation{ 1 };
+static const unsigned int kColorLocation{ 2 };
+
+/* Format of a vertex attribute as stored in the buffer. */
+enum class AttributeFormat {
+	Float2,
+	Float3,
+	Float4,
+	/* Four 16 bit floats. */
+	HalfFloat4,
+	/* Two and four signed shorts normalized to [-1, 1]. */
+	Short2,
+	Short4,
+	/* Four unsigned bytes normalized to [0, 1], used for colors. */
+	UnsignedByte4,
+	/* Signed 10, 10, 10 and 2 bits packed in 32 bits and normalized to [-1, 1], used for normals. */
+	Int2101010
+};
+
+/* Attribute of a vertex, read from the offset of each vertex. */
+struct VertexAttribute {
+	unsigned int location;
+	AttributeFormat format;
+	std::size_t offset;
+};
+
+/*
+ * Class describing the attributes of the vertices in a buffer.
+ * Attributes are interleaved in the order they are added.
+ */
+class VertexLayout {
+public:
+	VertexLayout();
+
+	/* Adds an attribute after the previous ones. */
+	VertexLayout& add(unsigned int location, AttributeFormat format);
+
+	const std::vector<VertexAttribute>& getAttributes() const;
+
+	/* Returns the byte size of a vertex. */
+	std::size_t getStride() const;
+
+	/* Returns the byte size of an attribute of the format. */
+	static std::size_t formatSize(AttributeFormat format);
+
+private:
+	std::vector<VertexAttribute> attributes_;
+	std::size_t stride_;
+};
+
+/*
+ * Class for the buffers of a geometry and the vertex array object binding them.
+ * Vertex counts, index counts and byte sizes are kept apart, the drawn element count is
+ *   the index count if indexed and the vertex count otherwise.
+ * NOTE: Has to be constructed, used and deleted on the thread owning the context.
+ */
+class GeometryBuffer {
+public:
+	/* The primitive type is the one drawn by default, such as GL_TRIANGLES. */
+	GeometryBuffer(unsigned int primitive_type);
+
+	/* Uploads vertex_count vertices of the layout as a new buffer. Returns 0 if successful. */
+	int addVertexBuffer(const VertexLayout& layout, const void* data, std::size_t vertex_count);
+	/* Adds a buffer of vertex_count vertices of the layout that is already uploaded, taking ownership of it. Returns 0 if successful. */
+	int addVertexBuffer(const VertexLayout& layout, unsigned int VBO, std::size_t vertex_count);
+
+	/* Uploads the indices, after which the geometry is drawn indexed. */
+	void setIndices(const std::vector<unsigned int>& indices);
+
+	std::size_t getVertexCount();
+	std::size_t getIndexCount();
+	/* Returns the number of vertices or indices drawn. */
+	std::size_t getElementCount();
+	/* Returns the byte size of all buffers. */
+	std::size_t getByteSize();
+
+	unsigned int getPrimitiveType();
+
+	void bind();
+	void unbind();
+
+	/* Draws the geometry with its primitive type, or the given one. Expects the geometry to be bound. */
+	void draw();
+	void draw(unsigned int primitive_type);
+
+	~GeometryBuffer();
+private:
+	unsigned int primitive_type_;
+
+	/* Vertex array object, storing the various buffers. */
+	unsigned int VAO_;
+	std::vector<unsigned int> vertex_VBOs_;
+	/* Element buffer object, storing indices. 0 if not indexed. */
+	unsigned int index_EBO_;
+
+	std::size_t vertex_count_;
+	std::size_t index_count_;
+	std::size_t byte_size_;
+};
+
+} // namespace model
+} // namespace object
+} // namespace simulation
+} // namespace wanderers
+
+#endif // WANDERERS_SIMULATION_OBJECT_MODEL_GEOMETRY_BUFFER_H_
@@ -34,25 +34,22 @@ public:
 
 	Icosahedron(std::vector<glm::vec3>* vertices);
 
+	/* Without normals the mesh uses the position vertex format. */
+	Icosahedron(std::vector<glm::vec3>* vertices, std::vector<glm::vec3>* normals);
+
 protected:
 	/* Generates the Icosahedron. */
-	std::vector<glm::vec3>* generateIcosahedron();
+	static std::vector<glm::vec3>* generateIcosahedron();
 
 	/* Increases the number of triangles 4^n times. */
-	std::vector<glm::vec3>* subDivide(std::vector<glm::vec3>* vertices, int level);
+	static std::vector<glm::vec3>* subDivide(std::vector<glm::vec3>* vertices, int level);
 };
 
-/*
- * getIcosahedron:
- * - Construct Icosahedron singleton if not constructed.
- */
-static Icosahedron* getIcosahedron() {
-	static Icosahedron* icosahedron; 
-	if (!icosahedron) {
-		icosahedron = new Icosahedron{ 3 };
-	}
-	return icosahedron;
-}
+/* Returns the shared Icosahedron subdivided 3 times. */
+MeshHandle getIcosahedron();
+
+/* Returns the shared Icosahedron subdivided once, used as patches refined by tessellation. */
+MeshHandle getCoarseIcosahedron();
 
 } // namespace model
 } // namespace object
@@ -11,7 +11,14 @@
 /* External Includes */
 #include "glm/glm.hpp"
 
+/* Internal Includes */
+#include "simulation/object/model/geometry_buffer.h"
+#include "render/upload_thread.h"
+
 /* STL Includes */
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace wanderers {
@@ -21,14 +28,37 @@ namespace model {
 
 /*
  * Base class for representation of geometric shapes used in rendering.
+ * The buffers are uploaded when the mesh is first bound, so meshes can be generated on any thread.
+ * If the upload thread is started, the upload can be requested ahead from any thread, and the mesh
+ *   is uploaded when the render thread finds the request done.
  */
 class Mesh {
 public:
+	/* Format of the vertices uploaded to the GPU. */
+	enum class VertexFormat {
+		/* Float positions and normals, 24 bytes. */
+		Float,
+		/* Float positions and 10:10:10:2 normals, 16 bytes. */
+		PackedNormal,
+		/* Half float positions and 10:10:10:2 normals, 12 bytes. Only for positions of about unit length. */
+		HalfPosition,
+		/* Float positions only, 12 bytes. The shader uses the position as normal, as for a sphere around origo. */
+		Position,
+		/* Octahedral encoded directions of the positions, 4 bytes. All positions have the length of the position scale. */
+		Direction,
+		/* Octahedral encoded directions and the lengths relative the position scale, 8 bytes. */
+		DirectionDistance
+	};
+
+	/* Meshes that are not triangles have no normals and use the Position format. */
 	Mesh(std::vector<glm::vec3>* vertices, unsigned int mesh_type);
 
+	/* Mesh with already generated normals. */
+	Mesh(std::vector<glm::vec3>* vertices, std::vector<glm::vec3>* normals, unsigned int mesh_type);
+
 	/* Returns vertices as vectors. */
 	std::vector<glm::vec3>* getVertices();
-	/* Returns normals as vectors. */
+	/* Returns normals as vectors. nullptr if the mesh has no normals. */
 	std::vector<glm::vec3>* getNormals();
 
 	/* Returns vertices as individual float values. */
@@ -36,14 +66,53 @@ public:
 	/* Returns normals as individual float values. */
 	float* normalsData();
 
+	/* Returns the number of vertices. */
+	std::size_t count();
 	/* Returns the byte size of the vertices. NOTE: normals have same size as vertices for the moment. */
-	int size();
+	std::size_t byteSize();
+
+	/* Returns the primitive type the mesh is drawn as. */
+	unsigned int getMeshType();
+
+	/* Returns an id unique to the mesh, small enough to be part of a sort key. */
+	unsigned int getMeshId();
+
+	/* Sets the format the vertices are uploaded in, has to be set before the mesh is first bound. */
+	void setVertexFormat(VertexFormat vertex_format);
+	VertexFormat getVertexFormat();
+
+	/* Returns the length the encoded directions are scaled by, the longest position. 1 for other formats. */
+	float getPositionScale();
+
+	/* Encodes a unit vector as a point in [-1, 1]^2 of the octahedron unfolded onto a square. */
+	static glm::vec2 octahedralEncode(glm::vec3 direction);
+
+	/* Returns the memory used by the vertices and normals in bytes. GPU memory is 0 until the mesh is uploaded. */
+	std::size_t getCpuBytes();
+	std::size_t getGpuBytes();
+
+	/* 
+	 * Packs the vertices on the calling thread and queues them on the upload thread. Can be called from any thread.
+	 * Does nothing without an upload thread, the mesh is then uploaded when first bound.
+	 */
+	void requestUpload();
+	/* Returns true if an upload is requested and not done. */
+	bool isUploading();
 
-	/* Binds the buffers for rendering. */
+	/* Uploads the buffers if they are not uploaded, waiting for a requested upload. Has to be called from the thread owning the context. */
+	void upload();
+	/* Returns true if the buffers are uploaded, finishing a requested upload that is done. Has to be called from the thread owning the context. */
+	bool isUploaded();
+
+	/* Binds the buffers for rendering, uploading them the first time. */
 	void bind();
 	/* Unbinds the buffers. */
 	void unbind();
 
+	/* Draws the bound mesh with its primitive type, or the given one. */
+	void draw();
+	void draw(unsigned int primitive_type);
+
 	~Mesh();
 private:
 	/* Generates the normals. */
@@ -52,19 +121,39 @@ private:
 	/* Smooths the normals. */
 	std::vector<glm::vec3>* smoothNormals(std::vector<glm::vec3>* vertices, std::vector<glm::vec3>* normals);
 
-	/* Vertex array object, storing the various buffers. */
-	unsigned int VAO_;
-	/* Vertex buffer object, storing vertices. */
-	unsigned int vertex_VBO_;
-	/* Vertex buffer object, storing normals. */
-	unsigned int normal_VBO_;
+	unsigned int mesh_type_;
+
+	const unsigned int mesh_id_;
+
+	VertexFormat vertex_format_;
+	float position_scale_;
 
 	std::vector<glm::vec3>* vertices_;
 	std::vector<glm::vec3>* normals_;
 
+	/* Buffers of the vertices in the vertex format, generated when first bound. */
+	GeometryBuffer* geometry_buffer_;
+
+	/* If the buffers have been generated. */
+	std::atomic<bool> uploaded_;
+
+	/* Upload requested on the upload thread, nullptr if not requested. */
+	std::shared_ptr<render::UploadRequest> upload_request_;
+	/* Guards the request and the generation of the buffers, as uploads can be requested on any thread. */
+	std::mutex upload_mutex_;
+
+	/* Returns the layout of the vertex format. */
+	VertexLayout makeLayout();
+	/* Returns the vertices in the vertex format, interleaved with the normals. */
+	std::vector<unsigned char> packVertices(const VertexLayout& layout);
+
+	/* Generates the buffers, from the requested upload if there is one. Expects the upload mutex to be held. */
 	void generateBuffers();
 };
 
+/* Reference counted handle to a mesh shared by objects, see MeshRegistry. */
+typedef std::shared_ptr<Mesh> MeshHandle;
+
 } // namespace model
 } // namespace object
 } // namespace simulation
@@ -0,0 +1,65 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * This class keeps track of the meshes shared by the objects.               *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_SIMULATION_OBJECT_MODEL_MESH_REGISTRY_H_
+#define WANDERERS_SIMULATION_OBJECT_MODEL_MESH_REGISTRY_H_
+
+/* Internal Includes */
+#include "simulation/object/model/mesh.h"
+
+/* STL Includes */
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace wanderers {
+namespace simulation {
+namespace object {
+namespace model {
+
+/*
+ * Class for sharing meshes by name, so each mesh is generated and uploaded once for the whole program.
+ * The registry only holds weak references, a mesh is deleted when the last handle to it is released.
+ */
+class MeshRegistry {
+public:
+	/* Returns the mesh registered with the name, creating it if no handle to it is alive. */
+	MeshHandle get(const std::string& name, std::function<Mesh*(void)> create);
+
+	/* Registers a mesh only used by its owner, so it is part of the memory report. A number is added to the name to keep it unique. */
+	MeshHandle add(const std::string& name, Mesh* mesh);
+
+	/* Returns the total memory of the alive meshes in bytes. */
+	std::size_t getCpuBytes();
+	std::size_t getGpuBytes();
+
+	/* Writes the handle count and memory of each alive mesh and the totals. */
+	void report(std::ostream& out);
+
+	/* Getter for the mesh registry singleton. */
+	static MeshRegistry* getMeshRegistry();
+
+private:
+	MeshRegistry();
+
+	std::map<std::string, std::weak_ptr<Mesh>> meshes_;
+
+	/* Number of meshes added under each name. */
+	std::map<std::string, int> added_count_;
+
+	std::mutex registry_mutex_;
+};
+
+} // namespace model
+} // namespace object
+} // namespace simulation
+} // namespace wanderers
+
+#endif // WANDERERS_SIMULATION_OBJECT_MODEL_MESH_REGISTRY_H_
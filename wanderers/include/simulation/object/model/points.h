@@ -23,13 +23,17 @@ namespace object {
 namespace model {
 
 /*
- * Class to generate an icosahedron shape and store it's vertices and normals.
- * It also takes cares of various buffers used when rendering.
+ * Class to store points, such as stars.
+ * The points are uploaded as octahedral encoded directions, decoded by the star shader.
  */
 class Points : public Mesh {
 public:
 	Points(std::vector<glm::vec3>* points);
 
+private:
+	/* Relative difference in length below which the points are seen as having the same length. */
+	static constexpr float kUnitLengthTolerance{ 0.0001f };
+
 };
 
 } // namespace model
@@ -28,22 +28,32 @@ namespace model {
  */
 class Surface : public Icosahedron {
 public:
+	/* Vertices and smooth normals of a surface, one of each per triangle corner. */
+	struct Geometry {
+		std::vector<glm::vec3>* vertices;
+		std::vector<glm::vec3>* normals;
+	};
+
 	Surface();
 
-	Surface(int sub_division_level, float roughness);
+	Surface(int sub_division_level, float roughness, unsigned int seed = 0);
+
+	/* Creates the surface from generated or cached geometry, taking ownership of it. */
+	Surface(Geometry geometry);
+
+	/* Returns the noise offset for the seed. NOTE: the terrain shader uses the same offset. */
+	static glm::vec3 seedOffset(unsigned int seed);
+
+	/* Generates the geometry of the Surface. Does not use the context, so it can be called from any thread. */
+	static Geometry generateGeometry(int sub_division_level, float roughness, unsigned int seed);
 
-protected:
-	/* Generates the Surface. */
-	std::vector<glm::vec3>* generateSurface(std::vector<glm::vec3>* vertices, float roughness);
+private:
+	/* Displaces the unit sphere points by the terrain noise, spread over the thread pool. */
+	static void displace(std::vector<glm::vec3>& points, float roughness, unsigned int seed);
 };
 
-static Surface* getDefaultSurface() {
-	static Surface* surface;
-	if (!surface) {
-		surface = new Surface{ 3, 0.5 };
-	}
-	return surface;
-}
+/* Returns the shared Surface with default roughness. */
+MeshHandle getDefaultSurface();
 
 } // namespace model
 } // namespace object
@@ -0,0 +1,84 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * This class caches generated surfaces in memory and on disk.               *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef WANDERERS_SIMULATION_OBJECT_MODEL_SURFACE_CACHE_H_
+#define WANDERERS_SIMULATION_OBJECT_MODEL_SURFACE_CACHE_H_
+
+/* Internal Includes */
+#include "simulation/object/model/mesh_registry.h"
+#include "simulation/object/model/surface.h"
+
+/* STL Includes */
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+
+namespace wanderers {
+namespace simulation {
+namespace object {
+namespace model {
+
+/*
+ * Class to cache surfaces keyed by seed, sub division level and roughness.
+ * Surfaces are kept in memory, and their geometry is written to the cache directory so
+ *   later runs read it instead of generating it.
+ * Surfaces not in memory are read or generated by a task on the thread pool, so requesting one
+ *   never blocks the render thread.
+ * The surfaces are registered in the mesh registry, and their upload is requested when loaded.
+ */
+class SurfaceCache {
+public:
+	/* Returns the surface if it is in memory, otherwise starts loading it from disk or generating it and returns null. */
+	Surface* requestSurface(unsigned int seed, int sub_division_level, float roughness);
+
+	/* Directory the geometry is written to, created if it does not exist. An empty directory disables the disk cache. */
+	void setCacheDirectory(std::string cache_directory);
+	std::string getCacheDirectory();
+
+	/* Returns the number of surfaces in memory. */
+	std::size_t size();
+
+	/* Getter for the surface cache singleton. */
+	static SurfaceCache* getSurfaceCache();
+
+private:
+	/* Seed, sub division level and bits of the roughness. */
+	typedef std::tuple<unsigned int, int, std::uint32_t> Key;
+
+	SurfaceCache();
+
+	static Key makeKey(unsigned int seed, int sub_division_level, float roughness);
+
+	/* Reads the geometry from the cache directory, or generates it and writes it, and creates the surface. */
+	static Surface* loadSurface(const std::string& cache_directory, const Key& key);
+
+	static std::string cachePath(const std::string& cache_directory, const Key& key);
+
+	/* Reads the geometry from the cache directory. Returns 0 if successful. */
+	static int read(const std::string& cache_directory, const Key& key, Surface::Geometry& geometry);
+
+	/* Writes the geometry to the cache directory. Returns 0 if successful. */
+	static int write(const std::string& cache_directory, const Key& key, const Surface::Geometry& geometry);
+
+	std::map<Key, MeshHandle> surfaces_;
+	/* Surfaces being loaded on the thread pool. */
+	std::set<Key> loading_;
+
+	std::string cache_directory_;
+
+	std::mutex cache_mutex_;
+};
+
+} // namespace model
+} // namespace object
+} // namespace simulation
+} // namespace wanderers
+
+#endif // WANDERERS_SIMULATION_OBJECT_MODEL_SURFACE_CACHE_H_
@@ -25,11 +25,11 @@ namespace object {
  */
 class Object : public AbstractObject {
 public:
-	Object(model::Mesh* model = model::getIcosahedron());
+	Object(model::MeshHandle model = model::getIcosahedron());
 
-	Object(AbstractObject abstract_object, model::Mesh* model = model::getIcosahedron());
+	Object(AbstractObject abstract_object, model::MeshHandle model = model::getIcosahedron());
 
-	void setModel(model::Mesh* model);
+	void setModel(model::MeshHandle model);
 	model::Mesh* const getModel() const;
 
 	/* Binds/undbinds the model for rendering. */
@@ -37,7 +37,7 @@ public:
 	void unbind();
 
 private:
-	model::Mesh* model_;
+	model::MeshHandle model_;
 };
 
 } // namespace object
@@ -10,7 +10,6 @@
 
 /* Internal Includes */
 #include "simulation/object/astronomical_object.h"
-#include "simulation/object/model/circle.h"
 
 namespace wanderers {
 namespace simulation {
@@ -19,6 +18,9 @@ namespace object {
 /*
  * This class represents an orbit of an astronimical object.
  * The object the orbitor orbits is irrelevant.
+ * The position follows Kepler's equation, M = E - e sin(E). The mean anomaly M grows linearly
+ *   with time and the eccentric anomaly E is solved from it, so the position after any time is
+ *   found in one evaluation and an orbit can be advanced in steps of any length.
  */
 class Orbit : public AstronomicalObject {
 public:	
@@ -46,6 +48,9 @@ public:
 	void setOrbitalAngle(float orbital_angle);
 	float getOrbitalAngle();
 
+	/* Returns the orbital angle between the last two steps that is rendered. */
+	float getInterpolatedOrbitalAngle();
+
 	void setOrbitalAxis(glm::vec3 orbital_axis);
 	glm::vec3 getOrbitalAxis() const;
 
@@ -55,30 +60,48 @@ public:
 	void setOrbitalSide(glm::vec3 orbital_side);
 	glm::vec3 getOrbitalSide() const;
 
-	/* Returns the matrix describing the object in it's current place in orbit. */
+	/* Returns the rotation of the plane of the orbit. */
+	glm::mat3 getOrbitalRotation();
+
+	/* Returns the matrix transforming the unit circle in the XZ plane into the orbit ellipse. */
 	glm::mat4 getOrbitMatrix();
 
 	virtual glm::mat4 getMatrix();
 
-	/* Advance the simulation. */
+	/* Advance the simulation by setting the time the seconds after the last one. */
 	virtual void elapseTime(double seconds);
 
+	/* Set the position in the orbit at the time. */
+	virtual void setTime(double time, double seconds);
+
+	/* Interpolate the position in the orbit. */
+	virtual void interpolate(float alpha);
+
 private:
 	float major_axis_;
 	float minor_axis_;
 
 	/* Current position in the orbit as an angle in degrees. */
 	float angular_velocity_;
+	/* Eccentric anomaly in degrees, solved from the mean anomaly. */
 	float orbital_angle_;
+	/* Mean anomaly in degrees at simulated time zero, it increases by the angular velocity each second. */
+	double mean_anomaly_epoch_;
+	/* Orbital angle of the step before, and the angle between the two that is rendered. */
+	float previous_orbital_angle_;
+	float interpolated_orbital_angle_;
+
+	/* Returns the eccentricity of the ellipse, 0 for a circle. */
+	float getEccentricity();
+	/* Sets the mean anomaly at time zero so the orbital angle is the current one. */
+	void updateMeanAnomaly();
+	/* Returns the orbital angle in degrees at the simulated time, solved from the mean anomaly. */
+	float orbitalAngleAt(double time);
 
 	/* The time in seconds it takes for the object to make one revolution. */
 	common::Orientation orbital_orientation_;
 };
 
-static AstronomicalObject getOrbitTrailObject(){
-	return AstronomicalObject{ kDefaultObject, new AggregateObject{new Object{model::getCircle()}} };
-};
-
 static Orbit getNoOrbit() {
 	return Orbit{ 0.0f, 0.0f, 0.0f };;
 }
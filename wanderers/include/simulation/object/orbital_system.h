@@ -10,6 +10,7 @@
 
 /* Internal Includes */
 #include "simulation/object/astronomical_object.h"
+#include "simulation/object/body_transforms.h"
 #include "simulation/object/orbit.h"
 
 /* STL Includes */
@@ -38,11 +39,28 @@ public:
 	void addOrbit(AstronomicalObject* object, Orbit* orbit);
 	void addOrbit(AstronomicalObject* object);
 
+	/*
+	 * Returns the rows of the matrix of each object in orbit in the space of the system, in the order of the orbits.
+	 * Evaluated when interpolated, and when first asked for after orbits are added.
+	 */
+	const glm::mat3x4* getBodyMatrices();
+
+	/* Returns the radius of a sphere around the center containing all orbits and the objects in them, in the space of the system. */
+	float getBoundingRadius();
+
 	/* Advance the simulation. */
 	void elapseTime(double seconds);
 
+	/* Set the time of all orbits and the objects in them. */
+	void setTime(double time, double seconds);
+
+	/* Interpolate all orbits and the objects in them, and evaluate their matrices. */
+	void interpolate(float alpha);
+
 private:
 	std::vector<std::pair<AstronomicalObject*, Orbit*>> orbits_;
+
+	BodyTransforms body_transforms_;
 };
 
 } // namespace simulation
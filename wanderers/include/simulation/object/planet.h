@@ -19,20 +19,35 @@ namespace simulation {
 namespace object {
 
 /*
- * This class represents a planet with surface color.
+ * This class represents a planet with surface color and terrain.
+ * The terrain is generated from the terrain seed and roughness when rendered.
  * The planet is seen as an astronomical object.
  */
 class Planet : public AstronomicalObject {
 public:
+	static constexpr float kDefaultRoughness{ 0.5f };
+
 	Planet(float radius, glm::vec3 surface_color);
+	/* The terrain seed defaults to the object id, giving each planet its own terrain. */
 	Planet(AstronomicalObject astronomical_object, glm::vec3 surface_color);
+	Planet(AstronomicalObject astronomical_object, glm::vec3 surface_color, float roughness, unsigned int terrain_seed);
 
 	void setColor(glm::vec3 color);
 	/* Get the surface color of the planet. */
 	glm::vec3 getColor();
 
+	/* How much the terrain displaces the surface, as a fraction of the radius. */
+	void setRoughness(float roughness);
+	float getRoughness();
+
+	void setTerrainSeed(unsigned int terrain_seed);
+	unsigned int getTerrainSeed();
+
 private:
 	glm::vec3 surface_color_;
+
+	float roughness_;
+	unsigned int terrain_seed_;
 };
 
 } // namespace simulation
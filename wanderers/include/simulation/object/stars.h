@@ -30,6 +30,9 @@ class Stars : public AstronomicalObject {
 public:
 	Stars(float temperature, float size, float distance, model::Points* points);
 
+	/* Seeds the random generator of the calling thread, the same seed generates the same stars. */
+	static void seedRandomizer(unsigned int seed);
+
 	/* Generate a random direction in space. */
 	static glm::vec3 generateRandomDirection();
 
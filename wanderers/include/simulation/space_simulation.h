@@ -14,19 +14,39 @@
 
 #include "render/camera.h"
 
+#include "common/task_graph.h"
+
 /* STL Includes */
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
 #include <vector>
 
 namespace wanderers {
 namespace simulation {
 
+/* Constructs a catalog of the solars and planets in the orbital system and the systems orbiting in it. */
+void constructCatalog(std::vector<object::AstronomicalObject*>& catalog, object::OrbitalSystem* system);
+
 /*
  * This class simulates solar systems and stars.
+ * The simulation advances in fixed steps, so the state only depends on the number of steps and
+ *   not on the frame rate, and is rendered interpolated between the last two steps.
+ * Each frame is advanced by a task graph, the solar systems are advanced in parallel chunks
+ *   and the graph can run while the previous frame is submitted to the GPU.
+ * The home system is generated when constructed, the other systems and the stars are generated
+ *   by jobs on the thread pool and added to the simulation a few at a time by streamGenerated.
  */
 class SpaceSimulation {
 public:
 	SpaceSimulation(object::CameraObject* camera_object);
 
+	/* Generates the same universe for the same seed. */
+	SpaceSimulation(object::CameraObject* camera_object, unsigned int seed);
+
 	~SpaceSimulation();
 
 	/* Add solar system to the simulation. */
@@ -35,13 +55,55 @@ public:
 	/* Add group of stars to the simulation. */
 	void addStars(object::Stars* stars);
 
+	/*
+	 * Adds the objects generated since the last call, uploading their meshes until the budget in bytes is used.
+	 * At least one object is added if any is generated and not still uploading on the upload thread.
+	 * Call from the thread owning the context.
+	 */
+	void streamGenerated(std::size_t upload_budget = kFrameUploadBudget);
+
+	/* Waits for all objects to be generated and adds them. */
+	void finishGeneration();
+
+	/* Returns true when all objects are generated and added to the simulation. */
+	bool isGenerated();
+
 	std::vector<object::OrbitalSystem*> getSolarSystems();
 
 	std::vector<object::Stars*> getGroupOfStars();
 
-	/* Advance the simulation. */
+	/* Advance the simulation by the fixed steps that fit in the passed real time, and interpolate the rest. */
 	void elapseTime(double seconds);
 
+	/*
+	 * Starts advancing the simulation like elapseTime on the thread pool, returns at once.
+	 * NOTE: Do not read or change the simulation until finishElapseTime has returned.
+	 */
+	void startElapseTime(double seconds);
+	/* Waits for the simulation to be advanced, helping with the remaining work. */
+	void finishElapseTime();
+
+	/* Writes the times of the last advance and the tasks on its critical path. */
+	void reportFrame(std::ostream& out);
+
+	/* Set the real seconds of a step. */
+	void setTimeStep(double time_step);
+	double getTimeStep();
+
+	/* Set the most steps taken in one call to elapseTime, the time of further steps is dropped. */
+	void setMaxSubsteps(int max_substeps);
+	int getMaxSubsteps();
+
+	/* Returns the number of steps taken and the simulated seconds they added up to. */
+	unsigned long long getStepCount();
+	double getSimulatedTime();
+
+	/* Returns the fraction of a step the rendered state is interpolated past the previous step. */
+	float getInterpolation();
+
+	/* Returns the number of solar system updates in the last call to elapseTime. */
+	unsigned int getSystemUpdates();
+
 	/* Pause/resume the simulation. */
 	void pause();
 	void unpause();
@@ -59,7 +121,52 @@ public:
 	unsigned int cycleCameraFocusId();
 
 private:
+	/* An object generated by a job, either a system or a group of stars. */
+	struct GeneratedObject {
+		object::OrbitalSystem* system;
+		object::Stars* stars;
+		/* Number of the job in the order submitted. */
+		std::size_t order{ 0 };
+	};
+
+	/* A job generating an object, seeding the random generators of the worker running it first. */
+	struct GenerationJob {
+		unsigned int seed;
+		std::function<GeneratedObject(void)> generate;
+	};
+
+	/* Submits waiting jobs to the thread pool, while there is room for their objects. */
+	void submitGeneration();
+
+	/* Adds generated objects until the budget is used, or an object is still uploading unless waiting for uploads. */
+	void addGenerated(std::size_t upload_budget, bool wait);
+
+	/*
+	 * Advances the solar system by the passed number of steps from the simulated time, updating it when it is due.
+	 * Returns true if it was updated.
+	 */
+	bool stepSystem(std::size_t index, int steps, double seconds, double time);
+
+	/* Sets how often each solar system is updated from how large it is seen from the camera. */
+	void scheduleSystems();
+
+	/*
+	 * How often a solar system is updated and how many steps behind it is.
+	 * Orbits and rotations are set from the simulated time, so a system is brought up to date in one update,
+	 *   to the same state as if it had been updated every step.
+	 */
+	struct SystemSchedule {
+		/* Radius of the system in world space. */
+		float radius;
+		/* Steps between updates, 1 updates it every step. */
+		unsigned int interval;
+		/* Steps since the last update. */
+		unsigned int steps_behind;
+	};
+
 	std::vector<object::OrbitalSystem*> solar_systems_;
+	/* Schedule of each solar system, in the same order. */
+	std::vector<SystemSchedule> system_schedules_;
 	std::vector<object::Stars*> group_of_stars_;
 
 	object::CameraObject* camera_object_;
@@ -71,7 +178,53 @@ private:
 
 	double simulation_speed_;
 
+	double time_step_;
+	int max_substeps_;
+	/* Real seconds passed that are not yet simulated, less than a step after elapseTime. */
+	double accumulated_time_;
+	/* Simulated seconds, the sum of the seconds of each step in order so it does not depend on the frames. */
+	double simulated_time_;
+	float interpolation_;
+	/* Graph advancing the simulation, kept until the next advance for the report. */
+	common::TaskGraph frame_graph_;
+	/* Read by the controller for reports. */
+	std::atomic<unsigned int> system_updates_;
+	std::atomic<unsigned long long> step_count_;
+
 	unsigned int camera_focus_id_;
+
+	/* The catalog is read by the controller while generated systems are added. */
+	std::mutex catalog_mutex_;
+
+	/* Jobs not yet submitted, objects generated and not yet added in the order of their jobs, and the number of jobs running. */
+	std::deque<GenerationJob> waiting_jobs_;
+	std::deque<GeneratedObject> generated_;
+	std::size_t running_jobs_;
+	/* Jobs submitted and objects added so far, the next object added is of the job numbered by the objects added. */
+	std::size_t submitted_jobs_;
+	std::size_t added_jobs_;
+	std::mutex generated_mutex_;
+	std::condition_variable generated_condition_;
+
+	/* Jobs running or generated objects not added before more jobs are submitted, which bounds the memory held by generated objects. */
+	static constexpr std::size_t kMaxGenerated{ 8 };
+
+	/* Default step, at the rate of the fastest common displays so a frame rarely shows the same step twice. */
+	static constexpr double kDefaultTimeStep{ 1.0 / 120.0 };
+	/* Default most steps per call, a frame of a fifteenth of a second is simulated in full. */
+	static constexpr int kDefaultMaxSubsteps{ 8 };
+
+	/* Angle in radians a solar system covers from the camera above which it is updated every step. */
+	static constexpr float kFullDetailAngle{ 0.02f };
+	/* Most steps between updates of a solar system. */
+	static constexpr unsigned int kMaxUpdateInterval{ 64 };
+	/* Factor the interval grows by when the solar system is behind the camera. */
+	static constexpr unsigned int kOffscreenIntervalFactor{ 4 };
+	/* Solar systems advanced by each task, enough work per task to be worth running on a worker. */
+	static constexpr std::size_t kSystemsPerTask{ 4 };
+
+	/* Bytes uploaded to the GPU per frame by default. */
+	static constexpr std::size_t kFrameUploadBudget{ 4 * 1024 * 1024 };
 };
 
 } // namespace simulation
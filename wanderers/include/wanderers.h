@@ -12,19 +12,79 @@
 #include "glfw/glfw3.h"
 
 /* Internal Includes */
+#include "control/flythrough.h"
 #include "render/space_renderer.h"
+#include "render/frame_buffer.h"
+#include "render/frame_capture.h"
+#include "render/frame_writer.h"
 #include "simulation/space_simulation.h"
 
+/* STL Includes */
+#include <string>
+
 namespace wanderers {
 
+/* Options for how the program is run. */
+struct RunOptions {
+	/* Render without a window into a framebuffer and write the frames to disk. */
+	bool offscreen{ false };
+	/* Context creation API used offscreen, GLFW_EGL_CONTEXT_API or GLFW_OSMESA_CONTEXT_API. */
+	int context_api{ GLFW_EGL_CONTEXT_API };
+
+	int width{ 1920 };
+	int height{ 1080 };
+	int samples{ 16 };
+
+	/* Number of frames rendered offscreen. */
+	int frame_count{ 600 };
+	/* Simulated seconds per offscreen frame. */
+	double time_step{ 1.0 / 60.0 };
+
+	/* Seconds of a simulation step, and the most steps per frame. 0 keeps the defaults of the simulation. */
+	double simulation_step{ 0.0 };
+	int max_substeps{ 0 };
+
+	/* Generate the planet terrain on the CPU instead of tessellating it on the GPU. */
+	bool cpu_terrain{ false };
+
+	/* Capture frames on screen from the start, toggled with C. */
+	bool capture{ false };
+
+	/* Measure the input latency from the start, toggled with L. The latencies are printed at exit. */
+	bool measure_latency{ false };
+
+	std::string output_directory{ "frames" };
+	render::FrameWriter::FrameFormat frame_format{ render::FrameWriter::FrameFormat::Ppm };
+
+	/* Fly the camera along a scripted path without vsync and report the frame times, offscreen if also set. */
+	bool flythrough{ false };
+	/* Script of the path, the default path if empty. */
+	std::string script{};
+	/* File the frame times are written to as JSON, not written if empty. */
+	std::string report{};
+
+	/* Seed of the generated universe, 0 seeds it from the time. The flythrough uses a fixed seed unless set. */
+	unsigned int seed{ 0 };
+};
+
+/* Parse the run options from the command line arguments. */
+RunOptions parseOptions(int argc, char** args);
+
 /* Setup window for rendering. */
-static GLFWwindow* setupWindow();
+static GLFWwindow* setupWindow(const RunOptions& options);
 
 /* Enter the simulations render loop. */
 static void renderLoop(simulation::SpaceSimulation* simulation, render::SpaceRenderer* renderer);
 
+/* Render a fixed number of frames with a fixed time step as fast as possible and write them to disk. */
+static void offscreenLoop(simulation::SpaceSimulation* simulation, render::SpaceRenderer* renderer, const RunOptions& options);
+
+/* Fly the camera along the path as fast as possible, with a fixed time step, and report the time of the frames. */
+static void flythroughLoop(simulation::SpaceSimulation* simulation, render::SpaceRenderer* renderer, render::Camera* camera,
+                           control::Flythrough* flythrough, const RunOptions& options);
+
 /* Start running the Wanderers program. */
-void run();
+void run(const RunOptions& options);
 
 } // namespace wanderers
 
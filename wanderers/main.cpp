@@ -13,7 +13,7 @@
 /* Main function, entry point for execution. */
 int main(int argc, char** args) {
 	// Run the Wanderers program.
-	wanderers::run();
+	wanderers::run(wanderers::parseOptions(argc, args));
 
 	return 0;
 }
\ No newline at end of file
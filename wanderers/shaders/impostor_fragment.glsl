@@ -0,0 +1,14 @@
+#version 460 core
+out vec4 frag_color;
+
+uniform sampler2D atlas;
+
+in vec2 texture_coordinate;
+
+void main(){
+    vec4 color = texture(atlas, texture_coordinate);
+    // The tile is cleared to transparent, only the rendered object is drawn.
+    if (color.a < 0.5f)
+        discard;
+    frag_color = vec4(color.rgb, 1.0f);
+}
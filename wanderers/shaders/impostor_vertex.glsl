@@ -0,0 +1,27 @@
+#version 460 core
+struct ImpostorInstance {
+    vec4 center_half_size;
+    vec4 right;
+    vec4 up;
+    vec4 tile_rect;
+};
+
+layout (std430, binding = 0) readonly buffer Impostors {
+    ImpostorInstance impostors[];
+};
+
+uniform mat4 VP;
+
+out vec2 texture_coordinate;
+
+void main(){
+    ImpostorInstance impostor = impostors[gl_InstanceID];
+
+    // Corners of the quad as a triangle strip, from -1 to 1.
+    vec2 corner = vec2(gl_VertexID & 1, (gl_VertexID >> 1) & 1) * 2.0f - 1.0f;
+    vec3 position = impostor.center_half_size.xyz 
+                  + impostor.center_half_size.w * (corner.x * impostor.right.xyz + corner.y * impostor.up.xyz);
+
+    gl_Position = VP * vec4(position, 1.0f);
+    texture_coordinate = impostor.tile_rect.xy + (0.5f * corner + 0.5f) * impostor.tile_rect.zw;
+}
@@ -0,0 +1,8 @@
+#version 460 core
+out vec4 frag_color;
+
+in vec3 color_frag;
+
+void main(){
+    frag_color = vec4(color_frag, 1.0f);
+}
@@ -0,0 +1,27 @@
+#version 460 core
+struct OrbitInstance {
+    mat4 orbit_matrix;
+    vec3 color;
+    uint segments;
+};
+
+layout (std430, binding = 0) readonly buffer Orbits {
+    OrbitInstance orbits[];
+};
+
+uniform mat4 VP;
+
+out vec3 color_frag;
+
+const float PI = 3.14159265359f;
+
+void main(){
+    OrbitInstance orbit = orbits[gl_InstanceID];
+
+    // Vertices past the orbit's own segments collapse onto its last vertex.
+    uint vertex = min(uint(gl_VertexID), orbit.segments);
+    float angle = 2.0f * PI * float(vertex) / float(orbit.segments);
+
+    gl_Position = VP * orbit.orbit_matrix * vec4(sin(angle), 0.0f, cos(angle), 1.0f);
+    color_frag = orbit.color;
+}
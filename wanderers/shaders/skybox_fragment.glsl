@@ -0,0 +1,10 @@
+#version 460 core
+out vec4 frag_color;
+
+uniform samplerCube sky;
+
+in vec3 direction;
+
+void main(){
+    frag_color = vec4(texture(sky, direction).rgb, 1.0f);
+}
@@ -0,0 +1,14 @@
+#version 460 core
+
+// Maps points on the far plane to directions, without the translation of the view.
+uniform mat4 inverse_view_projection;
+
+out vec3 direction;
+
+void main(){
+    // Full-screen triangle generated from the vertex id.
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0f - 1.0f;
+    vec4 world_position = inverse_view_projection * vec4(position, 1.0f, 1.0f);
+    direction = world_position.xyz / world_position.w;
+    gl_Position = vec4(position, 1.0f, 1.0f);
+}
@@ -0,0 +1,32 @@
+#version 460 core
+layout (location = 0) in vec4 encoded_position;
+
+uniform mat4 MVP;
+uniform mat4 model;
+
+// Length of the longest position, and if the distance is encoded or all positions have that length.
+uniform float position_scale;
+uniform bool has_distance;
+
+out vec3 normal_frag;
+out vec3 position_frag;
+out vec3 model_position;
+
+// Unfolds the point of the square onto the octahedron and normalizes it.
+vec3 octahedralDecode(vec2 encoded){
+    vec3 direction = vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-direction.z, 0.0f);
+    direction.x += direction.x >= 0.0f ? -fold : fold;
+    direction.y += direction.y >= 0.0f ? -fold : fold;
+    return normalize(direction);
+}
+
+void main(){
+    vec3 direction = octahedralDecode(encoded_position.xy);
+    vec3 position = direction * position_scale * (has_distance ? encoded_position.z : 1.0f);
+
+    gl_Position = MVP * vec4(position, 1.0f);
+    position_frag = vec3(model * vec4(position, 1.0f));
+    normal_frag = mat3(transpose(inverse(model))) * direction;
+    model_position = position;
+}
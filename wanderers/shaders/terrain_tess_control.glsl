@@ -0,0 +1,33 @@
+#version 460 core
+layout (vertices = 3) out;
+
+in vec3 position_control[];
+out vec3 position_evaluation[];
+
+uniform mat4 model;
+uniform vec3 camera_position;
+// Pixels per unit of length at unit distance from the camera.
+uniform float pixel_scale;
+
+const float kPixelsPerSegment = 8.0f;
+const float kMaxTessLevel = 64.0f;
+
+// Only depends on the edge itself, so patches sharing an edge agree and leave no cracks.
+float edgeLevel(vec3 start, vec3 end){
+    vec3 world_start = vec3(model * vec4(start, 1.0f));
+    vec3 world_end = vec3(model * vec4(end, 1.0f));
+    float distance_to_edge = max(distance(camera_position, 0.5f * (world_start + world_end)), 0.0001f);
+    float pixels = pixel_scale * distance(world_start, world_end) / distance_to_edge;
+    return clamp(pixels / kPixelsPerSegment, 1.0f, kMaxTessLevel);
+}
+
+void main(){
+    position_evaluation[gl_InvocationID] = position_control[gl_InvocationID];
+
+    if (gl_InvocationID == 0) {
+        gl_TessLevelOuter[0] = edgeLevel(position_control[1], position_control[2]);
+        gl_TessLevelOuter[1] = edgeLevel(position_control[2], position_control[0]);
+        gl_TessLevelOuter[2] = edgeLevel(position_control[0], position_control[1]);
+        gl_TessLevelInner[0] = max(gl_TessLevelOuter[0], max(gl_TessLevelOuter[1], gl_TessLevelOuter[2]));
+    }
+}
@@ -0,0 +1,114 @@
+#version 460 core
+layout (triangles, fractional_odd_spacing) in;
+
+in vec3 position_evaluation[];
+
+uniform mat4 VP;
+uniform mat4 model;
+uniform vec3 terrain_offset;
+uniform float roughness;
+
+out vec3 normal_frag;
+out vec3 position_frag;
+out vec3 model_position;
+
+// Classic Perlin noise, the same algorithm as glm::perlin so the terrain matches the CPU surface.
+vec4 mod289(vec4 x){ return x - floor(x * (1.0f / 289.0f)) * 289.0f; }
+vec3 mod289(vec3 x){ return x - floor(x * (1.0f / 289.0f)) * 289.0f; }
+vec4 permute(vec4 x){ return mod289(((x * 34.0f) + 1.0f) * x); }
+vec4 taylorInvSqrt(vec4 r){ return 1.79284291400159f - 0.85373472095314f * r; }
+vec3 fade(vec3 t){ return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
+
+float perlin(vec3 P){
+    vec3 Pi0 = mod289(floor(P));
+    vec3 Pi1 = mod289(floor(P) + 1.0f);
+    vec3 Pf0 = fract(P);
+    vec3 Pf1 = Pf0 - 1.0f;
+    vec4 ix = vec4(Pi0.x, Pi1.x, Pi0.x, Pi1.x);
+    vec4 iy = vec4(Pi0.yy, Pi1.yy);
+    vec4 iz0 = vec4(Pi0.z);
+    vec4 iz1 = vec4(Pi1.z);
+
+    vec4 ixy = permute(permute(ix) + iy);
+    vec4 ixy0 = permute(ixy + iz0);
+    vec4 ixy1 = permute(ixy + iz1);
+
+    vec4 gx0 = ixy0 * (1.0f / 7.0f);
+    vec4 gy0 = fract(floor(gx0) * (1.0f / 7.0f)) - 0.5f;
+    gx0 = fract(gx0);
+    vec4 gz0 = vec4(0.5f) - abs(gx0) - abs(gy0);
+    vec4 sz0 = step(gz0, vec4(0.0f));
+    gx0 -= sz0 * (step(0.0f, gx0) - 0.5f);
+    gy0 -= sz0 * (step(0.0f, gy0) - 0.5f);
+
+    vec4 gx1 = ixy1 * (1.0f / 7.0f);
+    vec4 gy1 = fract(floor(gx1) * (1.0f / 7.0f)) - 0.5f;
+    gx1 = fract(gx1);
+    vec4 gz1 = vec4(0.5f) - abs(gx1) - abs(gy1);
+    vec4 sz1 = step(gz1, vec4(0.0f));
+    gx1 -= sz1 * (step(0.0f, gx1) - 0.5f);
+    gy1 -= sz1 * (step(0.0f, gy1) - 0.5f);
+
+    vec3 g000 = vec3(gx0.x, gy0.x, gz0.x);
+    vec3 g100 = vec3(gx0.y, gy0.y, gz0.y);
+    vec3 g010 = vec3(gx0.z, gy0.z, gz0.z);
+    vec3 g110 = vec3(gx0.w, gy0.w, gz0.w);
+    vec3 g001 = vec3(gx1.x, gy1.x, gz1.x);
+    vec3 g101 = vec3(gx1.y, gy1.y, gz1.y);
+    vec3 g011 = vec3(gx1.z, gy1.z, gz1.z);
+    vec3 g111 = vec3(gx1.w, gy1.w, gz1.w);
+
+    vec4 norm0 = taylorInvSqrt(vec4(dot(g000, g000), dot(g010, g010), dot(g100, g100), dot(g110, g110)));
+    g000 *= norm0.x;
+    g010 *= norm0.y;
+    g100 *= norm0.z;
+    g110 *= norm0.w;
+    vec4 norm1 = taylorInvSqrt(vec4(dot(g001, g001), dot(g011, g011), dot(g101, g101), dot(g111, g111)));
+    g001 *= norm1.x;
+    g011 *= norm1.y;
+    g101 *= norm1.z;
+    g111 *= norm1.w;
+
+    float n000 = dot(g000, Pf0);
+    float n100 = dot(g100, vec3(Pf1.x, Pf0.yz));
+    float n010 = dot(g010, vec3(Pf0.x, Pf1.y, Pf0.z));
+    float n110 = dot(g110, vec3(Pf1.xy, Pf0.z));
+    float n001 = dot(g001, vec3(Pf0.xy, Pf1.z));
+    float n101 = dot(g101, vec3(Pf1.x, Pf0.y, Pf1.z));
+    float n011 = dot(g011, vec3(Pf0.x, Pf1.yz));
+    float n111 = dot(g111, Pf1);
+
+    vec3 fade_xyz = fade(Pf0);
+    vec4 n_z = mix(vec4(n000, n100, n010, n110), vec4(n001, n101, n011, n111), fade_xyz.z);
+    vec2 n_yz = mix(n_z.xy, n_z.zw, fade_xyz.y);
+    float n_xyz = mix(n_yz.x, n_yz.y, fade_xyz.x);
+    return 2.2f * n_xyz;
+}
+
+// Same octaves as Surface::displace.
+vec3 displace(vec3 vec){
+    float displacement = 0.5f * perlin(0.2f * vec + terrain_offset) + 0.3f * perlin(vec + terrain_offset)
+                       + 0.15f * perlin(2.0f * vec + terrain_offset) + 0.05f * perlin(4.0f * vec + terrain_offset);
+    displacement = (displacement + 1.0f) / 2.0f;
+    return vec * (-displacement * roughness + 1.0f);
+}
+
+void main(){
+    vec3 sphere = normalize(gl_TessCoord.x * position_evaluation[0]
+                          + gl_TessCoord.y * position_evaluation[1]
+                          + gl_TessCoord.z * position_evaluation[2]);
+    vec3 position = displace(sphere);
+
+    // Normal from the displaced surface a small step along two tangents.
+    vec3 tangent = normalize(cross(sphere, abs(sphere.y) < 0.99f ? vec3(0.0f, 1.0f, 0.0f) : vec3(1.0f, 0.0f, 0.0f)));
+    vec3 bitangent = cross(sphere, tangent);
+    const float step_size = 0.001f;
+    vec3 normal = normalize(cross(displace(normalize(sphere + step_size * tangent)) - position,
+                                  displace(normalize(sphere + step_size * bitangent)) - position));
+    normal = dot(normal, sphere) < 0.0f ? -normal : normal;
+
+    gl_Position = VP * model * vec4(position, 1.0f);
+    position_frag = vec3(model * vec4(position, 1.0f));
+    normal_frag = mat3(transpose(inverse(model))) * normal;
+    model_position = position;
+}
@@ -0,0 +1,8 @@
+#version 460 core
+layout (location = 0) in vec3 position;
+
+out vec3 position_control;
+
+void main(){
+    position_control = position;
+}
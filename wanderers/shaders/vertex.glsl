@@ -10,8 +10,11 @@ out vec3 position_frag;
 out vec3 model_position;
 
 void main(){
+    // Meshes without normals are spheres around origo, the normal is the direction of the position.
+    vec3 vertex_normal = normal == vec3(0.0f) ? position : normal;
+
     gl_Position = MVP * vec4(position, 1.0f);
     position_frag = vec3(model * vec4(position, 1.0f));
-    normal_frag = mat3(transpose(inverse(model))) * normal;
+    normal_frag = mat3(transpose(inverse(model))) * vertex_normal;
     model_position = position;
 }
\ No newline at end of file
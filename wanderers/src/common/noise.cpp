@@ -0,0 +1,170 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of functions for evaluating noise over many points.        *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "common/noise.h"
+
+/* External Includes */
+#include "glm/glm.hpp"
+#include "glm/gtc/noise.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WANDERERS_NOISE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace wanderers {
+namespace common {
+
+#ifdef WANDERERS_NOISE_SSE2
+
+namespace {
+
+/* Four lane versions of the helper functions of glm::perlin. */
+
+__m128 floor4(__m128 x) {
+	// Truncate and step down for negative values, the noise coordinates are well within the int range.
+	__m128 truncated{ _mm_cvtepi32_ps(_mm_cvttps_epi32(x)) };
+	return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, x), _mm_set1_ps(1.0f)));
+}
+
+__m128 fract4(__m128 x) {
+	return _mm_sub_ps(x, floor4(x));
+}
+
+__m128 abs4(__m128 x) {
+	return _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+}
+
+/* Returns 1 where x >= edge, otherwise 0. */
+__m128 step4(__m128 edge, __m128 x) {
+	return _mm_and_ps(_mm_cmpge_ps(x, edge), _mm_set1_ps(1.0f));
+}
+
+__m128 mix4(__m128 x, __m128 y, __m128 a) {
+	return _mm_add_ps(_mm_mul_ps(x, _mm_sub_ps(_mm_set1_ps(1.0f), a)), _mm_mul_ps(y, a));
+}
+
+__m128 mod289(__m128 x) {
+	return _mm_sub_ps(x, _mm_mul_ps(floor4(_mm_mul_ps(x, _mm_set1_ps(1.0f / 289.0f))), _mm_set1_ps(289.0f)));
+}
+
+__m128 permute(__m128 x) {
+	return mod289(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(34.0f)), _mm_set1_ps(1.0f)), x));
+}
+
+__m128 taylorInvSqrt(__m128 r) {
+	return _mm_sub_ps(_mm_set1_ps(1.79284291400159f), _mm_mul_ps(_mm_set1_ps(0.85373472095314f), r));
+}
+
+__m128 fade(__m128 t) {
+	__m128 polynomial{ _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))), _mm_set1_ps(10.0f)) };
+	return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), polynomial);
+}
+
+/*
+ * gradientDot:
+ * - Calculate the gradient of the corner from its hash.
+ * - Normalize the gradient.
+ * - Return the dot product with the offset from the corner.
+ */
+__m128 gradientDot(__m128 hash, __m128 dx, __m128 dy, __m128 dz) {
+	const __m128 half{ _mm_set1_ps(0.5f) };
+	const __m128 zero{ _mm_setzero_ps() };
+
+	__m128 gx{ _mm_mul_ps(hash, _mm_set1_ps(1.0f / 7.0f)) };
+	__m128 gy{ _mm_sub_ps(fract4(_mm_mul_ps(floor4(gx), _mm_set1_ps(1.0f / 7.0f))), half) };
+	gx = fract4(gx);
+	__m128 gz{ _mm_sub_ps(_mm_sub_ps(half, abs4(gx)), abs4(gy)) };
+	__m128 sz{ step4(gz, zero) };
+	gx = _mm_sub_ps(gx, _mm_mul_ps(sz, _mm_sub_ps(step4(zero, gx), half)));
+	gy = _mm_sub_ps(gy, _mm_mul_ps(sz, _mm_sub_ps(step4(zero, gy), half)));
+
+	__m128 norm{ taylorInvSqrt(_mm_add_ps(_mm_add_ps(_mm_mul_ps(gx, gx), _mm_mul_ps(gy, gy)), _mm_mul_ps(gz, gz))) };
+
+	return _mm_mul_ps(norm, _mm_add_ps(_mm_add_ps(_mm_mul_ps(gx, dx), _mm_mul_ps(gy, dy)), _mm_mul_ps(gz, dz)));
+}
+
+/*
+ * perlin4:
+ * - Get the integer and fractional part of the points.
+ * - Hash the eight corners of the cells.
+ * - Get the gradient dot products of the corners.
+ * - Interpolate the dot products with the faded fractional part.
+ */
+__m128 perlin4(__m128 x, __m128 y, __m128 z) {
+	const __m128 one{ _mm_set1_ps(1.0f) };
+
+	__m128 x0{ floor4(x) }, y0{ floor4(y) }, z0{ floor4(z) };
+	__m128 ix0{ mod289(x0) }, iy0{ mod289(y0) }, iz0{ mod289(z0) };
+	__m128 ix1{ mod289(_mm_add_ps(x0, one)) }, iy1{ mod289(_mm_add_ps(y0, one)) }, iz1{ mod289(_mm_add_ps(z0, one)) };
+
+	__m128 fx0{ _mm_sub_ps(x, x0) }, fy0{ _mm_sub_ps(y, y0) }, fz0{ _mm_sub_ps(z, z0) };
+	__m128 fx1{ _mm_sub_ps(fx0, one) }, fy1{ _mm_sub_ps(fy0, one) }, fz1{ _mm_sub_ps(fz0, one) };
+
+	__m128 px0{ permute(ix0) }, px1{ permute(ix1) };
+	__m128 h00{ permute(_mm_add_ps(px0, iy0)) };
+	__m128 h10{ permute(_mm_add_ps(px1, iy0)) };
+	__m128 h01{ permute(_mm_add_ps(px0, iy1)) };
+	__m128 h11{ permute(_mm_add_ps(px1, iy1)) };
+
+	__m128 n000{ gradientDot(permute(_mm_add_ps(h00, iz0)), fx0, fy0, fz0) };
+	__m128 n100{ gradientDot(permute(_mm_add_ps(h10, iz0)), fx1, fy0, fz0) };
+	__m128 n010{ gradientDot(permute(_mm_add_ps(h01, iz0)), fx0, fy1, fz0) };
+	__m128 n110{ gradientDot(permute(_mm_add_ps(h11, iz0)), fx1, fy1, fz0) };
+	__m128 n001{ gradientDot(permute(_mm_add_ps(h00, iz1)), fx0, fy0, fz1) };
+	__m128 n101{ gradientDot(permute(_mm_add_ps(h10, iz1)), fx1, fy0, fz1) };
+	__m128 n011{ gradientDot(permute(_mm_add_ps(h01, iz1)), fx0, fy1, fz1) };
+	__m128 n111{ gradientDot(permute(_mm_add_ps(h11, iz1)), fx1, fy1, fz1) };
+
+	__m128 fade_x{ fade(fx0) }, fade_y{ fade(fy0) }, fade_z{ fade(fz0) };
+	__m128 n_00{ mix4(n000, n001, fade_z) };
+	__m128 n_10{ mix4(n100, n101, fade_z) };
+	__m128 n_01{ mix4(n010, n011, fade_z) };
+	__m128 n_11{ mix4(n110, n111, fade_z) };
+	__m128 n_0{ mix4(n_00, n_01, fade_y) };
+	__m128 n_1{ mix4(n_10, n_11, fade_y) };
+
+	return _mm_mul_ps(_mm_set1_ps(2.2f), mix4(n_0, n_1, fade_x));
+}
+
+} // namespace
+
+/*
+ * perlin:
+ * - For each group of four points:
+ *   - Compute the noise of all four at once.
+ * - Compute the remaining points padded to a group of four.
+ */
+void perlin(const float* x, const float* y, const float* z, float* result, std::size_t count) {
+	std::size_t i{ 0 };
+	for (; i + 4 <= count; i += 4)
+		_mm_storeu_ps(result + i, perlin4(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i), _mm_loadu_ps(z + i)));
+
+	if (i < count) {
+		float tail_x[4]{}, tail_y[4]{}, tail_z[4]{}, tail_result[4];
+		for (std::size_t j = 0; i + j < count; j++) {
+			tail_x[j] = x[i + j];
+			tail_y[j] = y[i + j];
+			tail_z[j] = z[i + j];
+		}
+		_mm_storeu_ps(tail_result, perlin4(_mm_loadu_ps(tail_x), _mm_loadu_ps(tail_y), _mm_loadu_ps(tail_z)));
+		for (std::size_t j = 0; i + j < count; j++)
+			result[i + j] = tail_result[j];
+	}
+}
+
+#else
+
+void perlin(const float* x, const float* y, const float* z, float* result, std::size_t count) {
+	for (std::size_t i = 0; i < count; i++)
+		result[i] = glm::perlin(glm::vec3{ x[i], y[i], z[i] });
+}
+
+#endif // WANDERERS_NOISE_SSE2
+
+} // namespace common
+} // namespace wanderers
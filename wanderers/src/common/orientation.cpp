@@ -7,8 +7,15 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 #include "common/orientation.h"
 
-#include "glm/gtx/rotate_vector.hpp"
-#include "glm/gtx/vector_angle.hpp"
+#include "glm/gtx/quaternion.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WANDERERS_ORIENTATION_SSE2
+#include <emmintrin.h>
+#endif
+
+/* STL Includes */
+#include <cmath>
 
 namespace wanderers {
 namespace common {
@@ -24,26 +31,41 @@ glm::vec3 Orientation::normalize(glm::vec3 vector) {
 	return glm::normalize(vector);
 }
 
-Orientation::Orientation() : Orientation(kUp, kFront) {}
+Orientation::Orientation() : rotation_{ 1.0f, 0.0f, 0.0f, 0.0f } {}
 
-Orientation::Orientation(glm::vec3 normal, glm::vec3 tangent) 
-	: normal_{ normalize(normal) }, tangent_{ orthogonalize(tangent, normal_) }, bitangent_{ cross(normal_, tangent_) } {}
+Orientation::Orientation(glm::vec3 normal, glm::vec3 tangent) : rotation_{ 1.0f, 0.0f, 0.0f, 0.0f } {
+    setAxes(normal, tangent);
+}
+
+Orientation::Orientation(glm::quat rotation) : rotation_{ rotation } {
+    renormalize();
+}
+
+/*
+ * Orientation setAxes.
+ * - Normalize the normal and make the tangent orthogonal to it.
+ * - The columns of the rotation are the axes the right, up and front axes are rotated into.
+ */
+void Orientation::setAxes(glm::vec3 normal, glm::vec3 tangent) {
+    glm::vec3 unit_normal{ normalize(normal) };
+    glm::vec3 unit_tangent{ glm::normalize(orthogonalize(tangent, unit_normal)) };
+    rotation_ = glm::quat_cast(glm::mat3{ glm::cross(unit_normal, unit_tangent), unit_normal, unit_tangent });
+}
 
 void Orientation::transform(glm::mat4 matrix, Orientation orientation) {
-    auto apply_matrix = [&matrix](glm::vec3 axis) { return glm::normalize(glm::vec3{ matrix * glm::vec4{axis, 0.0f} }); };
-    normal_ = apply_matrix(orientation.normal_);
-    tangent_ = apply_matrix(orientation.tangent_);
-    bitangent_ = apply_matrix(orientation.bitangent_);
+    auto apply_matrix = [&matrix](glm::vec3 axis) { return glm::vec3{ matrix * glm::vec4{axis, 0.0f} }; };
+    setAxes(apply_matrix(orientation.getNormal()), apply_matrix(orientation.getTangent()));
 }
 
 glm::vec3 Orientation::translate(glm::vec3 movement) {
-    return normal_ * movement.z + tangent_ * movement.y + bitangent_ * movement.x;
+    return rotation_ * glm::vec3{ movement.x, movement.z, movement.y };
 }
 
-glm::vec3 Orientation::rotation(float angle_in_radians, glm::vec3 vector, glm::vec3 normal, glm::vec3& tangent, glm::vec3& bitangent) {
-    tangent = glm::rotate(tangent, angle_in_radians, normal);
-    bitangent = glm::rotate(bitangent, angle_in_radians, normal);
-    return glm::rotate(vector, angle_in_radians, normal);
+glm::vec3 Orientation::rotation(float angle_in_radians, glm::vec3 vector, glm::vec3 default_axis) {
+    glm::quat axis_rotation{ glm::angleAxis(angle_in_radians, rotation_ * default_axis) };
+    rotation_ = axis_rotation * rotation_;
+    renormalize();
+    return axis_rotation * vector;
 }
 
 glm::vec3 Orientation::focusRotation(glm::vec2 angles_in_radians, glm::vec3 vector) {
@@ -51,78 +73,230 @@ glm::vec3 Orientation::focusRotation(glm::vec2 angles_in_radians, glm::vec3 vect
 }
 
 glm::vec3 Orientation::normalRotation(float angle_in_radians, glm::vec3 vector) {
-    return rotation(angle_in_radians, vector, normal_, tangent_, bitangent_);
+    return rotation(angle_in_radians, vector, kUp);
 }
 
 glm::vec3 Orientation::tangentRotation(float angle_in_radians, glm::vec3 vector) {
-    return rotation(angle_in_radians, vector, tangent_, bitangent_, normal_);
+    return rotation(angle_in_radians, vector, kFront);
 }
 
 glm::vec3 Orientation::bitangentRotation(float angle_in_radians, glm::vec3 vector) {
-    return rotation(angle_in_radians, vector, bitangent_, normal_, tangent_);
+    return rotation(angle_in_radians, vector, kRight);
 }
 
 /*
  * Orientation setAxis.
  * - If axis is zero do nothing.
- * - If axis is opposite, mirror orientation.
- * - Otherwise rotate normal and tangent with the rotation from normal to axis.
+ * - If axis is close to opposite, turn the orientation half a turn around the flip axis first,
+ *   as the shortest rotation to an opposite axis is not well defined.
+ * - Rotate the orientation with the shortest rotation from the current axis to the axis.
  */
-void Orientation::setAxis(glm::vec3 axis, glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent) {
+void Orientation::setAxis(glm::vec3 axis, glm::vec3 default_axis, glm::vec3 flip_axis) {
     // Axis not zero
     if (glm::length(axis) > 0.0f) {
         glm::vec3 naxis = glm::normalize(axis);
+        glm::vec3 current_axis{ rotation_ * default_axis };
 
-        // Axis is opposite to normal
-        if (glm::all(glm::equal(normal, -naxis))) {
-            normal = -naxis;
-            bitangent = -bitangent;
+        // Axis is close to opposite to the current axis
+        if (glm::dot(current_axis, naxis) < -1.0f + kOppositeTolerance) {
+            rotation_ = glm::angleAxis(glm::pi<float>(), rotation_ * flip_axis) * rotation_;
+            current_axis = rotation_ * default_axis;
         }
-        // Axis is not same as normal
-        else if (glm::any(glm::notEqual(normal, naxis))) {
-            glm::mat4 rotation_matrix{ glm::rotation(normal, naxis) };
-            normal = naxis;
-            tangent = rotation_matrix * glm::vec4{ tangent, 0.0f };
-            bitangent = glm::cross(normal, tangent);
+        // Axis is not same as the current axis
+        if (glm::any(glm::notEqual(current_axis, naxis))) {
+            rotation_ = glm::rotation(current_axis, naxis) * rotation_;
         }
+        renormalize();
     }
 }
 
 void Orientation::setNormal(glm::vec3 normal) {
-    setAxis(normal, normal_, tangent_, bitangent_);
+    setAxis(normal, kUp, kFront);
 }
 
-glm::vec3 Orientation::getNormal() const { return normal_; }
+glm::vec3 Orientation::getNormal() const { return rotation_ * kUp; }
 
 void Orientation::setTangent(glm::vec3 tangent) {
-    setAxis(tangent, tangent_, bitangent_, normal_);
+    setAxis(tangent, kFront, kRight);
 }
 
-glm::vec3 Orientation::getTangent() const { return tangent_; }
+glm::vec3 Orientation::getTangent() const { return rotation_ * kFront; }
 
 void Orientation::setBitangent(glm::vec3 bitangent) {
-    setAxis(bitangent, bitangent_, normal_, tangent_);
+    setAxis(bitangent, kRight, kUp);
 }
 
-glm::vec3 Orientation::getBitangent() const { return bitangent_; }
+glm::vec3 Orientation::getBitangent() const { return rotation_ * kRight; }
 
 glm::mat4 Orientation::orientationMatrix() {
-    return orientationMatrix(kYOrientation);
+    return rotationMatrix(rotation_);
 }
 
 /*
  * Orientation orientationMatrix.
- * - Calculate rotation matrix based on the normal.
- * - Rotate the tangent with the calculated matrix.
- * - Calculate rotation matrix based on the rotated tangent.
- * - Combine the rotation matrices and return it.
+ * - Undo the rotation of the passed orientation and apply this rotation.
+ * - Return the matrix of the combined rotation.
  */
 glm::mat4 Orientation::orientationMatrix(Orientation from) {
-    glm::mat4 normal_matrix{ from.normal_ == -this->normal_ ? glm::rotate(glm::mat4{1.0f}, glm::radians(180.0f), from.tangent_) : glm::rotation(from.normal_, this->normal_) };
-    glm::vec3 rotated_tangent{ normal_matrix * glm::vec4{ from.tangent_, 0.0f } };
-    glm::mat4 tangent_matrix{ rotated_tangent == -this->tangent_ ? glm::rotate(glm::mat4{1.0f}, glm::radians(180.0f), this->normal_) : glm::rotation(rotated_tangent, this->tangent_) };
-    return tangent_matrix * normal_matrix;
+    return rotationMatrix(rotation_ * glm::conjugate(from.rotation_));
+}
+
+glm::quat Orientation::getRotation() const {
+    return rotation_;
+}
+
+/*
+ * Orientation renormalize.
+ * - Normalize the rotation if its squared length is further than the tolerance from one.
+ */
+void Orientation::renormalize() {
+    float length_squared{ glm::dot(rotation_, rotation_) };
+    if (std::abs(length_squared - 1.0f) > kDriftTolerance)
+        rotation_ = rotation_ * (1.0f / std::sqrt(length_squared));
+}
+
+/*
+ * rotationMatrix:
+ * - Scale the products of the components by two over the squared length,
+ *   which gives the matrix of the normalized rotation without normalizing it.
+ * - Fill in the rotation matrix from the products.
+ */
+glm::mat4 rotationMatrix(glm::quat rotation) {
+	const float s{ 2.0f / glm::dot(rotation, rotation) };
+	const float xs{ rotation.x * s }, ys{ rotation.y * s }, zs{ rotation.z * s };
+	const float wx{ rotation.w * xs }, wy{ rotation.w * ys }, wz{ rotation.w * zs };
+	const float xx{ rotation.x * xs }, xy{ rotation.x * ys }, xz{ rotation.x * zs };
+	const float yy{ rotation.y * ys }, yz{ rotation.y * zs }, zz{ rotation.z * zs };
+
+	return glm::mat4{ 1.0f - (yy + zz), xy + wz, xz - wy, 0.0f,
+	                  xy - wz, 1.0f - (xx + zz), yz + wx, 0.0f,
+	                  xz + wy, yz - wx, 1.0f - (xx + yy), 0.0f,
+	                  0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+#ifdef WANDERERS_ORIENTATION_SSE2
+
+namespace {
+
+/* Four rotations with each component in its own register. */
+struct Rotation4 {
+	__m128 w;
+	__m128 x;
+	__m128 y;
+	__m128 z;
+};
+
+/* Loads four rotations, transposing them into a register per component. */
+Rotation4 loadRotation4(const glm::quat* rotations) {
+	static_assert(sizeof(glm::quat) == 4 * sizeof(float), "Rotations are expected to be four packed floats.");
+	const float* data{ &rotations[0][0] };
+	__m128 r0{ _mm_loadu_ps(data) };
+	__m128 r1{ _mm_loadu_ps(data + 4) };
+	__m128 r2{ _mm_loadu_ps(data + 8) };
+	__m128 r3{ _mm_loadu_ps(data + 12) };
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+#ifdef GLM_FORCE_QUAT_DATA_XYZW
+	return { r3, r0, r1, r2 };
+#else
+	return { r0, r1, r2, r3 };
+#endif
 }
 
+/* Stores four rotations, transposing them back. */
+void storeRotation4(Rotation4 rotation, glm::quat* rotations) {
+	float* data{ &rotations[0][0] };
+#ifdef GLM_FORCE_QUAT_DATA_XYZW
+	__m128 r0{ rotation.x }, r1{ rotation.y }, r2{ rotation.z }, r3{ rotation.w };
+#else
+	__m128 r0{ rotation.w }, r1{ rotation.x }, r2{ rotation.y }, r3{ rotation.z };
+#endif
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	_mm_storeu_ps(data, r0);
+	_mm_storeu_ps(data + 4, r1);
+	_mm_storeu_ps(data + 8, r2);
+	_mm_storeu_ps(data + 12, r3);
+}
+
+/* Four lane version of the quaternion product. */
+Rotation4 compose4(Rotation4 a, Rotation4 b) {
+	return { _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(a.w, b.w), _mm_mul_ps(a.x, b.x)), _mm_add_ps(_mm_mul_ps(a.y, b.y), _mm_mul_ps(a.z, b.z))),
+	         _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.w, b.x), _mm_mul_ps(a.x, b.w)), _mm_sub_ps(_mm_mul_ps(a.y, b.z), _mm_mul_ps(a.z, b.y))),
+	         _mm_add_ps(_mm_sub_ps(_mm_mul_ps(a.w, b.y), _mm_mul_ps(a.x, b.z)), _mm_add_ps(_mm_mul_ps(a.y, b.w), _mm_mul_ps(a.z, b.x))),
+	         _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.w, b.z), _mm_mul_ps(a.x, b.y)), _mm_sub_ps(_mm_mul_ps(a.z, b.w), _mm_mul_ps(a.y, b.x))) };
+}
+
+/* Four lane version of rotationMatrix, storing the four matrices. */
+void rotationMatrix4(Rotation4 r, glm::mat4* matrices) {
+	const __m128 one{ _mm_set1_ps(1.0f) };
+	const __m128 length_squared{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(r.w, r.w), _mm_mul_ps(r.x, r.x)),
+	                                        _mm_add_ps(_mm_mul_ps(r.y, r.y), _mm_mul_ps(r.z, r.z))) };
+	const __m128 s{ _mm_div_ps(_mm_set1_ps(2.0f), length_squared) };
+	const __m128 xs{ _mm_mul_ps(r.x, s) }, ys{ _mm_mul_ps(r.y, s) }, zs{ _mm_mul_ps(r.z, s) };
+	const __m128 wx{ _mm_mul_ps(r.w, xs) }, wy{ _mm_mul_ps(r.w, ys) }, wz{ _mm_mul_ps(r.w, zs) };
+	const __m128 xx{ _mm_mul_ps(r.x, xs) }, xy{ _mm_mul_ps(r.x, ys) }, xz{ _mm_mul_ps(r.x, zs) };
+	const __m128 yy{ _mm_mul_ps(r.y, ys) }, yz{ _mm_mul_ps(r.y, zs) }, zz{ _mm_mul_ps(r.z, zs) };
+
+	// Rows of the lanes are the columns of the matrices once transposed.
+	__m128 columns[3][4]{
+		{ _mm_sub_ps(one, _mm_add_ps(yy, zz)), _mm_add_ps(xy, wz), _mm_sub_ps(xz, wy), _mm_setzero_ps() },
+		{ _mm_sub_ps(xy, wz), _mm_sub_ps(one, _mm_add_ps(xx, zz)), _mm_add_ps(yz, wx), _mm_setzero_ps() },
+		{ _mm_add_ps(xz, wy), _mm_sub_ps(yz, wx), _mm_sub_ps(one, _mm_add_ps(xx, yy)), _mm_setzero_ps() }
+	};
+	for (int column = 0; column < 3; column++) {
+		_MM_TRANSPOSE4_PS(columns[column][0], columns[column][1], columns[column][2], columns[column][3]);
+		for (int lane = 0; lane < 4; lane++)
+			_mm_storeu_ps(&matrices[lane][column][0], columns[column][lane]);
+	}
+	const __m128 translation_column{ _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f) };
+	for (int lane = 0; lane < 4; lane++)
+		_mm_storeu_ps(&matrices[lane][3][0], translation_column);
+}
+
+} // namespace
+
+/*
+ * composeRotations:
+ * - For each group of four pairs:
+ *   - Compose all four at once.
+ * - Compose the remaining pairs one at a time.
+ */
+void composeRotations(const glm::quat* lhs, const glm::quat* rhs, glm::quat* result, std::size_t count) {
+	std::size_t i{ 0 };
+	for (; i + 4 <= count; i += 4)
+		storeRotation4(compose4(loadRotation4(lhs + i), loadRotation4(rhs + i)), result + i);
+
+	for (; i < count; i++)
+		result[i] = lhs[i] * rhs[i];
+}
+
+/*
+ * rotationMatrices:
+ * - For each group of four rotations:
+ *   - Convert all four at once.
+ * - Convert the remaining rotations one at a time.
+ */
+void rotationMatrices(const glm::quat* rotations, glm::mat4* matrices, std::size_t count) {
+	std::size_t i{ 0 };
+	for (; i + 4 <= count; i += 4)
+		rotationMatrix4(loadRotation4(rotations + i), matrices + i);
+
+	for (; i < count; i++)
+		matrices[i] = rotationMatrix(rotations[i]);
+}
+
+#else
+
+void composeRotations(const glm::quat* lhs, const glm::quat* rhs, glm::quat* result, std::size_t count) {
+	for (std::size_t i = 0; i < count; i++)
+		result[i] = lhs[i] * rhs[i];
+}
+
+void rotationMatrices(const glm::quat* rotations, glm::mat4* matrices, std::size_t count) {
+	for (std::size_t i = 0; i < count; i++)
+		matrices[i] = rotationMatrix(rotations[i]);
+}
+
+#endif // WANDERERS_ORIENTATION_SSE2
+
 } // namespace common
 } // namespace wanderers
@@ -0,0 +1,79 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the ScratchAllocator class.                             *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "common/scratch_allocator.h"
+
+/* STL Includes */
+#include <algorithm>
+
+namespace wanderers {
+namespace common {
+
+ScratchAllocator::ScratchAllocator() : blocks_{}, block_{ 0 }, offset_{ 0 } {}
+
+/*
+ * ScratchAllocator allocate:
+ * - Align the offset in the current block.
+ * - If the memory does not fit, move to the next block that fits it, adding one if there is none.
+ * - Take the memory from the offset.
+ */
+void* ScratchAllocator::allocate(std::size_t size, std::size_t alignment) {
+	while (true) {
+		if (block_ < blocks_.size()) {
+			std::size_t aligned{ (offset_ + alignment - 1) / alignment * alignment };
+			if (aligned + size <= blocks_[block_].size) {
+				offset_ = aligned + size;
+				return blocks_[block_].data + aligned;
+			}
+			if (block_ + 1 < blocks_.size()) {
+				block_++;
+				offset_ = 0;
+				continue;
+			}
+		}
+		// Blocks are allocated with new, which aligns them for any type.
+		std::size_t block_size{ std::max(kBlockSize, size + alignment) };
+		blocks_.push_back({ new unsigned char[block_size], block_size });
+		block_ = blocks_.size() - 1;
+		offset_ = 0;
+	}
+}
+
+ScratchAllocator::Marker ScratchAllocator::getMarker() {
+	return { block_, offset_ };
+}
+
+void ScratchAllocator::rewind(Marker marker) {
+	block_ = marker.block;
+	offset_ = marker.offset;
+}
+
+std::size_t ScratchAllocator::getCapacity() {
+	std::size_t capacity{ 0 };
+	for (const Block& block : blocks_)
+		capacity += block.size;
+	return capacity;
+}
+
+ScratchAllocator* ScratchAllocator::getThreadScratch() {
+	static thread_local ScratchAllocator scratch_allocator{};
+	return &scratch_allocator;
+}
+
+ScratchAllocator::~ScratchAllocator() {
+	for (Block& block : blocks_)
+		delete[] block.data;
+}
+
+ScratchScope::ScratchScope() : marker_{ ScratchAllocator::getThreadScratch()->getMarker() } {}
+
+ScratchScope::~ScratchScope() {
+	ScratchAllocator::getThreadScratch()->rewind(marker_);
+}
+
+} // namespace common
+} // namespace wanderers
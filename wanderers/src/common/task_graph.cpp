@@ -0,0 +1,226 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the TaskGraph class.                                    *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "common/task_graph.h"
+
+/* Internal Includes */
+#include "common/scratch_allocator.h"
+#include "common/thread_pool.h"
+
+/* STL Includes */
+#include <algorithm>
+#include <iomanip>
+
+namespace wanderers {
+namespace common {
+
+/* Returns the milliseconds between the time points. */
+static double milliseconds(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+	return std::chrono::duration<double, std::milli>{ end - begin }.count();
+}
+
+TaskGraph::TaskGraph() : run_{ std::make_shared<Run>() }, finished_{}, finished_mutex_{}, is_running_{ false } {}
+
+/*
+ * TaskGraph addTask:
+ * - Add the task, depending on the passed tasks.
+ * - Add it as a dependent of each of them.
+ */
+TaskGraph::TaskId TaskGraph::addTask(const std::string& name, std::function<void(void)> function, const std::vector<TaskId>& dependencies) {
+	TaskId id{ run_->tasks.size() };
+	run_->tasks.push_back({ name, function, dependencies, {}, 0, {}, {} });
+	for (TaskId dependency : dependencies)
+		run_->tasks[dependency].dependents.push_back(id);
+	return id;
+}
+
+/*
+ * TaskGraph clear:
+ * - Wait for the graph if running.
+ * - Replace the run, helpers of the old run keep it until they are done.
+ */
+void TaskGraph::clear() {
+	wait();
+	run_ = std::make_shared<Run>();
+}
+
+/*
+ * TaskGraph start:
+ * - Set the dependencies left of each task, readying those without any.
+ * - Submit a helper per ready task, as many as there are workers.
+ */
+void TaskGraph::start() {
+	if (is_running_ || run_->tasks.empty())
+		return;
+	is_running_ = true;
+
+	std::size_t ready_count;
+	{
+		std::lock_guard<std::mutex> guard{ run_->mutex };
+		run_->ready.clear();
+		run_->done_tasks = 0;
+		for (TaskId id = 0; id < run_->tasks.size(); id++) {
+			run_->tasks[id].remaining = run_->tasks[id].dependencies.size();
+			if (run_->tasks[id].remaining == 0)
+				run_->ready.push_back(id);
+		}
+		run_->start_time = Clock::now();
+		ready_count = run_->ready.size();
+	}
+
+	ThreadPool* thread_pool{ ThreadPool::getThreadPool() };
+	std::size_t helpers{ std::min<std::size_t>(ready_count, thread_pool->getThreadCount()) };
+	std::shared_ptr<Run> run{ run_ };
+	for (std::size_t i = 0; i < helpers; i++)
+		thread_pool->submit([run]() { runTasks(run); });
+}
+
+/*
+ * TaskGraph wait:
+ * - Run ready tasks until all tasks are done, waiting while the remaining tasks run on helpers.
+ * - Keep the run for the report.
+ */
+void TaskGraph::wait() {
+	if (!is_running_)
+		return;
+
+	{
+		std::unique_lock<std::mutex> lock{ run_->mutex };
+		while (true) {
+			run_->condition.wait(lock, [this]() { return !run_->ready.empty() || run_->done_tasks == run_->tasks.size(); });
+			if (run_->ready.empty())
+				break;
+			lock.unlock();
+			runTasks(run_);
+			lock.lock();
+		}
+	}
+
+	is_running_ = false;
+	std::lock_guard<std::mutex> guard{ finished_mutex_ };
+	finished_ = run_;
+}
+
+void TaskGraph::run() {
+	start();
+	wait();
+}
+
+bool TaskGraph::isRunning() {
+	return is_running_;
+}
+
+/*
+ * TaskGraph runTasks:
+ * - While there is a ready task:
+ *   - Take it and run it in a scratch scope without holding the lock, timing it.
+ *   - Ready the dependents with no dependencies left.
+ *   - Submit helpers for the readied tasks beyond the one this thread takes next.
+ *   - Wake the waiting thread if tasks were readied or all are done.
+ */
+void TaskGraph::runTasks(std::shared_ptr<Run> run) {
+	std::unique_lock<std::mutex> lock{ run->mutex };
+	while (!run->ready.empty()) {
+		Task& task{ run->tasks[run->ready.front()] };
+		run->ready.pop_front();
+		lock.unlock();
+
+		task.start_time = Clock::now();
+		{
+			ScratchScope scratch_scope{};
+			task.function();
+		}
+		task.end_time = Clock::now();
+
+		lock.lock();
+		std::size_t readied{ 0 };
+		for (TaskId dependent : task.dependents) {
+			if (--run->tasks[dependent].remaining == 0) {
+				run->ready.push_back(dependent);
+				readied++;
+			}
+		}
+		if (++run->done_tasks == run->tasks.size())
+			run->end_time = task.end_time;
+		run->condition.notify_all();
+
+		if (readied > 1) {
+			lock.unlock();
+			ThreadPool* thread_pool{ ThreadPool::getThreadPool() };
+			std::size_t helpers{ std::min<std::size_t>(readied - 1, thread_pool->getThreadCount()) };
+			for (std::size_t i = 0; i < helpers; i++)
+				thread_pool->submit([run]() { runTasks(run); });
+			lock.lock();
+		}
+	}
+}
+
+/*
+ * TaskGraph report:
+ * - Take the last finished run, it is not changed once finished.
+ * - Write the wall time of the last run and the summed time of its tasks.
+ * - Find the critical path, the chain of dependent tasks with the longest summed time.
+ *   Tasks only depend on earlier tasks, so the longest chain ending in each task is found in order.
+ * - Write the tasks of the critical path from the first.
+ */
+void TaskGraph::report(std::ostream& out) {
+	std::shared_ptr<Run> finished;
+	{
+		std::lock_guard<std::mutex> guard{ finished_mutex_ };
+		finished = finished_;
+	}
+	if (!finished || finished->tasks.empty()) {
+		out << "No task graph run." << std::endl;
+		return;
+	}
+	const std::vector<Task>& tasks{ finished->tasks };
+
+	std::vector<double> path_time(tasks.size());
+	std::vector<TaskId> path_previous(tasks.size());
+	double task_time{ 0.0 };
+	TaskId path_end{ 0 };
+	for (TaskId id = 0; id < tasks.size(); id++) {
+		double time{ milliseconds(tasks[id].start_time, tasks[id].end_time) };
+		task_time += time;
+		path_time[id] = time;
+		path_previous[id] = id;
+		for (TaskId dependency : tasks[id].dependencies) {
+			if (path_time[dependency] + time > path_time[id]) {
+				path_time[id] = path_time[dependency] + time;
+				path_previous[id] = dependency;
+			}
+		}
+		if (path_time[id] > path_time[path_end])
+			path_end = id;
+	}
+
+	std::vector<TaskId> path{ path_end };
+	while (path_previous[path.back()] != path.back())
+		path.push_back(path_previous[path.back()]);
+	std::reverse(path.begin(), path.end());
+
+	out << std::fixed << std::setprecision(3)
+	    << "Wall " << milliseconds(finished->start_time, finished->end_time) << " ms, tasks " << task_time
+	    << " ms over " << tasks.size() << ", critical path " << path_time[path_end] << " ms:\n";
+	for (TaskId id : path) {
+		out << "  " << std::left << std::setw(16) << tasks[id].name << std::right << std::setw(10)
+		    << milliseconds(tasks[id].start_time, tasks[id].end_time) << " ms, started at "
+		    << milliseconds(finished->start_time, tasks[id].start_time) << " ms\n";
+	}
+	out << std::flush;
+}
+
+/*
+ * TaskGraph Destructor:
+ * - Wait for the graph if running.
+ */
+TaskGraph::~TaskGraph() {
+	wait();
+}
+
+} // namespace common
+} // namespace wanderers
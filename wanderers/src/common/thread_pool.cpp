@@ -0,0 +1,144 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the ThreadPool class.                                   *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "common/thread_pool.h"
+
+/* STL Includes */
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace wanderers {
+namespace common {
+
+/*
+ * ThreadPool Constructor:
+ * - Start the worker threads.
+ */
+ThreadPool::ThreadPool(unsigned int thread_count) : workers_{}, tasks_{}, should_stop_{ false } {
+	for (unsigned int i = 0; i < thread_count; i++)
+		workers_.push_back(std::thread{ &ThreadPool::runWorker, this });
+}
+
+void ThreadPool::submit(std::function<void(void)> task) {
+	{
+		std::lock_guard<std::mutex> guard{ mutex_ };
+		tasks_.push_back(task);
+	}
+	condition_.notify_one();
+}
+
+/*
+ * ThreadPool runWorker:
+ * - Until stopped and all tasks are run:
+ *   - Wait for a task.
+ *   - Run the task without holding the lock.
+ */
+void ThreadPool::runWorker() {
+	std::unique_lock<std::mutex> lock{ mutex_ };
+	while (true) {
+		condition_.wait(lock, [this]() { return should_stop_ || !tasks_.empty(); });
+		if (tasks_.empty())
+			break;
+
+		std::function<void(void)> task{ std::move(tasks_.front()) };
+		tasks_.pop_front();
+		lock.unlock();
+
+		task();
+
+		lock.lock();
+	}
+}
+
+/*
+ * ThreadPool parallelFor:
+ * - Share a batch counter between the calling thread and a helper task per worker.
+ * - Each thread takes the next batch until there are none left.
+ * - Wait until all batches are done.
+ *   Only batches that have been taken are waited for, so helpers that never got to run,
+ *   for instance because all workers are busy with nested loops, do not block the caller.
+ */
+void ThreadPool::parallelFor(std::size_t count, std::size_t batch_size, std::function<void(std::size_t, std::size_t)> function) {
+	if (count == 0)
+		return;
+	batch_size = std::max<std::size_t>(batch_size, 1);
+
+	struct Loop {
+		std::function<void(std::size_t, std::size_t)> function;
+		std::size_t count;
+		std::size_t batch_size;
+		std::size_t batch_count;
+		std::atomic<std::size_t> next_batch;
+		std::atomic<std::size_t> done_batches;
+		std::mutex mutex;
+		std::condition_variable done;
+	};
+	std::shared_ptr<Loop> loop{ std::make_shared<Loop>() };
+	loop->function = function;
+	loop->count = count;
+	loop->batch_size = batch_size;
+	loop->batch_count = (count + batch_size - 1) / batch_size;
+	loop->next_batch = 0;
+	loop->done_batches = 0;
+
+	auto run_batches{ [loop]() {
+		std::size_t batch;
+		while ((batch = loop->next_batch++) < loop->batch_count) {
+			std::size_t begin{ batch * loop->batch_size };
+			loop->function(begin, std::min(begin + loop->batch_size, loop->count));
+			if (++loop->done_batches == loop->batch_count) {
+				std::lock_guard<std::mutex> guard{ loop->mutex };
+				loop->done.notify_all();
+			}
+		}
+	} };
+
+	std::size_t helpers{ std::min<std::size_t>(workers_.size(), loop->batch_count - 1) };
+	for (std::size_t i = 0; i < helpers; i++)
+		submit(run_batches);
+
+	run_batches();
+
+	std::unique_lock<std::mutex> lock{ loop->mutex };
+	loop->done.wait(lock, [&loop]() { return loop->done_batches == loop->batch_count; });
+}
+
+unsigned int ThreadPool::getThreadCount() {
+	return static_cast<unsigned int>(workers_.size());
+}
+
+/*
+ * ThreadPool getThreadPool:
+ * - Construct the shared thread pool if not constructed.
+ */
+ThreadPool* ThreadPool::getThreadPool() {
+	static ThreadPool thread_pool{};
+	return &thread_pool;
+}
+
+unsigned int ThreadPool::defaultThreadCount() {
+	unsigned int hardware_threads{ std::thread::hardware_concurrency() };
+	return hardware_threads > 1 ? hardware_threads - 1 : 1;
+}
+
+/*
+ * ThreadPool Destructor:
+ * - Stop the workers after the queued tasks are run.
+ */
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> guard{ mutex_ };
+		should_stop_ = true;
+	}
+	condition_.notify_all();
+	for (std::thread& worker : workers_)
+		worker.join();
+}
+
+} // namespace common
+} // namespace wanderers
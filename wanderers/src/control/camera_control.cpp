@@ -15,6 +15,7 @@
 
 /* STL Includes */
 #include <algorithm>
+#include <mutex>
 
 #include <iostream>
 
@@ -27,9 +28,11 @@ CameraControl::CameraControl(GLFWwindow* window, render::Camera* camera, simulat
 void CameraControl::enactKeyTrigger(int key, double seconds) {
 	switch (key) {
 	// V: Cycle camera mode
-	case GLFW_KEY_V:
-		camera_->withMutext([this]() {camera_->cycleCameraMode(); });
+	case GLFW_KEY_V: {
+		std::lock_guard<render::Camera> guard{ *camera_ };
+		camera_->cycleCameraMode();
 		break;
+	}
 	// TAB: Cycle camera focus
 	case GLFW_KEY_TAB:
 		simulation_->cycleCameraFocusId();
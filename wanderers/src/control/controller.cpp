@@ -13,6 +13,9 @@
 #include "control/render_control.h"
 
 /* STL Includes */
+#include <algorithm>
+#include <chrono>
+#include <iterator>
 #include <thread>
 
 namespace wanderers {
@@ -24,12 +27,10 @@ namespace control {
  * - Start controller thread.
  */
 Controller::Controller(GLFWwindow* window, render::Camera* camera, simulation::SpaceSimulation* simulation, render::SpaceRenderer* renderer) : ControlInterface{ window },
-                                                             pressed_keys_{ std::size_t{kNumKeys} },
-                                                             released_keys_{ std::size_t{kNumKeys} },
-	                                                         cursor_position_{} {
+                                                             camera_{ camera }, should_stop_{ false }, input_events_{}, input_sequence_{ 1 }, cursor_position_{ 0.0f },
+                                                             pressed_keys_{}, released_keys_{}, triggered_keys_{}, frame_{ 0 } {
 
 	glfwSetInputMode(window_, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-	cursor_position_.setPosition(glm::vec2{0.0f, 0.0f});
 	glfwSetCursorPos(window_, 0.0f, 0.0f);
 
 	glfwSetScrollCallback(window_, scrollCallback);
@@ -40,21 +41,25 @@ Controller::Controller(GLFWwindow* window, render::Camera* camera, simulation::S
 	controls_.push_back(new SimulationControl{ window, simulation });
 	controls_.push_back(new RenderControl{ window, renderer });
 
-	should_stop_ = false;
-	std::thread controller_thread{&Controller::runController, this};
-	controller_thread.detach();
+	controller_thread_ = std::thread{ &Controller::runController, this };
 }
 
 /*
  * Controller Destructor:
- * - Stop thread and reset input callbacks.
+ * - Reset input callbacks.
+ * - Stop thread and wait for it to finish.
  */
 Controller::~Controller() { 
-	std::lock_guard<std::mutex> guard(controller_mutex_);
-	should_stop_ = true; 
 	glfwSetKeyCallback(window_, nullptr); 
 	glfwSetCursorPosCallback(window_, nullptr);
 	glfwSetScrollCallback(window_, nullptr);
+
+	{
+		std::lock_guard<std::mutex> guard{ frame_mutex_ };
+		should_stop_ = true;
+		frame_condition_.notify_all();
+	}
+	controller_thread_.join();
 }
 
 /*
@@ -71,89 +76,111 @@ void Controller::initController(render::Camera* camera, simulation::SpaceSimulat
  * - Destroy Controller singleton if it exists.
  */
 void Controller::deinitController() {
-	if (controller_singleton_ != nullptr)
+	if (controller_singleton_ != nullptr) {
 		delete controller_singleton_;
+		controller_singleton_ = nullptr;
+	}
 }
 
 Controller* Controller::getController() {
 	return controller_singleton_;
 }
 
-/* CursorPosition Constructor. */
-Controller::CursorPosition::CursorPosition() : position_{ 0.0f }, delta_{ 0.0f } {}
-
-/*
- * CursorPosition updatePosition:
- * - Set position and update delta.
- */
-void Controller::CursorPosition::updatePosition(glm::vec2 position) {
-	std::lock_guard<std::mutex> guard(cursor_position_mutex_);
-	delta_ += position - position_;
-
-	position_ = position;
-}
-
-void Controller::CursorPosition::setPosition(glm::vec2 position) {
-	std::lock_guard<std::mutex> guard(cursor_position_mutex_);
-	position_ = position;
-}
-
-glm::vec2 Controller::CursorPosition::getPosition() {
-	std::lock_guard<std::mutex> guard(cursor_position_mutex_);
-	return position_;
-}
-
-/*
- * CursorPosition fetchDelta:
- * - Return delta and reset variable.
- */
-glm::vec2 Controller::CursorPosition::fetchDelta() {
-	std::lock_guard<std::mutex> guard(cursor_position_mutex_);
-	glm::vec2 delta{ delta_ };
-	delta_ = glm::vec2{ 0.0f };
-	return delta;
+void Controller::notifyFrame() {
+	std::lock_guard<std::mutex> guard{ frame_mutex_ };
+	frame_++;
+	frame_condition_.notify_all();
 }
 
 /*
  * Controller runController:
  * - Until controller singleton is destroyed:
+ *   - Wait for the next frame, or for the input queue to fill up.
  *   - Handle controls.
  */
 void Controller::runController() {
 	double last_time{ glfwGetTime() };
+	long long handled_frame{ 0 };
 	while (!should_stop_) {
+		{
+			std::unique_lock<std::mutex> lock{ frame_mutex_ };
+			frame_condition_.wait_for(lock, std::chrono::milliseconds{ kFrameTimeoutMilliseconds }, [this, handled_frame]() {
+				return should_stop_ || frame_ != handled_frame || input_events_.full();
+			});
+			handled_frame = frame_;
+		}
+
 		double dt = glfwGetTime() - last_time;
 		last_time += dt;
 		handleControls(dt);
-		
-		std::this_thread::sleep_for(std::chrono::milliseconds{ 10 }); // make dynamic
 	}
 }
 
 /*
  * Controller handleControls:
- * - Enact changes in cursor position.
- * - Enact changes in key changes.
+ * - Take all input events in order:
+ *   - Keep the stamp of the oldest event of each type.
+ *   - Sum the cursor movement and scrolling.
+ *   - Trigger a key pressed if not already pressed, release a key released.
+ * - Enact changes in cursor position and scrolling.
+ * - Enact key changes.
+ * - Stamp the camera with the handled input, so the frame showing it can measure its latency.
  */
 void Controller::handleControls(double seconds) {
-	std::lock_guard<std::mutex> guard(controller_mutex_);
-	enactCursorPosition(cursor_position_.fetchDelta(), seconds);
+	glm::vec2 cursor_delta{ 0.0f };
+	glm::vec2 scroll_offset{ 0.0f };
+	triggered_keys_.clear();
+	released_keys_.clear();
+	common::InputStamp input_stamps[common::kInputTypeCount]{};
+
+	InputEvent input_event{};
+	while (input_events_.pop(input_event)) {
+		common::InputStamp& input_stamp{ input_stamps[static_cast<int>(input_event.type)] };
+		if (input_stamp.sequence == 0)
+			input_stamp = input_event.stamp;
+
+		switch (input_event.type) {
+		case common::InputType::Key:
+			if (input_event.action == GLFW_PRESS) {
+				if (pressed_keys_.insert(input_event.key).second)
+					triggered_keys_.push_back(input_event.key);
+			} else if (input_event.action == GLFW_RELEASE) {
+				pressed_keys_.erase(input_event.key);
+				released_keys_.push_back(input_event.key);
+			}
+			break;
+		case common::InputType::CursorPosition:
+			cursor_delta += input_event.value - cursor_position_;
+			cursor_position_ = input_event.value;
+			break;
+		case common::InputType::Scroll:
+			scroll_offset += input_event.value;
+			break;
+		default:
+			break;
+		}
+	}
 
-	enactScrollOffset(scroll_offset_, seconds);
-	scroll_offset_ = glm::vec2{ 0.0f };
+	enactCursorPosition(cursor_delta, seconds);
+
+	enactScrollOffset(scroll_offset, seconds);
 
 	for (int triggered_key : triggered_keys_)
 		enactKeyTrigger(triggered_key, seconds);
 
-	triggered_keys_.clear(); // might cause bugs
-
 	for (int released_key : released_keys_)
 		enactKeyRelease(released_key, seconds);
 
-	released_keys_.clear(); // might cause bugs
-
 	for (int pressed_key : pressed_keys_)
 		enactKeyPress(pressed_key, seconds);
+
+	if (std::any_of(std::begin(input_stamps), std::end(input_stamps), [](const common::InputStamp& input_stamp) { return input_stamp.sequence != 0; })) {
+		std::lock_guard<render::Camera> guard{ *camera_ };
+		for (int type = 0; type < common::kInputTypeCount; type++) {
+			if (input_stamps[type].sequence != 0)
+				camera_->setInputStamp(static_cast<common::InputType>(type), input_stamps[type]);
+		}
+	}
 }
 
 void Controller::enactKeyTrigger(int key, double seconds) {
@@ -187,45 +214,32 @@ void Controller::enactScrollOffset(glm::vec2 offset, double seconds) {
 }
 
 /*
- * Controller updateKey:
- * - If key is triggered insert to triggered keys.
- * - If key is pressed insert to pressed keys.
- * - If key is released:
- *   - Remove from pressed keys.
- *   - Insert to released keys.
+ * Controller pushInput:
+ * - Give the event the next sequence number.
+ * - Until there is room in the queue, wake the controller thread so it drains the queue.
+ *   Drop the event if the controller thread has stopped.
+ * - Push the event.
  */
-void Controller::updateKey(int key, int action) { 
-	std::lock_guard<std::mutex> guard(controller_mutex_);
-	if (action == GLFW_PRESS) {
-		if (pressed_keys_.insert(key).second)
-			triggered_keys_.insert(key);
+void Controller::pushInput(InputEvent input_event) {
+	input_event.stamp.sequence = input_sequence_++;
+	while (!input_events_.push(input_event)) {
+		if (should_stop_)
+			return;
+		frame_condition_.notify_all();
+		std::this_thread::yield();
 	}
-	else if (action == GLFW_RELEASE) {
-		pressed_keys_.erase(key);
-		released_keys_.insert(key);
-	}
-}
-
-void Controller::updateCursorPosition(double x_position, double y_position) {
-	std::lock_guard<std::mutex> guard(controller_mutex_);
-	cursor_position_.updatePosition(glm::vec2{ x_position, y_position });
-}
-
-void Controller::updateScrollOffset(double x_offset, double y_offset) {
-	std::lock_guard<std::mutex> guard(controller_mutex_);
-	scroll_offset_ = glm::vec2{ x_offset, y_offset };
 }
 
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
-	controller_singleton_->updateKey(key, action);
+	controller_singleton_->pushInput({ common::InputType::Key, { 0, glfwGetTime() }, key, action, glm::vec2{ 0.0f } });
 }
 
 static void cursorPositionCallback(GLFWwindow* window, double x_position, double y_position) {
-	controller_singleton_->updateCursorPosition(x_position, y_position);
+	controller_singleton_->pushInput({ common::InputType::CursorPosition, { 0, glfwGetTime() }, 0, 0, glm::vec2{ x_position, y_position } });
 }
 
 static void scrollCallback(GLFWwindow* window, double x_offset, double y_offset) {
-	controller_singleton_->updateScrollOffset(x_offset, y_offset);
+	controller_singleton_->pushInput({ common::InputType::Scroll, { 0, glfwGetTime() }, 0, 0, glm::vec2{ x_offset, y_offset } });
 }
 
 } // namsepace wanderers
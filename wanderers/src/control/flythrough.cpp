@@ -0,0 +1,136 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the Flythrough class.                                   *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "control/flythrough.h"
+
+/* External Includes */
+#include "glm/ext.hpp"
+#include "glm/gtx/component_wise.hpp"
+
+/* STL Includes */
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+namespace wanderers {
+namespace control {
+
+/*
+ * The default path, closing in on the home solar, following planets in each mode while the
+ * simulation speeds up, and leaving for the first neighbouring system.
+ * The catalog has the solar of the home system first, followed by its planets and moons.
+ */
+Flythrough::Flythrough() : keyframes_{
+	{  0.0,  0, CameraMode::Free,       glm::vec3{ 0.0f, 4.0f, -12.0f },   1.0 },
+	{  5.0,  1, CameraMode::Orbital,    glm::vec3{ 0.0f, 1.5f, -4.0f },   10.0 },
+	{ 10.0,  3, CameraMode::Rotational, glm::vec3{ 1.5f, 0.5f, -2.5f },  100.0 },
+	{ 15.0,  5, CameraMode::Center,     glm::vec3{ 0.0f, 6.0f, -10.0f }, 1000.0 },
+	{ 20.0,  0, CameraMode::Free,       glm::vec3{ 0.0f, 40.0f, -60.0f },  1.0 },
+	{ 25.0, 17, CameraMode::Free,       glm::vec3{ 0.0f, 200.0f, -400.0f }, 1.0 },
+	{ 30.0, 17, CameraMode::Free,       glm::vec3{ 0.0f, 4.0f, -12.0f },    1.0 } },
+	current_{ keyframes_.size() } {}
+
+/*
+ * Flythrough load:
+ * - For each line of the script that is not empty or a comment:
+ *   - Read the keyframe, failing on a malformed line.
+ * - Order the keyframes by time.
+ * - Return 0 if successful.
+ */
+int Flythrough::load(const std::string& path) {
+	std::ifstream script{ path };
+	if (!script) {
+		std::cout << "Error: Could not open flythrough script " << path << "." << std::endl;
+		return 1;
+	}
+
+	std::vector<Keyframe> keyframes{};
+	std::string line{};
+	for (int number = 1; std::getline(script, line); number++) {
+		std::istringstream fields{ line };
+		std::string first{};
+		if (!(fields >> first) || first[0] == '#')
+			continue;
+
+		Keyframe keyframe{};
+		std::string mode{};
+		fields.str(line);
+		fields.clear();
+		fields >> keyframe.time >> keyframe.focus_id >> mode >> keyframe.offset.x >> keyframe.offset.y >> keyframe.offset.z >> keyframe.speed;
+		keyframe.mode = parseMode(mode);
+		if (!fields || keyframe.mode == CameraMode::Count) {
+			std::cout << "Error: Malformed keyframe on line " << number << " of " << path << "." << std::endl;
+			return 1;
+		}
+		keyframes.push_back(keyframe);
+	}
+	if (keyframes.empty()) {
+		std::cout << "Error: No keyframes in " << path << "." << std::endl;
+		return 1;
+	}
+
+	std::stable_sort(keyframes.begin(), keyframes.end(), [](const Keyframe& a, const Keyframe& b) { return a.time < b.time; });
+	keyframes_ = keyframes;
+	current_ = keyframes_.size();
+	return 0;
+}
+
+/*
+ * Flythrough apply:
+ * - Find the last keyframe reached, the first before the path starts.
+ * - When a new keyframe is reached, change the focus and the speed of the simulation.
+ * - Interpolate the position relative the focus towards the next keyframe.
+ * - Place the camera at the position, facing the focus, and set the camera mode of the keyframe.
+ */
+void Flythrough::apply(double time, simulation::SpaceSimulation* simulation, render::Camera* camera) {
+	std::size_t index{ 0 };
+	while (index + 1 < keyframes_.size() && keyframes_[index + 1].time <= time)
+		index++;
+	const Keyframe& keyframe{ keyframes_[index] };
+
+	if (index != current_) {
+		simulation->setCameraFocusId(keyframe.focus_id);
+		simulation->setSpeed(keyframe.speed);
+		current_ = index;
+	}
+
+	glm::vec3 offset{ keyframe.offset };
+	if (index + 1 < keyframes_.size()) {
+		const Keyframe& next{ keyframes_[index + 1] };
+		const double fraction{ glm::clamp((time - keyframe.time) / (next.time - keyframe.time), 0.0, 1.0) };
+		offset = glm::mix(keyframe.offset, next.offset, static_cast<float>(fraction));
+	}
+
+	std::lock_guard<render::Camera> guard{ *camera };
+	const glm::vec3 focus_position{ camera->getFocusPosition() };
+	const glm::vec3 position{ focus_position + offset * glm::compMin(camera->getCameraFocus()->getScale()) };
+	camera->setPosition(position);
+	camera->setDirection(focus_position - position);
+	// The relative position and direction of the mode are taken from the world position and direction.
+	camera->setCameraMode(keyframe.mode);
+}
+
+double Flythrough::getDuration() {
+	return keyframes_.back().time;
+}
+
+Flythrough::CameraMode Flythrough::parseMode(const std::string& name) {
+	if (name == "free")
+		return CameraMode::Free;
+	if (name == "center")
+		return CameraMode::Center;
+	if (name == "orbital")
+		return CameraMode::Orbital;
+	if (name == "rotational")
+		return CameraMode::Rotational;
+	return CameraMode::Count;
+}
+
+} // namespace control
+} // namespace wanderers
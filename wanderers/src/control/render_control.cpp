@@ -13,6 +13,10 @@
 #include "glm/gtx/euler_angles.hpp"
 #include "glm/gtx/vector_angle.hpp"
 
+/* Internal Includes */
+#include "render/gl_state.h"
+#include "simulation/object/model/mesh_registry.h"
+
 /* STL Includes */
 #include <algorithm>
 
@@ -29,6 +33,30 @@ void RenderControl::enactKeyTrigger(int key, double seconds) {
 	case GLFW_KEY_O:
 		renderer_->setShowOrbits(!renderer_->getShowOrbits());
 		break;
+	// C: Start/stop capturing frames.
+	case GLFW_KEY_C:
+		if (renderer_->getFrameCapture() != nullptr)
+			renderer_->getFrameCapture()->setCapturing(!renderer_->getFrameCapture()->getCapturing());
+		break;
+	// B: Print the memory used by the meshes.
+	case GLFW_KEY_B:
+		simulation::object::model::MeshRegistry::getMeshRegistry()->report(std::cout);
+		break;
+	// L: Start/stop measuring the input latency, printing the latencies when stopped.
+	case GLFW_KEY_L:
+		if (renderer_->getLatencyMeter()->getEnabled()) {
+			renderer_->getLatencyMeter()->setEnabled(false);
+			renderer_->getLatencyMeter()->report(std::cout);
+			renderer_->getLatencyMeter()->reset();
+		} else {
+			renderer_->getLatencyMeter()->setEnabled(true);
+		}
+		break;
+	// G: Print the OpenGL calls made and removed by the state cache since the last print.
+	case GLFW_KEY_G:
+		render::GLState::getGLState()->report(std::cout);
+		render::GLState::getGLState()->resetCounters();
+		break;
 	}
 
 }
@@ -29,6 +29,12 @@ void SimulationControl::enactKeyTrigger(int key, double seconds) {
 	case GLFW_KEY_SPACE:
 		simulation_->isPaused() ? simulation_->unpause() : simulation_->pause();
 		break;
+	// U: Print the number of steps, the solar systems updated and the critical path in the last frame.
+	case GLFW_KEY_U:
+		std::cout << "Step " << simulation_->getStepCount() << ", updated " << simulation_->getSystemUpdates()
+		          << " solar systems in the last frame." << std::endl;
+		simulation_->reportFrame(std::cout);
+		break;
 	}
 
 }
@@ -15,17 +15,29 @@
 
 /* STL Includes */
 #include <algorithm>
-#include <mutex>
+#include <iterator>
 
 #include <iostream>
 
 namespace wanderers {
 namespace render {
 
-Camera::Camera() : CameraObject{}, CameraView{} {}
+glm::mat4 CameraState::getViewMatrix() const {
+    return glm::lookAt(position, position + direction, up);
+}
+
+glm::mat4 CameraState::getProjectionMatrix(float aspect_ratio) const {
+    return glm::perspective(glm::radians(field_of_view), aspect_ratio, near_plane, far_plane);
+}
+
+Camera::Camera() : CameraObject{}, CameraView{}, input_stamps_{} {
+    publish();
+}
 
 Camera::Camera(glm::vec3 position, glm::vec3 direction, glm::vec3 up, float field_of_view, float aspect_ratio, float near, float far) 
-              : CameraObject{position, direction, up}, CameraView{field_of_view, aspect_ratio, near, far} {}
+              : CameraObject{position, direction, up}, CameraView{field_of_view, aspect_ratio, near, far}, input_stamps_{} {
+    publish();
+}
 
 /*
  * Camera getViewMatrix:
@@ -51,16 +63,36 @@ void Camera::lock() {
     camera_view_mutex_.lock();
 }
 
+/*
+ * Camera unlock:
+ * - Publish the changes made while locked.
+ * - Unlock in reverse order.
+ */
 void Camera::unlock() {
+    publish();
     camera_view_mutex_.unlock();
     camera_object_mutex_.unlock();
 }
 
-void Camera::withMutext(std::function<void(void)> func) {
-    assert(func);
-    std::lock_guard<std::mutex> view_guard{ camera_view_mutex_ };
-    std::lock_guard<std::mutex> object_guard{ camera_object_mutex_ };
-    func();
+CameraState Camera::getState() {
+    return state_.load();
+}
+
+void Camera::setInputStamp(common::InputType input_type, common::InputStamp input_stamp) {
+    input_stamps_[static_cast<int>(input_type)] = input_stamp;
+}
+
+void Camera::publish() {
+    CameraState state{};
+    state.position = position_;
+    state.direction = getDirection();
+    state.up = getUp();
+    state.field_of_view = field_of_view_;
+    state.near_plane = near_;
+    state.far_plane = far_;
+    state.version = state_.getVersion() + 1;
+    std::copy(std::begin(input_stamps_), std::end(input_stamps_), std::begin(state.input_stamps));
+    state_.store(state);
 }
 
 bool Camera::shouldClear() {
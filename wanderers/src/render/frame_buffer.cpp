@@ -0,0 +1,103 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the FrameBuffer class.                                  *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "render/frame_buffer.h"
+
+/* External Includes */
+#include "glad/gl.h"
+
+/* STL Includes */
+#include <iostream>
+
+namespace wanderers {
+namespace render {
+
+/*
+ * FrameBuffer Constructor:
+ * - Generate the framebuffer rendered into.
+ * - If multisampled, generate a single sampled framebuffer to resolve into.
+ */
+FrameBuffer::FrameBuffer(int width, int height, int samples)
+	: width_{ width }, height_{ height }, samples_{ samples },
+	  render_FBO_{ 0 }, render_color_RBO_{ 0 }, render_depth_RBO_{ 0 },
+	  resolve_FBO_{ 0 }, resolve_color_RBO_{ 0 }, resolve_depth_RBO_{ 0 } {
+	generateBuffers(render_FBO_, render_color_RBO_, render_depth_RBO_, samples_);
+	if (samples_ > 0) {
+		generateBuffers(resolve_FBO_, resolve_color_RBO_, resolve_depth_RBO_, 0);
+	} else {
+		resolve_FBO_ = render_FBO_;
+	}
+}
+
+/*
+ * FrameBuffer generateBuffers:
+ * - Generate framebuffer and bind it.
+ * - Generate and attach color renderbuffer.
+ * - Generate and attach depth renderbuffer.
+ * - Unbind framebuffer.
+ */
+void FrameBuffer::generateBuffers(unsigned int& FBO, unsigned int& color_RBO, unsigned int& depth_RBO, int samples) {
+	glGenFramebuffers(1, &FBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
+	glGenRenderbuffers(1, &color_RBO);
+	glBindRenderbuffer(GL_RENDERBUFFER, color_RBO);
+	glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_RGBA8, width_, height_);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_RBO);
+
+	glGenRenderbuffers(1, &depth_RBO);
+	glBindRenderbuffer(GL_RENDERBUFFER, depth_RBO);
+	glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH_COMPONENT24, width_, height_);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth_RBO);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		std::cout << "Error: Framebuffer is not complete." << std::endl;
+	}
+
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void FrameBuffer::bind() { glBindFramebuffer(GL_FRAMEBUFFER, render_FBO_); }
+
+void FrameBuffer::unbind() { glBindFramebuffer(GL_FRAMEBUFFER, 0); }
+
+/*
+ * FrameBuffer resolve:
+ * - If multisampled, blit the rendered frame to the resolve framebuffer.
+ */
+void FrameBuffer::resolve() {
+	if (samples_ > 0) {
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, render_FBO_);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, resolve_FBO_);
+		glBlitFramebuffer(0, 0, width_, height_, 0, 0, width_, height_, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+}
+
+void FrameBuffer::bindRead() {
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, resolve_FBO_);
+	glReadBuffer(GL_COLOR_ATTACHMENT0);
+}
+
+int FrameBuffer::getWidth() { return width_; }
+
+int FrameBuffer::getHeight() { return height_; }
+
+FrameBuffer::~FrameBuffer() {
+	if (resolve_FBO_ != render_FBO_) {
+		glDeleteRenderbuffers(1, &resolve_color_RBO_);
+		glDeleteRenderbuffers(1, &resolve_depth_RBO_);
+		glDeleteFramebuffers(1, &resolve_FBO_);
+	}
+	glDeleteRenderbuffers(1, &render_color_RBO_);
+	glDeleteRenderbuffers(1, &render_depth_RBO_);
+	glDeleteFramebuffers(1, &render_FBO_);
+}
+
+} // namespace render
+} // namespace wanderers
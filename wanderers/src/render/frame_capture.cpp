@@ -0,0 +1,266 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the FrameCapture class.                                 *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "render/frame_capture.h"
+
+/* External Includes */
+#include "glad/gl.h"
+
+/* Internal Includes */
+#include "render/gl_state.h"
+
+/* STL Includes */
+#include <cstring>
+#include <iostream>
+
+namespace wanderers {
+namespace render {
+
+/*
+ * FrameCapture Constructor:
+ * - Start the writer thread.
+ */
+FrameCapture::FrameCapture(std::string output_directory, FrameWriter::FrameFormat frame_format, int ring_size, bool drop_when_busy)
+	: output_directory_{ output_directory }, frame_format_{ frame_format }, drop_when_busy_{ drop_when_busy },
+	  ring_(ring_size, PixelPackBuffer{ 0, nullptr, 0 }), ring_tail_{ 0 }, ring_head_{ 0 }, ring_pending_{ 0 },
+	  width_{ 0 }, height_{ 0 }, frame_number_{ 0 }, dropped_frames_{ 0 },
+	  capturing_requested_{ false }, capturing_{ false },
+	  write_queue_{}, free_frames_{}, max_queued_frames_{ 2 * static_cast<std::size_t>(ring_size) },
+	  frames_writing_{ 0 }, frame_writer_{ nullptr }, should_stop_{ false } {
+	writer_thread_ = std::thread{ &FrameCapture::runWriter, this };
+}
+
+void FrameCapture::setCapturing(bool capturing) {
+	capturing_requested_ = capturing;
+}
+
+bool FrameCapture::getCapturing() {
+	return capturing_requested_;
+}
+
+/*
+ * FrameCapture generateBuffers:
+ * - Generate a pixel pack buffer for each slot of the ring, sized for the frame.
+ * - Create the writer for the frame size.
+ */
+void FrameCapture::generateBuffers(int width, int height) {
+	width_ = width;
+	height_ = height;
+
+	for (PixelPackBuffer& buffer : ring_) {
+		glGenBuffers(1, &buffer.PBO);
+		GLState::getGLState()->bindBuffer(GL_PIXEL_PACK_BUFFER, buffer.PBO);
+		glBufferData(GL_PIXEL_PACK_BUFFER, 3 * static_cast<GLsizeiptr>(width_) * height_, nullptr, GL_STREAM_READ);
+	}
+	GLState::getGLState()->bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	frame_writer_ = new FrameWriter{ output_directory_, frame_format_, width_, height_ };
+}
+
+void FrameCapture::deleteBuffers() {
+	for (PixelPackBuffer& buffer : ring_) {
+		GLState::getGLState()->releaseBuffer(buffer.PBO);
+		glDeleteBuffers(1, &buffer.PBO);
+		buffer.PBO = 0;
+	}
+	delete frame_writer_;
+	frame_writer_ = nullptr;
+	width_ = 0;
+	height_ = 0;
+}
+
+/*
+ * FrameCapture capture:
+ * - Start or stop capturing if requested.
+ * - Pass the frames that are read back to the writer.
+ * - If capturing:
+ *   - If the ring is full, drop the frame or wait for the oldest read.
+ *   - Read the frame into the next buffer and fence it.
+ */
+void FrameCapture::capture(int width, int height) {
+	bool capturing{ capturing_requested_ };
+	if (capturing != capturing_ || (capturing && (width != width_ || height != height_))) {
+		if (capturing_) {
+			flush();
+			deleteBuffers();
+		}
+		if (capturing) {
+			generateBuffers(width, height);
+		}
+		capturing_ = capturing;
+	}
+
+	collect(false);
+
+	if (!capturing_)
+		return;
+
+	if (ring_pending_ == static_cast<int>(ring_.size())) {
+		if (drop_when_busy_) {
+			dropped_frames_++;
+			frame_number_++;
+			return;
+		}
+		collect(true);
+	}
+
+	PixelPackBuffer& buffer{ ring_.at(ring_head_) };
+	GLState::getGLState()->bindBuffer(GL_PIXEL_PACK_BUFFER, buffer.PBO);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width_, height_, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+	GLState::getGLState()->bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	buffer.frame_number = frame_number_++;
+
+	ring_head_ = (ring_head_ + 1) % ring_.size();
+	ring_pending_++;
+}
+
+/*
+ * FrameCapture collect:
+ * - From the oldest buffer of the ring, until a buffer is not read back:
+ *   - Check the fence, if wait is set wait for the oldest buffer only.
+ *   - Pass the frame to the writer.
+ */
+void FrameCapture::collect(bool wait) {
+	for (; ring_pending_ > 0; wait = false) {
+		PixelPackBuffer& buffer{ ring_.at(ring_tail_) };
+		GLsync fence{ static_cast<GLsync>(buffer.fence) };
+
+		GLenum status{ glClientWaitSync(fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? GL_TIMEOUT_IGNORED : 0) };
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+			break;
+
+		glDeleteSync(fence);
+		buffer.fence = nullptr;
+
+		if (!enqueue(buffer))
+			dropped_frames_++;
+
+		ring_tail_ = (ring_tail_ + 1) % ring_.size();
+		ring_pending_--;
+	}
+}
+
+/*
+ * FrameCapture enqueue:
+ * - Wait for room in the write queue, or drop the frame if dropping is allowed.
+ * - Map the buffer and copy the pixels into a reused frame.
+ * - Pass the frame to the writer thread, or return it for reuse and drop it if the buffer could not be mapped.
+ */
+bool FrameCapture::enqueue(PixelPackBuffer& buffer) {
+	std::unique_lock<std::mutex> lock{ writer_mutex_ };
+	if (write_queue_.size() >= max_queued_frames_) {
+		if (drop_when_busy_)
+			return false;
+		writer_condition_.wait(lock, [this]() { return write_queue_.size() < max_queued_frames_; });
+	}
+
+	Frame frame{};
+	if (!free_frames_.empty()) {
+		frame = std::move(free_frames_.back());
+		free_frames_.pop_back();
+	}
+	lock.unlock();
+
+	const std::size_t frame_size{ 3 * static_cast<std::size_t>(width_) * height_ };
+	frame.frame_number = buffer.frame_number;
+	frame.pixels.resize(frame_size);
+
+	GLState::getGLState()->bindBuffer(GL_PIXEL_PACK_BUFFER, buffer.PBO);
+	void* pixels{ glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frame_size, GL_MAP_READ_BIT) };
+	if (pixels != nullptr) {
+		std::memcpy(frame.pixels.data(), pixels, frame_size);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	GLState::getGLState()->bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	lock.lock();
+	if (pixels == nullptr) {
+		free_frames_.push_back(std::move(frame));
+		return false;
+	}
+	write_queue_.push_back(std::move(frame));
+	writer_condition_.notify_all();
+	return true;
+}
+
+/*
+ * FrameCapture runWriter:
+ * - Until stopped and all frames are written:
+ *   - Wait for a frame.
+ *   - Write the frame without holding the lock.
+ *   - Return the frame for reuse.
+ */
+void FrameCapture::runWriter() {
+	std::unique_lock<std::mutex> lock{ writer_mutex_ };
+	while (true) {
+		writer_condition_.wait(lock, [this]() { return should_stop_ || !write_queue_.empty(); });
+		if (write_queue_.empty())
+			break;
+
+		Frame frame{ std::move(write_queue_.front()) };
+		write_queue_.pop_front();
+		frames_writing_++;
+		FrameWriter* frame_writer{ frame_writer_ };
+		lock.unlock();
+
+		frame_writer->write(frame.frame_number, frame.pixels);
+
+		lock.lock();
+		free_frames_.push_back(std::move(frame));
+		frames_writing_--;
+		writer_condition_.notify_all();
+	}
+}
+
+/*
+ * FrameCapture flush:
+ * - Wait for the GPU to finish each read and collect it.
+ * - Wait for the writer to write all frames.
+ */
+void FrameCapture::flush() {
+	while (ring_pending_ > 0)
+		collect(true);
+
+	std::unique_lock<std::mutex> lock{ writer_mutex_ };
+	writer_condition_.wait(lock, [this]() { return write_queue_.empty() && frames_writing_ == 0; });
+}
+
+int FrameCapture::getCapturedFrames() {
+	return frame_number_ - dropped_frames_;
+}
+
+int FrameCapture::getDroppedFrames() {
+	return dropped_frames_;
+}
+
+/*
+ * FrameCapture Destructor:
+ * - Write the remaining frames.
+ * - Stop the writer thread.
+ * - Delete the buffers.
+ */
+FrameCapture::~FrameCapture() {
+	if (capturing_) {
+		flush();
+	}
+	{
+		std::lock_guard<std::mutex> guard{ writer_mutex_ };
+		should_stop_ = true;
+		writer_condition_.notify_all();
+	}
+	writer_thread_.join();
+
+	if (capturing_) {
+		deleteBuffers();
+	}
+}
+
+} // namespace render
+} // namespace wanderers
@@ -0,0 +1,156 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the FrameTimer class.                                   *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "render/frame_timer.h"
+
+/* External Includes */
+#include "glad/gl.h"
+#include "glfw/glfw3.h"
+
+/* STL Includes */
+#include <algorithm>
+#include <iomanip>
+
+namespace wanderers {
+namespace render {
+
+/* Names of the measured times in the report. */
+static const char* const kTimeNames[2]{ "CPU", "GPU" };
+
+/* Returns the time in milliseconds at the fraction of the sorted times. */
+static double percentile(const std::vector<double>& times, double fraction) {
+	return 1000.0 * times[static_cast<std::size_t>(fraction * (times.size() - 1) + 0.5)];
+}
+
+FrameTimer::FrameTimer() : free_queries_(kQueryCount), pending_queries_{}, begin_time_{ 0.0 }, cpu_times_{}, gpu_times_{} {
+	glGenQueries(static_cast<GLsizei>(kQueryCount), free_queries_.data());
+}
+
+/*
+ * FrameTimer beginFrame:
+ * - If all queries are in flight, wait for the oldest.
+ * - Start the query of the frame and the real time.
+ */
+void FrameTimer::beginFrame() {
+	if (free_queries_.empty())
+		collect(true);
+
+	pending_queries_.push_back(free_queries_.back());
+	free_queries_.pop_back();
+	glBeginQuery(GL_TIME_ELAPSED, pending_queries_.back());
+	begin_time_ = glfwGetTime();
+}
+
+/*
+ * FrameTimer endFrame:
+ * - Stop the query of the frame and record the real time.
+ * - Record the GPU times available.
+ */
+void FrameTimer::endFrame() {
+	glEndQuery(GL_TIME_ELAPSED);
+	cpu_times_.push_back(glfwGetTime() - begin_time_);
+
+	collect(false);
+}
+
+void FrameTimer::finish() {
+	while (!pending_queries_.empty())
+		collect(true);
+}
+
+std::size_t FrameTimer::getFrameCount() {
+	return gpu_times_.size();
+}
+
+/*
+ * FrameTimer collect:
+ * - From the oldest query, until a result is not available:
+ *   - Record the GPU time of the frame and free its query.
+ * - If waiting, the oldest result is waited for.
+ */
+void FrameTimer::collect(bool wait) {
+	while (!pending_queries_.empty()) {
+		GLuint query{ pending_queries_.front() };
+
+		GLuint available{ GL_FALSE };
+		glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available == GL_FALSE && !wait)
+			break;
+		wait = false;
+
+		GLuint64 elapsed{ 0 };
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+		gpu_times_.push_back(elapsed * 1e-9);
+
+		free_queries_.push_back(query);
+		pending_queries_.pop_front();
+	}
+}
+
+/*
+ * FrameTimer report:
+ * - For the CPU and GPU times:
+ *   - Sort the times of the frames with both times recorded.
+ *   - Write the count, the 50th, 95th and 99th percentile and the maximum.
+ */
+void FrameTimer::report(std::ostream& out) {
+	out << std::left << std::setw(10) << "Time" << std::right << std::setw(10) << "Frames" << std::setw(10) << "p50 ms"
+	    << std::setw(10) << "p95 ms" << std::setw(10) << "p99 ms" << std::setw(10) << "max ms" << "\n";
+
+	const std::size_t count{ getFrameCount() };
+	if (count == 0)
+		return;
+	const std::vector<double>* recorded[2]{ &cpu_times_, &gpu_times_ };
+	for (int type = 0; type < 2; type++) {
+		std::vector<double> times{ recorded[type]->begin(), recorded[type]->begin() + count };
+		std::sort(times.begin(), times.end());
+
+		out << std::left << std::setw(10) << kTimeNames[type] << std::right << std::setw(10) << count
+		    << std::fixed << std::setprecision(2) << std::setw(10) << percentile(times, 0.5) << std::setw(10) << percentile(times, 0.95)
+		    << std::setw(10) << percentile(times, 0.99) << std::setw(10) << 1000.0 * times.back() << "\n";
+	}
+	out << std::flush;
+}
+
+/*
+ * FrameTimer writeJson:
+ * - Write the number of frames.
+ * - For the CPU and GPU times, write the percentiles and the time of each frame.
+ */
+void FrameTimer::writeJson(std::ostream& out) {
+	const std::size_t count{ getFrameCount() };
+	out << std::setprecision(4) << std::fixed;
+	out << "{\n  \"frames\": " << count;
+
+	const std::vector<double>* recorded[2]{ &cpu_times_, &gpu_times_ };
+	for (int type = 0; type < 2 && count > 0; type++) {
+		std::vector<double> times{ recorded[type]->begin(), recorded[type]->begin() + count };
+		out << ",\n  \"" << (type == 0 ? "cpu" : "gpu") << "\": { ";
+		std::vector<double> sorted{ times };
+		std::sort(sorted.begin(), sorted.end());
+		out << "\"p50_ms\": " << percentile(sorted, 0.5) << ", \"p95_ms\": " << percentile(sorted, 0.95)
+		    << ", \"p99_ms\": " << percentile(sorted, 0.99) << ", \"max_ms\": " << 1000.0 * sorted.back() << ", \"times_ms\": [";
+		for (std::size_t i = 0; i < times.size(); i++)
+			out << (i > 0 ? ", " : "") << 1000.0 * times[i];
+		out << "] }";
+	}
+	out << "\n}" << std::endl;
+}
+
+void FrameTimer::reset() {
+	finish();
+	cpu_times_.clear();
+	gpu_times_.clear();
+}
+
+FrameTimer::~FrameTimer() {
+	finish();
+	glDeleteQueries(static_cast<GLsizei>(kQueryCount), free_queries_.data());
+}
+
+} // namespace render
+} // namespace wanderers
@@ -0,0 +1,84 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the FrameWriter class.                                  *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "render/frame_writer.h"
+
+/* STL Includes */
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace wanderers {
+namespace render {
+
+namespace {
+
+void makeDirectory(const std::string& directory) {
+#ifdef _WIN32
+	_mkdir(directory.c_str());
+#else
+	mkdir(directory.c_str(), 0755);
+#endif
+}
+
+} // namespace
+
+/*
+ * FrameWriter Constructor:
+ * - Create the output directory if it does not exist.
+ */
+FrameWriter::FrameWriter(std::string output_directory, FrameFormat frame_format, int width, int height)
+	: output_directory_{ output_directory }, frame_format_{ frame_format }, width_{ width }, height_{ height } {
+	makeDirectory(output_directory_);
+}
+
+std::string FrameWriter::framePath(int frame_number) {
+	std::stringstream path;
+	path << output_directory_ << "/frame_" << std::setw(6) << std::setfill('0') << frame_number
+	     << (frame_format_ == FrameFormat::Ppm ? ".ppm" : ".raw");
+	return path.str();
+}
+
+/*
+ * FrameWriter write:
+ * - Open the numbered frame file.
+ * - If ppm, write header and rows flipped so the top row is first.
+ * - If raw, write the pixels as they are.
+ * - Return 0 if successful.
+ */
+int FrameWriter::write(int frame_number, const std::vector<unsigned char>& pixels) {
+	std::string path{ framePath(frame_number) };
+	std::ofstream frame_file{ path, std::ios::binary };
+	if (!frame_file) {
+		std::cout << "Error: Could not open " << path << " for writing." << std::endl;
+		return 1;
+	}
+
+	const std::size_t row_size{ 3 * static_cast<std::size_t>(width_) };
+	switch (frame_format_) {
+	case FrameFormat::Ppm:
+		frame_file << "P6\n" << width_ << " " << height_ << "\n255\n";
+		for (int row = height_ - 1; row >= 0; row--)
+			frame_file.write(reinterpret_cast<const char*>(pixels.data() + row * row_size), row_size);
+		break;
+	case FrameFormat::Raw:
+		frame_file.write(reinterpret_cast<const char*>(pixels.data()), row_size * height_);
+		break;
+	}
+
+	return frame_file.good() ? 0 : 1;
+}
+
+} // namespace render
+} // namespace wanderers
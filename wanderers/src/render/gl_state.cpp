@@ -0,0 +1,192 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the GLState class.                                      *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "render/gl_state.h"
+
+/* External Includes */
+#include "glad/gl.h"
+
+/* STL Includes */
+#include <iomanip>
+
+namespace wanderers {
+namespace render {
+
+GLState::GLState() : issued_calls_{ 0 }, removed_calls_{ 0 } {
+	invalidate();
+}
+
+bool GLState::changed(bool is_changed) {
+	if (is_changed)
+		issued_calls_++;
+	else
+		removed_calls_++;
+	return is_changed;
+}
+
+void GLState::useProgram(unsigned int program) {
+	if (changed(program != program_)) {
+		glUseProgram(program);
+		program_ = program;
+	}
+}
+
+void GLState::bindVertexArray(unsigned int VAO) {
+	if (changed(VAO != VAO_)) {
+		glBindVertexArray(VAO);
+		VAO_ = VAO;
+	}
+}
+
+/*
+ * GLState bindBuffer:
+ * - Always bind element array buffers, they depend on the bound vertex array.
+ * - Bind other buffers if not already bound to the target.
+ */
+void GLState::bindBuffer(unsigned int target, unsigned int buffer) {
+	if (target == GL_ELEMENT_ARRAY_BUFFER) {
+		issued_calls_++;
+		glBindBuffer(target, buffer);
+		return;
+	}
+
+	std::map<unsigned int, unsigned int>::iterator bound{ buffers_.find(target) };
+	if (changed(bound == buffers_.end() || bound->second != buffer)) {
+		glBindBuffer(target, buffer);
+		buffers_[target] = buffer;
+	}
+}
+
+void GLState::bindBufferBase(unsigned int target, unsigned int index, unsigned int buffer) {
+	issued_calls_++;
+	glBindBufferBase(target, index, buffer);
+	buffers_[target] = buffer;
+}
+
+void GLState::enable(unsigned int capability) {
+	std::map<unsigned int, bool>::iterator enabled{ capabilities_.find(capability) };
+	if (changed(enabled == capabilities_.end() || !enabled->second)) {
+		glEnable(capability);
+		capabilities_[capability] = true;
+	}
+}
+
+void GLState::disable(unsigned int capability) {
+	std::map<unsigned int, bool>::iterator enabled{ capabilities_.find(capability) };
+	if (changed(enabled == capabilities_.end() || enabled->second)) {
+		glDisable(capability);
+		capabilities_[capability] = false;
+	}
+}
+
+void GLState::depthFunc(unsigned int function) {
+	if (changed(function != depth_function_)) {
+		glDepthFunc(function);
+		depth_function_ = function;
+	}
+}
+
+void GLState::depthMask(bool write) {
+	if (changed(depth_mask_ != (write ? 1 : 0))) {
+		glDepthMask(write ? GL_TRUE : GL_FALSE);
+		depth_mask_ = write ? 1 : 0;
+	}
+}
+
+void GLState::depthRange(float near_value, float far_value) {
+	if (changed(!depth_range_known_ || near_value != depth_near_ || far_value != depth_far_)) {
+		glDepthRange(near_value, far_value);
+		depth_near_ = near_value;
+		depth_far_ = far_value;
+		depth_range_known_ = true;
+	}
+}
+
+void GLState::blendFunc(unsigned int source_factor, unsigned int destination_factor) {
+	if (changed(source_factor != blend_source_ || destination_factor != blend_destination_)) {
+		glBlendFunc(source_factor, destination_factor);
+		blend_source_ = source_factor;
+		blend_destination_ = destination_factor;
+	}
+}
+
+void GLState::pointSize(float size) {
+	if (changed(point_size_ < 0.0f || size != point_size_)) {
+		glPointSize(size);
+		point_size_ = size;
+	}
+}
+
+void GLState::releaseProgram(unsigned int program) {
+	if (program_ == program)
+		program_ = 0;
+}
+
+void GLState::releaseVertexArray(unsigned int VAO) {
+	if (VAO_ == VAO)
+		VAO_ = 0;
+}
+
+void GLState::releaseBuffer(unsigned int buffer) {
+	for (std::pair<const unsigned int, unsigned int>& bound : buffers_) {
+		if (bound.second == buffer)
+			bound.second = 0;
+	}
+}
+
+void GLState::invalidate() {
+	program_ = kUnknown;
+	VAO_ = kUnknown;
+	buffers_.clear();
+	capabilities_.clear();
+	depth_function_ = kUnknown;
+	depth_mask_ = -1;
+	depth_near_ = 0.0f;
+	depth_far_ = 1.0f;
+	depth_range_known_ = false;
+	blend_source_ = kUnknown;
+	blend_destination_ = kUnknown;
+	point_size_ = -1.0f;
+}
+
+long long GLState::getIssuedCalls() { return issued_calls_; }
+
+long long GLState::getRemovedCalls() { return removed_calls_; }
+
+void GLState::resetCounters() {
+	issued_calls_ = 0;
+	removed_calls_ = 0;
+}
+
+/*
+ * GLState report:
+ * - Write the number of calls made and removed, and the share removed.
+ */
+void GLState::report(std::ostream& out) {
+	const long long issued_calls{ issued_calls_ };
+	const long long removed_calls{ removed_calls_ };
+	const long long total_calls{ issued_calls + removed_calls };
+	out << "GL state calls: " << issued_calls << " made, " << removed_calls << " removed";
+	if (total_calls > 0)
+		out << " (" << std::fixed << std::setprecision(1) << 100.0 * removed_calls / total_calls << "%)";
+	out << std::endl;
+}
+
+/*
+ * GLState getGLState:
+ * - Construct the GL state singleton if not constructed.
+ */
+GLState* GLState::getGLState() {
+	static GLState* gl_state;
+	if (!gl_state) {
+		gl_state = new GLState{};
+	}
+	return gl_state;
+}
+
+} // namespace render
+} // namespace wanderers
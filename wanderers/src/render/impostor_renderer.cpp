@@ -0,0 +1,244 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the ImpostorRenderer class.                             *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "render/impostor_renderer.h"
+
+/* External Includes */
+#include "glad/gl.h"
+#include "glm/ext.hpp"
+
+/* Internal Includes */
+#include "render/gl_state.h"
+
+/* STL Includes */
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace wanderers {
+namespace render {
+
+/*
+ * ImpostorRenderer Constructor:
+ * - Create and link the impostor shader.
+ * - Generate the atlas texture and its depth buffer, and the framebuffer rendering into them.
+ * - Generate the empty VAO and the storage buffer.
+ * - All tiles are free.
+ */
+ImpostorRenderer::ImpostorRenderer(int tile_size, int tiles_per_side, int refresh_budget)
+	: shader_{ new shader::ShaderProgram{"shaders/impostor_vertex.glsl", "shaders/impostor_fragment.glsl"} },
+	  tile_size_{ tile_size }, tiles_per_side_{ tiles_per_side }, refresh_budget_{ refresh_budget },
+	  atlas_{ 0 }, depth_RBO_{ 0 }, FBO_{ 0 }, VAO_{ 0 }, SSBO_{ 0 }, capacity_{ 0 },
+	  impostors_{}, free_tiles_{}, instances_{}, view_projection_{ 1.0f }, camera_position_{ 0.0f }, camera_up_{ 0.0f, 1.0f, 0.0f },
+	  pixel_scale_{ 0.0f }, frame_{ 0 }, refresh_count_{ 0 }, impostor_count_{ 0 } {
+	shader_->link();
+
+	const int atlas_size{ tile_size_ * tiles_per_side_ };
+	glGenTextures(1, &atlas_);
+	glBindTexture(GL_TEXTURE_2D, atlas_);
+	glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, atlas_size, atlas_size);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenRenderbuffers(1, &depth_RBO_);
+	glBindRenderbuffer(GL_RENDERBUFFER, depth_RBO_);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, atlas_size, atlas_size);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	GLint bound_FBO{ 0 };
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &bound_FBO);
+	glGenFramebuffers(1, &FBO_);
+	glBindFramebuffer(GL_FRAMEBUFFER, FBO_);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, atlas_, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth_RBO_);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		std::cout << "Error: Impostor framebuffer is not complete." << std::endl;
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, bound_FBO);
+
+	glGenVertexArrays(1, &VAO_);
+	glGenBuffers(1, &SSBO_);
+
+	for (int tile = tiles_per_side_ * tiles_per_side_ - 1; tile >= 0; tile--)
+		free_tiles_.push_back(tile);
+}
+
+/*
+ * ImpostorRenderer begin:
+ * - Clear the impostors of the last frame.
+ * - Evict the impostors not added in the last refresh frames, freeing their tiles.
+ * - Store the view projection, the camera position and up direction.
+ * - Calculate the pixels per unit length at unit distance from the projection.
+ */
+void ImpostorRenderer::begin(glm::mat4 view, glm::mat4 projection, int render_height) {
+	instances_.clear();
+	refresh_count_ = 0;
+	frame_++;
+
+	for (auto it = impostors_.begin(); it != impostors_.end();) {
+		if (frame_ - it->second.added_frame > kRefreshFrames) {
+			free_tiles_.push_back(it->second.tile);
+			it = impostors_.erase(it);
+		} else {
+			it++;
+		}
+	}
+
+	view_projection_ = projection * view;
+	glm::mat4 inverse_view{ glm::inverse(view) };
+	camera_position_ = glm::vec3{ inverse_view[3] };
+	camera_up_ = glm::vec3{ inverse_view[1] };
+	// projection[1][1] is the cotangent of half the vertical field of view.
+	pixel_scale_ = 0.5f * render_height * projection[1][1];
+}
+
+float ImpostorRenderer::maxPixelSize() { return static_cast<float>(tile_size_); }
+
+/*
+ * ImpostorRenderer add:
+ * - Skip the object if the camera is close to it or it is larger on screen than a tile.
+ * - Get the impostor of the object, taking a free tile if it has none.
+ * - Refresh the impostor if it is new, or the direction changed or it is old and there is budget left.
+ *   A new impostor without budget is rendered as geometry this frame.
+ * - Store the impostor instance.
+ */
+bool ImpostorRenderer::add(const void* object, glm::vec3 center, float radius, RenderFunction render_object) {
+	float distance{ glm::distance(center, camera_position_) };
+	if (distance <= 2.0f * radius || 2.0f * pixel_scale_ * radius / distance > maxPixelSize())
+		return false;
+
+	auto it{ impostors_.find(object) };
+	if (it == impostors_.end()) {
+		if (free_tiles_.empty() || refresh_count_ >= refresh_budget_)
+			return false;
+		it = impostors_.insert(std::make_pair(object, Impostor{ free_tiles_.back(), glm::vec3{ 0.0f }, glm::vec3{ 0.0f }, glm::vec3{ 0.0f }, 0.0f, -1, frame_ })).first;
+		free_tiles_.pop_back();
+	}
+	Impostor& impostor{ it->second };
+	impostor.added_frame = frame_;
+
+	glm::vec3 direction{ (center - camera_position_) / distance };
+	bool is_stale{ impostor.refreshed_frame < 0
+	            || std::acos(glm::clamp(glm::dot(direction, impostor.direction), -1.0f, 1.0f)) > kRefreshAngle
+	            || frame_ - impostor.refreshed_frame >= kRefreshFrames };
+	if (is_stale && refresh_count_ < refresh_budget_) {
+		refresh(impostor, center, radius, render_object);
+		refresh_count_++;
+	}
+	if (impostor.refreshed_frame < 0)
+		return false;
+
+	const float tile_scale{ 1.0f / tiles_per_side_ };
+	glm::vec4 tile_rect{ (impostor.tile % tiles_per_side_) * tile_scale, (impostor.tile / tiles_per_side_) * tile_scale, tile_scale, tile_scale };
+	instances_.push_back(ImpostorInstance{ glm::vec4{ center, impostor.half_size }, glm::vec4{ impostor.right, 0.0f },
+	                                       glm::vec4{ impostor.up, 0.0f }, tile_rect });
+	return true;
+}
+
+/*
+ * ImpostorRenderer refresh:
+ * - Store the bound framebuffer, viewport and clear color.
+ * - Bind the atlas framebuffer and clear the tile.
+ * - Look at the object from the camera, with a projection just containing its bounding sphere.
+ * - Render the object into the tile.
+ * - Store the view the impostor was rendered from, the billboard is drawn with the same orientation.
+ * - Restore the framebuffer, viewport and clear color.
+ */
+void ImpostorRenderer::refresh(Impostor& impostor, glm::vec3 center, float radius, RenderFunction& render_object) {
+	GLint bound_FBO{ 0 };
+	GLint viewport[4]{};
+	GLfloat clear_color[4]{};
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &bound_FBO);
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	glGetFloatv(GL_COLOR_CLEAR_VALUE, clear_color);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, FBO_);
+	const int x{ (impostor.tile % tiles_per_side_) * tile_size_ };
+	const int y{ (impostor.tile / tiles_per_side_) * tile_size_ };
+	glViewport(x, y, tile_size_, tile_size_);
+	GLState::getGLState()->enable(GL_SCISSOR_TEST);
+	glScissor(x, y, tile_size_, tile_size_);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	float distance{ glm::distance(center, camera_position_) };
+	float half_angle{ std::asin(radius / distance) };
+	glm::mat4 view{ glm::lookAt(camera_position_, center, camera_up_) };
+	glm::mat4 projection{ glm::perspective(2.0f * half_angle, 1.0f, distance - radius, distance + radius) };
+	render_object(view, projection, tile_size_);
+
+	GLState::getGLState()->disable(GL_SCISSOR_TEST);
+
+	impostor.direction = (center - camera_position_) / distance;
+	impostor.right = glm::vec3{ view[0][0], view[1][0], view[2][0] };
+	impostor.up = glm::vec3{ view[0][1], view[1][1], view[2][1] };
+	impostor.half_size = distance * std::tan(half_angle);
+	impostor.refreshed_frame = frame_;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, bound_FBO);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	glClearColor(clear_color[0], clear_color[1], clear_color[2], clear_color[3]);
+}
+
+/*
+ * ImpostorRenderer draw:
+ * - Upload the impostor instances into a new buffer store, grown if needed.
+ * - Use the impostor shader, set uniforms and bind the atlas.
+ * - Draw one quad instance per impostor.
+ */
+void ImpostorRenderer::draw() {
+	impostor_count_ = static_cast<int>(instances_.size());
+	if (instances_.empty())
+		return;
+
+	GLState::getGLState()->bindBuffer(GL_SHADER_STORAGE_BUFFER, SSBO_);
+	GLsizeiptr buffer_size{ static_cast<GLsizeiptr>(sizeof(ImpostorInstance) * instances_.size()) };
+	if (instances_.size() > capacity_)
+		capacity_ = instances_.capacity();
+	// Orphan the buffer so the upload does not wait for the draw of the last frame.
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(ImpostorInstance) * capacity_, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, buffer_size, instances_.data());
+	GLState::getGLState()->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, SSBO_);
+
+	shader_->use();
+	shader_->setUniform(view_projection_, "VP");
+	shader_->setUniform(0, "atlas");
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, atlas_);
+
+	GLState::getGLState()->bindVertexArray(VAO_);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, impostor_count_);
+	GLState::getGLState()->bindVertexArray(0);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	GLState::getGLState()->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+}
+
+int ImpostorRenderer::getImpostorCount() {
+	return impostor_count_;
+}
+
+int ImpostorRenderer::getRefreshCount() {
+	return refresh_count_;
+}
+
+ImpostorRenderer::~ImpostorRenderer() {
+	GLState::getGLState()->releaseBuffer(SSBO_);
+	GLState::getGLState()->releaseVertexArray(VAO_);
+	glDeleteBuffers(1, &SSBO_);
+	glDeleteVertexArrays(1, &VAO_);
+	glDeleteFramebuffers(1, &FBO_);
+	glDeleteRenderbuffers(1, &depth_RBO_);
+	glDeleteTextures(1, &atlas_);
+	delete shader_;
+}
+
+} // namespace render
+} // namespace wanderers
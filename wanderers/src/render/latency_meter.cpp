@@ -0,0 +1,135 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the LatencyMeter class.                                 *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "render/latency_meter.h"
+
+/* External Includes */
+#include "glad/gl.h"
+#include "glfw/glfw3.h"
+
+/* STL Includes */
+#include <algorithm>
+#include <iomanip>
+
+namespace wanderers {
+namespace render {
+
+/* Names of the input types in the report. */
+static const char* const kInputTypeNames[common::kInputTypeCount]{ "Key", "Cursor", "Scroll" };
+
+LatencyMeter::LatencyMeter() : enabled_{ false }, submitted_sequences_{}, pending_frames_{}, latencies_{}, latencies_mutex_{} {}
+
+void LatencyMeter::setEnabled(bool enabled) {
+	enabled_ = enabled;
+}
+
+bool LatencyMeter::getEnabled() {
+	return enabled_;
+}
+
+/*
+ * LatencyMeter submitFrame:
+ * - Keep the stamps of the inputs not shown by an earlier frame.
+ * - If there are any, record a timestamp after the swap, and calibrate the GPU clock against the CPU clock.
+ */
+void LatencyMeter::submitFrame(const common::InputStamp (&input_stamps)[common::kInputTypeCount]) {
+	if (!enabled_ || pending_frames_.size() >= kMaxPendingFrames)
+		return;
+
+	PendingFrame frame{};
+	bool has_input{ false };
+	for (int type = 0; type < common::kInputTypeCount; type++) {
+		if (input_stamps[type].sequence > submitted_sequences_[type]) {
+			frame.input_stamps[type] = input_stamps[type];
+			submitted_sequences_[type] = input_stamps[type].sequence;
+			has_input = true;
+		}
+	}
+	if (!has_input)
+		return;
+
+	glGenQueries(1, &frame.query);
+	glQueryCounter(frame.query, GL_TIMESTAMP);
+
+	GLint64 gpu_time{ 0 };
+	glGetInteger64v(GL_TIMESTAMP, &gpu_time);
+	frame.clock_offset = glfwGetTime() - gpu_time * 1e-9;
+	pending_frames_.push_back(frame);
+}
+
+/*
+ * LatencyMeter collect:
+ * - From the oldest frame, until the timestamp of a frame is not available:
+ *   - Convert the timestamp to the CPU clock.
+ *   - Record the time from each input of the frame until it was presented.
+ */
+void LatencyMeter::collect() {
+	while (!pending_frames_.empty()) {
+		PendingFrame& frame{ pending_frames_.front() };
+
+		GLuint available{ GL_FALSE };
+		glGetQueryObjectuiv(frame.query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available == GL_FALSE)
+			break;
+
+		GLuint64 timestamp{ 0 };
+		glGetQueryObjectui64v(frame.query, GL_QUERY_RESULT, &timestamp);
+		const double present_time{ timestamp * 1e-9 + frame.clock_offset };
+		std::lock_guard<std::mutex> guard{ latencies_mutex_ };
+		for (int type = 0; type < common::kInputTypeCount; type++) {
+			if (frame.input_stamps[type].sequence != 0)
+				latencies_[type].push_back(present_time - frame.input_stamps[type].time);
+		}
+
+		glDeleteQueries(1, &frame.query);
+		pending_frames_.pop_front();
+	}
+}
+
+/*
+ * LatencyMeter report:
+ * - For each type of input with recorded latencies:
+ *   - Copy and sort the latencies, the render thread may be recording more.
+ *   - Write the count, the 50th, 90th and 99th percentile and the maximum.
+ */
+void LatencyMeter::report(std::ostream& out) {
+	out << std::left << std::setw(10) << "Input" << std::right << std::setw(10) << "Count" << std::setw(10) << "p50 ms"
+	    << std::setw(10) << "p90 ms" << std::setw(10) << "p99 ms" << std::setw(10) << "max ms" << "\n";
+
+	for (int type = 0; type < common::kInputTypeCount; type++) {
+		std::vector<double> latencies{};
+		{
+			std::lock_guard<std::mutex> guard{ latencies_mutex_ };
+			latencies = latencies_[type];
+		}
+		if (latencies.empty())
+			continue;
+		std::sort(latencies.begin(), latencies.end());
+
+		auto percentile = [&latencies](double fraction) {
+			return 1000.0 * latencies[static_cast<std::size_t>(fraction * (latencies.size() - 1) + 0.5)];
+		};
+		out << std::left << std::setw(10) << kInputTypeNames[type] << std::right << std::setw(10) << latencies.size()
+		    << std::fixed << std::setprecision(2) << std::setw(10) << percentile(0.5) << std::setw(10) << percentile(0.9)
+		    << std::setw(10) << percentile(0.99) << std::setw(10) << 1000.0 * latencies.back() << "\n";
+	}
+	out << std::flush;
+}
+
+void LatencyMeter::reset() {
+	std::lock_guard<std::mutex> guard{ latencies_mutex_ };
+	for (std::vector<double>& latencies : latencies_)
+		latencies.clear();
+}
+
+LatencyMeter::~LatencyMeter() {
+	for (PendingFrame& frame : pending_frames_)
+		glDeleteQueries(1, &frame.query);
+}
+
+} // namespace render
+} // namespace wanderers
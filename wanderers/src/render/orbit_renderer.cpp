@@ -0,0 +1,149 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the OrbitRenderer class.                                *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "render/orbit_renderer.h"
+
+/* External Includes */
+#include "glad/gl.h"
+#include "glm/ext.hpp"
+
+/* Internal Includes */
+#include "render/gl_state.h"
+
+/* STL Includes */
+#include <algorithm>
+#include <cmath>
+
+namespace wanderers {
+namespace render {
+
+/*
+ * OrbitRenderer Constructor:
+ * - Create and link the orbit shader.
+ * - Generate the empty VAO and the storage buffer.
+ */
+OrbitRenderer::OrbitRenderer()
+	: shader_{ new shader::ShaderProgram{"shaders/orbit_vertex.glsl", "shaders/orbit_fragment.glsl"} },
+	  VAO_{ 0 }, SSBO_{ 0 }, capacity_{ 0 }, orbits_{}, max_segments_{ 0 },
+	  view_projection_{ 1.0f }, pixel_scale_{ 0.0f }, camera_position_{ 0.0f }, orbit_count_{ 0 } {
+	shader_->link();
+
+	glGenVertexArrays(1, &VAO_);
+	glGenBuffers(1, &SSBO_);
+}
+
+/*
+ * OrbitRenderer begin:
+ * - Clear the orbits of the last frame.
+ * - Store the view projection and the camera position.
+ * - Calculate the pixels per unit length at unit distance from the projection.
+ */
+void OrbitRenderer::begin(glm::mat4 view, glm::mat4 projection, int render_height) {
+	orbits_.clear();
+	max_segments_ = 0;
+
+	view_projection_ = projection * view;
+	camera_position_ = glm::vec3{ glm::inverse(view)[3] };
+	// projection[1][1] is the cotangent of half the vertical field of view.
+	pixel_scale_ = 0.5f * render_height * projection[1][1];
+}
+
+/*
+ * OrbitRenderer add:
+ * - Calculate the number of segments.
+ * - Skip the orbit if it is not visible.
+ * - Store the orbit instance.
+ */
+void OrbitRenderer::add(glm::mat4 orbit_matrix, glm::vec3 color) {
+	unsigned int segments{ segmentCount(orbit_matrix) };
+	if (segments == 0)
+		return;
+
+	orbits_.push_back(OrbitInstance{ orbit_matrix, color, segments });
+	max_segments_ = std::max(max_segments_, segments);
+}
+
+/*
+ * OrbitRenderer segmentCount:
+ * - Get the center and the bounding radius of the ellipse, skip the orbit if it has no size.
+ * - Skip the orbit if its bounding sphere is outside the view frustum.
+ * - Project the radius onto the screen, if the camera is within the orbit use the max segments.
+ * - Skip the orbit if it is smaller than a pixel.
+ * - Use enough segments so the chords are within the pixel tolerance of the ellipse.
+ *   The distance between a chord and a circle of radius r is r(1 - cos(pi / n)) ~ r pi^2 / (2 n^2).
+ */
+unsigned int OrbitRenderer::segmentCount(const glm::mat4& orbit_matrix) {
+	glm::vec3 center{ orbit_matrix[3] };
+	float radius{ std::max(glm::length(glm::vec3{ orbit_matrix[0] }), glm::length(glm::vec3{ orbit_matrix[2] })) };
+	if (radius <= 0.0f)
+		return 0;
+
+	// Frustum planes from the rows of the view projection (Gribb-Hartmann).
+	glm::mat4 m{ glm::transpose(view_projection_) };
+	for (int plane = 0; plane < 6; plane++) {
+		glm::vec4 p{ m[3] + (plane % 2 == 0 ? 1.0f : -1.0f) * m[plane / 2] };
+		if (glm::dot(glm::vec3{ p }, center) + p.w < -radius * glm::length(glm::vec3{ p }))
+			return 0;
+	}
+
+	float distance{ glm::distance(center, camera_position_) - radius };
+	if (distance <= 0.0f)
+		return kMaxSegments;
+
+	float pixel_radius{ pixel_scale_ * radius / distance };
+	if (pixel_radius < 0.5f)
+		return 0;
+
+	float segments{ glm::pi<float>() * std::sqrt(pixel_radius / (2.0f * kPixelTolerance)) };
+	return std::min(kMaxSegments, std::max(kMinSegments, static_cast<unsigned int>(std::ceil(segments))));
+}
+
+/*
+ * OrbitRenderer draw:
+ * - Upload the orbit instances into a new buffer store, grown if needed.
+ * - Use the orbit shader and set uniforms.
+ * - Draw one line strip instance per orbit, each instance as long as the most detailed orbit.
+ *   The shader clamps the vertices of less detailed orbits to their last vertex.
+ */
+void OrbitRenderer::draw() {
+	orbit_count_ = static_cast<int>(orbits_.size());
+	if (orbits_.empty())
+		return;
+
+	GLState::getGLState()->bindBuffer(GL_SHADER_STORAGE_BUFFER, SSBO_);
+	GLsizeiptr buffer_size{ static_cast<GLsizeiptr>(sizeof(OrbitInstance) * orbits_.size()) };
+	if (orbits_.size() > capacity_)
+		capacity_ = orbits_.capacity();
+	// Orphan the buffer so the upload does not wait for the draw of the last frame.
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(OrbitInstance) * capacity_, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, buffer_size, orbits_.data());
+	GLState::getGLState()->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, SSBO_);
+
+	shader_->use();
+	shader_->setUniform(view_projection_, "VP");
+
+	GLState::getGLState()->bindVertexArray(VAO_);
+	glDrawArraysInstanced(GL_LINE_STRIP, 0, max_segments_ + 1, orbit_count_);
+	GLState::getGLState()->bindVertexArray(0);
+
+	GLState::getGLState()->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+}
+
+int OrbitRenderer::getOrbitCount() {
+	return orbit_count_;
+}
+
+OrbitRenderer::~OrbitRenderer() {
+	GLState::getGLState()->releaseBuffer(SSBO_);
+	GLState::getGLState()->releaseVertexArray(VAO_);
+	glDeleteBuffers(1, &SSBO_);
+	glDeleteVertexArrays(1, &VAO_);
+	delete shader_;
+}
+
+} // namespace render
+} // namespace wanderers
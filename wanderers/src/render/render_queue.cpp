@@ -0,0 +1,96 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the RenderQueue class.                                  *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "render/render_queue.h"
+
+/* STL Includes */
+#include <algorithm>
+#include <cstring>
+
+namespace wanderers {
+namespace render {
+
+RenderQueue::RenderQueue() : items_{}, entries_{}, sort_buffer_{} {}
+
+void RenderQueue::clear() {
+	items_.clear();
+	entries_.clear();
+}
+
+void RenderQueue::add(Pass pass, unsigned int shader, float depth, const RenderItem& item) {
+	entries_.push_back({ makeKey(pass, shader, item.mesh->getMeshId(), depth), static_cast<std::uint32_t>(items_.size()) });
+	items_.push_back(item);
+}
+
+/*
+ * RenderQueue makeKey:
+ * - Put the pass, shader and mesh id in the most significant bits.
+ * - Put the depth in the least significant bits. A positive float sorts as its bits do,
+ *   and the bits are flipped for passes drawn back to front.
+ */
+std::uint64_t RenderQueue::makeKey(Pass pass, unsigned int shader, unsigned int mesh_id, float depth) {
+	std::uint32_t depth_bits{};
+	depth = std::max(depth, 0.0f);
+	std::memcpy(&depth_bits, &depth, sizeof(depth_bits));
+	if (pass == Pass::Transparent)
+		depth_bits = ~depth_bits;
+
+	std::uint64_t key{ static_cast<std::uint64_t>(pass) & ((1u << kPassBits) - 1) };
+	key = (key << kShaderBits) | (shader & ((1u << kShaderBits) - 1));
+	key = (key << kMeshBits) | (mesh_id & ((1u << kMeshBits) - 1));
+	key = (key << kDepthBits) | depth_bits;
+	return key;
+}
+
+/*
+ * RenderQueue sort:
+ * - For each digit of the keys, from the least significant:
+ *   - Count the keys of each digit value, skip the digit if all keys share it.
+ *   - Get the position of each digit value from the counts.
+ *   - Move the entries into the scratch buffer in order of the digit, keeping the order of equal digits.
+ *   - Swap buffers.
+ */
+void RenderQueue::sort() {
+	constexpr std::size_t kBuckets{ 1u << kRadixBits };
+	sort_buffer_.resize(entries_.size());
+
+	for (int shift = 0; shift < 64; shift += kRadixBits) {
+		std::size_t counts[kBuckets]{};
+		for (const SortEntry& entry : entries_)
+			counts[(entry.key >> shift) & (kBuckets - 1)]++;
+
+		if (std::find(std::begin(counts), std::end(counts), entries_.size()) != std::end(counts))
+			continue;
+
+		std::size_t offset{ 0 };
+		for (std::size_t& count : counts) {
+			std::size_t bucket_size{ count };
+			count = offset;
+			offset += bucket_size;
+		}
+
+		for (const SortEntry& entry : entries_)
+			sort_buffer_[counts[(entry.key >> shift) & (kBuckets - 1)]++] = entry;
+
+		entries_.swap(sort_buffer_);
+	}
+}
+
+std::size_t RenderQueue::size() const {
+	return entries_.size();
+}
+
+const RenderItem& RenderQueue::at(std::size_t position) const {
+	return items_[entries_[position].index];
+}
+
+unsigned int RenderQueue::getShader(std::size_t position) const {
+	return static_cast<unsigned int>(entries_[position].key >> (kMeshBits + kDepthBits)) & ((1u << kShaderBits) - 1);
+}
+
+} // namespace render
+} // namespace wanderers
@@ -10,6 +10,9 @@
 /* External Includes */
 #include "glad/gl.h"
 
+/* Internal Includes */
+#include "render/gl_state.h"
+
 /* STL Includes */
 #include <iostream>
 
@@ -29,6 +32,18 @@ ShaderProgram::ShaderProgram(std::string vertex_path, std::string fragment_path)
 	shaders_.push_back(fragment_shader);
 }
 
+/*
+ * ShaderProgram Constructor:
+ * - Create the shaders, with tessellation shaders between the vertex and fragment shader.
+ */
+ShaderProgram::ShaderProgram(std::string vertex_path, std::string tess_control_path, std::string tess_evaluation_path, std::string fragment_path)
+	: program_id_{ 0 }, shaders_{} {
+	shaders_.push_back(Shader{ GL_VERTEX_SHADER, vertex_path });
+	shaders_.push_back(Shader{ GL_TESS_CONTROL_SHADER, tess_control_path });
+	shaders_.push_back(Shader{ GL_TESS_EVALUATION_SHADER, tess_evaluation_path });
+	shaders_.push_back(Shader{ GL_FRAGMENT_SHADER, fragment_path });
+}
+
 /*
  * SahderProgram link:
  * - Read and compiles the shaders.
@@ -57,7 +72,7 @@ int ShaderProgram::link() {
 }
 
 void ShaderProgram::use() {
-	glUseProgram(program_id_);
+	render::GLState::getGLState()->useProgram(program_id_);
 }
 
 void ShaderProgram::setUniform(glm::mat4 matrix, const char* name) {
@@ -72,6 +87,10 @@ void ShaderProgram::setUniform(int integer, const char* name) {
 	glUniform1i(glGetUniformLocation(program_id_, name), integer);
 }
 
+void ShaderProgram::setUniform(float scalar, const char* name) {
+	glUniform1f(glGetUniformLocation(program_id_, name), scalar);
+}
+
 GLuint ShaderProgram::getProgramID() {
 	return program_id_;
 }
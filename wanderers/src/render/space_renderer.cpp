@@ -13,7 +13,16 @@
 #include "glm/ext.hpp"
 #include "glm/gtx/rotate_vector.hpp"
 
+/* Internal Includes */
+#include "render/gl_state.h"
+
+#include "simulation/object/model/surface.h"
+#include "simulation/object/model/surface_cache.h"
+
 /* STL Includes */
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <typeinfo>
 
 #include <iostream>
@@ -22,29 +31,45 @@ namespace wanderers {
 namespace render {
 
 SpaceRenderer::SpaceRenderer(render::shader::ShaderProgram* shader, render::Camera* camera)
-	: shader_{ shader }, camera_{ camera }, view_{}, projection_{}, show_orbits_{ false } { }
+	: shader_{ shader }, 
+	  terrain_shader_{ new render::shader::ShaderProgram{"shaders/terrain_vertex.glsl", "shaders/terrain_tess_control.glsl", 
+	                                                     "shaders/terrain_tess_evaluation.glsl", "shaders/fragment.glsl"} },
+	  stars_shader_{ new render::shader::ShaderProgram{"shaders/star_vertex.glsl", "shaders/fragment.glsl"} },
+	  star_skybox_{ new render::StarSkybox{} }, impostor_renderer_{ new render::ImpostorRenderer{} },
+	  orbit_renderer_{ new render::OrbitRenderer{} }, latency_meter_{ new render::LatencyMeter{} }, frame_prepared_{}, frame_queue_{}, system_queue_{}, system_stack_{}, camera_{ camera },
+	  camera_state_{ camera->getState() }, aspect_ratio_{ 1.0f }, frame_buffer_{ nullptr }, frame_capture_{ nullptr }, 
+	  view_{}, projection_{}, show_orbits_{ false }, tessellate_terrain_{ GLAD_GL_VERSION_4_0 != 0 }, bake_sky_{ true }, use_impostors_{ true } {
+	terrain_shader_->link();
+	stars_shader_->link();
+}
 
 /*
  * SpaceRenderer preRender:
- * - Adapt the camera to the window size.
- * - Get the view and projection matrix.
+ * - Bind the render target and get its size.
+ * - Take a snapshot of the camera, without blocking changes to it.
+ * - Get the view matrix, and the projection matrix for the render target size.
  * - Set the viewport.
  * - Clear the screen if it is set to.
  * - Use the shader.
  * - Enable OpenGL pipline operations.
  */
 void SpaceRenderer::preRender() {
+	if (frame_buffer_ != nullptr) {
+		frame_buffer_->bind();
+		render_width_ = frame_buffer_->getWidth();
+		render_height_ = frame_buffer_->getHeight();
+	} else {
+		glfwGetFramebufferSize(glfwGetCurrentContext(), &render_width_, &render_height_);
+	}
 	
-	glfwGetFramebufferSize(glfwGetCurrentContext(), &render_width_, &render_height_);
-	
-	camera_->lock();
+	camera_state_ = camera_->getState();
 
 	if (render_width_ != 0 && render_height_ != 0) {
-		camera_->setAspectRatio(render_width_, render_height_);
+		aspect_ratio_ = static_cast<float>(render_width_) / render_height_;
 	}
 	
-	view_ = camera_->getViewMatrix();
-	projection_ = camera_->getProjectionMatrix();
+	view_ = camera_state_.getViewMatrix();
+	projection_ = camera_state_.getProjectionMatrix(aspect_ratio_);
 
 	glViewport(0, 0, render_width_, render_height_);
 	if (camera_->shouldClear()) {
@@ -53,80 +78,166 @@ void SpaceRenderer::preRender() {
 
 	shader_->use();
 
-	glEnable(GL_DEPTH_TEST);
+	GLState::getGLState()->enable(GL_DEPTH_TEST);
 }
 
 /*
- * SpaceRenderer preRender:
- * - Disable OpenGL pipline operations.
- * - Swap frame for smooth transition.
+ * SpaceRenderer postRender:
+ * - If offscreen, resolve the frame so it can be read.
+ * - Capture the frame.
+ * - If not offscreen, swap frame for smooth transition.
+ * - Pass the presented frame and the input it shows to the latency meter.
  * - Poll all queued events.
  */
 void SpaceRenderer::postRender() {
-	camera_->unlock();
+	if (frame_buffer_ != nullptr) {
+		frame_buffer_->resolve();
+		frame_buffer_->bindRead();
+	} else {
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+		glReadBuffer(GL_BACK);
+	}
 
-	glDisable(GL_DEPTH_TEST);
+	if (frame_capture_ != nullptr) {
+		frame_capture_->capture(render_width_, render_height_);
+	}
+
+	if (frame_buffer_ == nullptr) {
+		glfwSwapBuffers(glfwGetCurrentContext());
+	}
 
-	glfwSwapBuffers(glfwGetCurrentContext());
+	latency_meter_->submitFrame(camera_state_.input_stamps);
+	latency_meter_->collect();
 	glfwPollEvents();
 }
 
 /*
  * SpaceRenderer render SpaceSimulation:
  * - Do prerender operation.
- * - Render solar system.s
- * - Render stars.
+ * - If the sky is baked, the screen is cleared and all stars are generated, draw the sky, baking it first if needed.
+ * - Render the stars not in the sky, behind everything else.
+ * - Add the solar systems to the queue of the frame, or as impostors if they are small on screen.
+ * - Sort the queue, the simulation is no longer read so signal that the frame is prepared.
+ * - Draw the queue.
+ * - Draw all impostors and all orbits of the solar systems at once.
  * - Do postrender operation.
  */
 void SpaceRenderer::render(simulation::SpaceSimulation* space_simulation) {
 	preRender();
 
-	for (simulation::object::Stars* stars : space_simulation->getGroupOfStars())
-		render(stars);
-	for (simulation::object::OrbitalSystem* solar_system : space_simulation->getSolarSystems())
-		render(solar_system);
+	orbit_renderer_->begin(view_, projection_, render_height_);
+	impostor_renderer_->begin(view_, projection_, render_height_);
+
+	const bool draw_sky{ bake_sky_ && camera_->shouldClear() && space_simulation->isGenerated() };
+	if (draw_sky) {
+		bakeSky(space_simulation);
+		star_skybox_->draw(view_, projection_);
+	}
+
+	stars_shader_->use();
+	GLState::getGLState()->depthRange(1.0f, 1.0f);
+	GLState::getGLState()->depthFunc(GL_LEQUAL);
+	for (simulation::object::Stars* stars : space_simulation->getGroupOfStars()) {
+		if (!draw_sky || stars->getDistance() < kSkyDistance)
+			render(stars);
+	}
+	GLState::getGLState()->depthFunc(GL_LESS);
+	GLState::getGLState()->depthRange(0.0f, 1.0f);
+	shader_->use();
+	frame_queue_.clear();
+	for (simulation::object::OrbitalSystem* solar_system : space_simulation->getSolarSystems()) {
+		if (!use_impostors_ || !renderImpostor(solar_system))
+			enqueue(solar_system, glm::mat4{ 1.0f }, frame_queue_);
+	}
+	frame_queue_.sort();
+	if (frame_prepared_)
+		frame_prepared_();
+	submit(frame_queue_);
+
+	impostor_renderer_->draw();
+	orbit_renderer_->draw();
+	shader_->use();
 
 	postRender();
 }
 
 /*
- * SpaceRenderer render Stars:
+ * SpaceRenderer bakeSky:
+ * - Find the closest stars far enough to be in the sky.
+ * - If the sky needs to be baked:
+ *   - Render the far stars into each face, with point sizes matching their size on screen and without twinkling.
+ *   - Bind the render target again.
+ */
+void SpaceRenderer::bakeSky(simulation::SpaceSimulation* space_simulation) {
+	float min_distance{ std::numeric_limits<float>::max() };
+	for (simulation::object::Stars* stars : space_simulation->getGroupOfStars()) {
+		if (stars->getDistance() >= kSkyDistance)
+			min_distance = std::min(min_distance, stars->getDistance());
+	}
+
+	const glm::vec3 camera_position{ camera_state_.position };
+	const float field_of_view{ camera_state_.field_of_view };
+	if (!star_skybox_->needsBake(camera_position, field_of_view, min_distance))
+		return;
+
+	// Same angular size as on screen, a face covers 90 degrees.
+	const float point_scale{ (star_skybox_->getFaceSize() / 2000.0f) * std::sqrt(60.0f / field_of_view) * field_of_view / 90.0f };
+
+	stars_shader_->use();
+	GLState::getGLState()->disable(GL_DEPTH_TEST);
+	star_skybox_->bake(camera_position, field_of_view, [this, space_simulation, point_scale](glm::mat4 view, glm::mat4 projection) {
+		for (simulation::object::Stars* stars : space_simulation->getGroupOfStars()) {
+			if (stars->getDistance() >= kSkyDistance)
+				renderStars(stars, view, projection, point_scale, false);
+		}
+	});
+	GLState::getGLState()->enable(GL_DEPTH_TEST);
+
+	if (frame_buffer_ != nullptr)
+		frame_buffer_->bind();
+	else
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(0, 0, render_width_, render_height_);
+}
+
+void SpaceRenderer::render(simulation::object::Stars* stars) {
+	renderStars(stars, view_, projection_, (render_width_ / 2000.0f) * sqrt(60.0f / camera_state_.field_of_view), true);
+}
+
+/*
+ * SpaceRenderer renderStars:
  * - For each physical star model.
  *   - Bind the model
  *   - Calculate transformation matrix for the model.
- *   - Set uniforms.
- *   - Enable OpenGL pipline operations.
- *   - Render.
- *   - Disable OpenGL pipline operations.
- *   - unbind model.
+ *   - Set uniforms, including how the star directions are decoded.
+ *   - Set the point size and render.
+ * - Unbind the last model.
+ * NOTE: The depth state the stars are drawn with is set by the caller, so it is not set for every group of stars.
  */
-void SpaceRenderer::render(simulation::object::Stars* stars) {
+void SpaceRenderer::renderStars(simulation::object::Stars* stars, glm::mat4 view, glm::mat4 projection, float point_scale, bool twinkle) {
 	simulation::object::AggregateObject* star_object{ stars->getPhysicalObject() };
 
-	glm::vec3 camera_position{ camera_->getPosition() };
+	glm::vec3 camera_position{ camera_state_.position };
 	glm::mat4 agg_model{ glm::translate(glm::mat4{1.0f}, camera_position * (1.0f - 1.0f / stars->getDistance())) /* * star_object->getMatrix()*/ };
+	float brightness{ twinkle ? static_cast<float>(0.25f * sin(stars->getSize() * glfwGetTime() + 10.0f * stars->getSize()) + 0.75f) : 0.75f };
 	for (std::pair<simulation::object::Object*, glm::vec3> object : star_object->getObjects()) {
 		object.first->bind();
 
 		glm::mat4 obj_model{ agg_model /* * glm::translate(glm::mat4{1.0f}, object.second) * object.first->getMatrix()*/};
-		shader_->setUniform(obj_model, "model");
-		shader_->setUniform(projection_ * view_ * obj_model, "MVP");
-		shader_->setUniform(glm::vec3(0.0f, 0.0f, 0.0f), "light_position");
-		shader_->setUniform(camera_position, "camera_position");
-		shader_->setUniform(stars->getColor() * 0.8f * static_cast<float>(0.25f * sin(stars->getSize() * glfwGetTime() + 10.0f * stars->getSize()) + 0.75f), "color");
-		shader_->setUniform(true, "is_sun");
-
-		glDepthRange(1.0f, 1.0f);
-		glDepthFunc(GL_LEQUAL);
-		glPointSize(stars->getSize() * (render_width_ / 2000.0f) * sqrt(60.0f / camera_->getFieldOfView()));
-		
-		glDrawArrays(GL_POINTS, 0, object.first->getModel()->size());
-		
-		glDepthFunc(GL_LESS);
-		glDepthRange(0.0f, 1.0f);
-
-		object.first->unbind();
+		stars_shader_->setUniform(obj_model, "model");
+		stars_shader_->setUniform(projection * view * obj_model, "MVP");
+		stars_shader_->setUniform(glm::vec3(0.0f, 0.0f, 0.0f), "light_position");
+		stars_shader_->setUniform(camera_position, "camera_position");
+		stars_shader_->setUniform(stars->getColor() * 0.8f * brightness, "color");
+		stars_shader_->setUniform(true, "is_sun");
+		stars_shader_->setUniform(object.first->getModel()->getPositionScale(), "position_scale");
+		stars_shader_->setUniform(object.first->getModel()->getVertexFormat() 
+		                          == simulation::object::model::Mesh::VertexFormat::DirectionDistance, "has_distance");
+
+		GLState::getGLState()->pointSize(stars->getSize() * point_scale);
+		object.first->getModel()->draw();
 	}
+	GLState::getGLState()->bindVertexArray(0);
 }
 
 glm::vec3 getOrbitColor(simulation::object::AstronomicalObject* object) {
@@ -143,121 +254,276 @@ glm::vec3 getOrbitColor(simulation::object::AstronomicalObject* object) {
 }
 
 /*
- * SpaceRenderer render OrbitalSystem:
- * - Calculate system matrix.
- * - Set uniforms.
- * - Foreach orbit:
- *   - Render the object in orbit.
- *   - Render the orbit.
+ * SpaceRenderer renderImpostor:
+ * - Get the center and bounding radius of the system in world space.
+ * - Add the system to the impostors, to be rendered with the view and projection of the impostor if refreshed.
+ *   The orbits are not part of the impostor.
+ * - If drawn as impostor, add the orbits of the system to the orbits of the frame.
  */
-void SpaceRenderer::render(simulation::object::OrbitalSystem* orbital_system, glm::mat4 transform) {
-	glm::mat4 system_matrix{ transform * orbital_system->getMatrix() };
+bool SpaceRenderer::renderImpostor(simulation::object::OrbitalSystem* solar_system) {
+	glm::mat4 system_matrix{ solar_system->getMatrix() };
+	glm::vec3 center{ system_matrix[3] };
+	float scale{ std::max(glm::length(glm::vec3{ system_matrix[0] }), 
+	                      std::max(glm::length(glm::vec3{ system_matrix[1] }), glm::length(glm::vec3{ system_matrix[2] }))) };
+	float radius{ scale * solar_system->getBoundingRadius() };
+	if (radius <= 0.0f)
+		return false;
+
+	bool is_impostor{ impostor_renderer_->add(solar_system, center, radius, [this, solar_system](glm::mat4 view, glm::mat4 projection, int render_height) {
+		glm::mat4 frame_view{ view_ };
+		glm::mat4 frame_projection{ projection_ };
+		int frame_render_height{ render_height_ };
+		bool show_orbits{ show_orbits_ };
+
+		view_ = view;
+		projection_ = projection;
+		render_height_ = render_height;
+		show_orbits_ = false;
+
+		shader_->use();
+		render(solar_system);
 
-	shader_->setUniform(glm::vec3(0.0f, 0.0f, 0.0f), "light_position");
-	shader_->setUniform(camera_->getPosition(), "camera_position");
+		view_ = frame_view;
+		projection_ = frame_projection;
+		render_height_ = frame_render_height;
+		show_orbits_ = show_orbits;
+	}) };
 
-	for (std::pair<simulation::object::AstronomicalObject*, simulation::object::Orbit*> orbit : orbital_system->getOrbits()) {
-		render(orbit.first, system_matrix * orbit.second->getMatrix());		
-		if (showOrbits()) {
+	if (is_impostor && showOrbits()) {
+		for (std::pair<simulation::object::AstronomicalObject*, simulation::object::Orbit*> orbit : solar_system->getOrbits())
 			render(orbit.second, getOrbitColor(orbit.first), system_matrix);
-		}
 	}
+	return is_impostor;
+}
+
+/*
+ * SpaceRenderer render OrbitalSystem:
+ * - Add the objects of the system to the queue of the system.
+ * - Sort and draw the queue.
+ */
+void SpaceRenderer::render(simulation::object::OrbitalSystem* orbital_system, glm::mat4 transform) {
+	system_queue_.clear();
+	enqueue(orbital_system, transform, system_queue_);
+	system_queue_.sort();
+	submit(system_queue_);
 }
 
 /*
  * SpaceRenderer render Orbit:
- * - Calculate transformation matrix for the models.
- * - For each physical solar model.
- *   - Bind the model
- *   - Set uniforms.
- *   - Render.
- *   - unbind model.
+ * - Add the orbit ellipse in world space to the orbit renderer.
  */
 void SpaceRenderer::render(simulation::object::Orbit* orbit, glm::vec3 color, glm::mat4 transform) {
-	simulation::object::AggregateObject* orbit_object{ orbit->getPhysicalObject() };
-
-	glm::mat4 agg_model{ transform * orbit->getOrbitMatrix() };
-	for (std::pair<simulation::object::Object*, glm::vec3> object : orbit_object->getObjects()) {
-		object.first->bind();
-
-		glm::mat4 obj_model{ agg_model * glm::translate(glm::mat4{1.0f}, object.second) * object.first->getMatrix() };
-		shader_->setUniform(obj_model, "model");
-		shader_->setUniform(projection_ * view_ * obj_model, "MVP");
-		shader_->setUniform(color, "color");
-		shader_->setUniform(true, "is_sun");
+	orbit_renderer_->add(transform * orbit->getOrbitMatrix(), color);
+}
 
-		glDrawArrays(GL_LINES, 0, object.first->getModel()->size());
-		object.first->unbind();
+/*
+ * SpaceRenderer enqueue OrbitalSystem:
+ * - Start with the system and its matrix.
+ * - Until there are no systems left to visit:
+ *   - Take the next system.
+ *   - Foreach orbit:
+ *     - Find the matrix of the object in orbit from the matrices evaluated by the system.
+ *     - Add the object in orbit depending on its type, subsystems are visited later.
+ *     - Render the orbit.
+ */
+void SpaceRenderer::enqueue(simulation::object::OrbitalSystem* orbital_system, glm::mat4 transform, RenderQueue& queue) {
+	system_stack_.clear();
+	system_stack_.push_back({ orbital_system, transform * orbital_system->getMatrix() });
+
+	while (!system_stack_.empty()) {
+		simulation::object::OrbitalSystem* system{ system_stack_.back().first };
+		glm::mat4 system_matrix{ system_stack_.back().second };
+		system_stack_.pop_back();
+
+		const glm::mat3x4* body_matrices{ system->getBodyMatrices() };
+		std::size_t body{ 0 };
+		for (std::pair<simulation::object::AstronomicalObject*, simulation::object::Orbit*> orbit : system->getOrbits()) {
+			glm::mat4 body_matrix{ system_matrix * simulation::object::BodyTransforms::toMatrix(body_matrices[body++]) };
+
+			const std::type_info& object_type{ typeid(*orbit.first) };
+			if (object_type == typeid(simulation::object::Solar)) {
+				enqueue(dynamic_cast<simulation::object::Solar*>(orbit.first), body_matrix, queue);
+			} else if (object_type == typeid(simulation::object::Planet)) {
+				enqueue(dynamic_cast<simulation::object::Planet*>(orbit.first), body_matrix, queue);
+			} else if (object_type == typeid(simulation::object::OrbitalSystem)) {
+				system_stack_.push_back({ dynamic_cast<simulation::object::OrbitalSystem*>(orbit.first), body_matrix });
+			}
+
+			if (showOrbits()) {
+				render(orbit.second, getOrbitColor(orbit.first), system_matrix);
+			}
+		}
 	}
 }
 
 /*
- * SpaceRenderer render Solar:
+ * SpaceRenderer enqueue Solar:
  * - Calculate transformation matrix for the models.
- * - For each physical solar model.
- *   - Bind the model
- *   - Set uniforms.
- *   - Render.
- *   - unbind model.
+ * - For each physical solar model, add it to the opaque pass of the shader.
  */
-void SpaceRenderer::render(simulation::object::Solar* solar, glm::mat4 transform) {
+void SpaceRenderer::enqueue(simulation::object::Solar* solar, glm::mat4 transform, RenderQueue& queue) {
 	simulation::object::AggregateObject* solar_object{ solar->getPhysicalObject() };
 
-	glm::mat4 agg_model{ transform * solar->getMatrix() * solar_object->getMatrix() };
+	glm::mat4 agg_model{ transform * solar_object->getMatrix() };
+	glm::vec3 camera_position{ camera_state_.position };
 	for (std::pair<simulation::object::Object*, glm::vec3> object : solar_object->getObjects()) {
-		object.first->bind();
-
-		glm::mat4 obj_model{ agg_model * glm::translate(glm::mat4{1.0f}, object.second) * object.first->getMatrix() };
-		shader_->setUniform(obj_model, "model");
-		shader_->setUniform(projection_ * view_ * obj_model, "MVP");
-		shader_->setUniform(solar->getColor(), "color");
-		shader_->setUniform(true, "is_sun");
-
-		glDrawArrays(GL_TRIANGLES, 0, object.first->getModel()->size());
-		object.first->unbind();
+		RenderItem item{};
+		item.mesh = object.first->getModel();
+		item.primitive_type = item.mesh->getMeshType();
+		item.model = agg_model * glm::translate(glm::mat4{1.0f}, object.second) * object.first->getMatrix();
+		item.color = solar->getColor();
+		item.is_sun = true;
+
+		queue.add(RenderQueue::Pass::Opaque, kStandardShader, glm::distance(camera_position, glm::vec3{ item.model[3] }), item);
 	}
 }
 
 /*
- * SpaceRenderer render Planet:
+ * SpaceRenderer enqueue Planet:
  * - Calculate transformation matrix for the models.
- * - For each physical planet model.
- *   - Bind the model
- *   - Set uniforms.
- *   - Render.
- *   - unbind model.
+ * - If tessellating, add each physical planet model to the terrain shader as patches,
+ *   refined and displaced by the shader.
+ * - Otherwise, add the surface of the planet from the surface cache for each physical planet model.
+ *   Until the surface is loaded on the thread pool and uploaded by the upload thread, the planet model is added instead.
  */
-void SpaceRenderer::render(simulation::object::Planet* planet, glm::mat4 transform) {
+void SpaceRenderer::enqueue(simulation::object::Planet* planet, glm::mat4 transform, RenderQueue& queue) {
 	simulation::object::AggregateObject* planet_object{ planet->getPhysicalObject() };
-	
-	glm::mat4 agg_model{ transform * planet->getMatrix() * planet_object->getMatrix() };
-	for (std::pair<simulation::object::Object*, glm::vec3> object : planet_object->getObjects()) {
-		object.first->bind();
 
-		glm::mat4 obj_model{ agg_model * glm::translate(glm::mat4{1.0f}, object.second) * object.first->getMatrix() };
-		shader_->setUniform(obj_model, "model");
-		shader_->setUniform(projection_ * view_ * obj_model, "MVP");
-		shader_->setUniform(planet->getColor(), "color");
-		shader_->setUniform(false, "is_sun");
+	glm::mat4 agg_model{ transform * planet_object->getMatrix() };
+	glm::vec3 camera_position{ camera_state_.position };
+
+	simulation::object::model::Surface* surface{ nullptr };
+	if (!tessellate_terrain_) {
+		surface = simulation::object::model::SurfaceCache::getSurfaceCache()
+			->requestSurface(planet->getTerrainSeed(), kSurfaceLevel, planet->getRoughness());
+		if (surface != nullptr && !surface->isUploaded() && surface->isUploading())
+			surface = nullptr;
+	}
 
-		glDrawArrays(GL_TRIANGLES, 0, object.first->getModel()->size());
-		object.first->unbind();
+	for (std::pair<simulation::object::Object*, glm::vec3> object : planet_object->getObjects()) {
+		RenderItem item{};
+		item.mesh = tessellate_terrain_ || surface == nullptr ? object.first->getModel() : surface;
+		item.primitive_type = tessellate_terrain_ ? GL_PATCHES : item.mesh->getMeshType();
+		item.model = agg_model * glm::translate(glm::mat4{1.0f}, object.second) * object.first->getMatrix();
+		item.color = planet->getColor();
+		item.is_sun = false;
+		item.terrain_offset = simulation::object::model::Surface::seedOffset(planet->getTerrainSeed());
+		item.roughness = planet->getRoughness();
+
+		queue.add(RenderQueue::Pass::Opaque, tessellate_terrain_ ? kTerrainShader : kStandardShader, 
+		          glm::distance(camera_position, glm::vec3{ item.model[3] }), item);
 	}
 }
 
 /*
- * SpaceRenderer render AstronomicalObject:
- * - Get the type of the object.
- * - Render the object depending on the type.
+ * SpaceRenderer submit:
+ * - For each item in sorted order:
+ *   - If the shader changed, use it and set the uniforms shared by its items.
+ *   - If the mesh changed, bind it.
+ *   - Set the uniforms of the item and draw it.
+ * - Unbind the last mesh and use the shader again.
  */
-void SpaceRenderer::render(simulation::object::AstronomicalObject* object, glm::mat4 transform) {
-	const std::type_info& object_type{ typeid(*object) };
-	if (object_type == typeid(simulation::object::Solar))
-		render(dynamic_cast<simulation::object::Solar*>(object), transform);
-	else if (object_type == typeid(simulation::object::Planet))
-		render(dynamic_cast<simulation::object::Planet*>(object), transform);
-	else if (object_type == typeid(simulation::object::OrbitalSystem))
-		render(dynamic_cast<simulation::object::OrbitalSystem*>(object), transform);
+void SpaceRenderer::submit(const RenderQueue& queue) {
+	if (queue.size() == 0)
+		return;
+
+	glm::mat4 view_projection{ projection_ * view_ };
+	glm::vec3 camera_position{ camera_state_.position };
+
+	unsigned int current_shader{ std::numeric_limits<unsigned int>::max() };
+	simulation::object::model::Mesh* current_mesh{ nullptr };
+	for (std::size_t i = 0; i < queue.size(); i++) {
+		const RenderItem& item{ queue.at(i) };
+		unsigned int shader{ queue.getShader(i) };
+
+		if (shader != current_shader) {
+			current_shader = shader;
+			if (shader == kTerrainShader) {
+				terrain_shader_->use();
+				terrain_shader_->setUniform(view_projection, "VP");
+				terrain_shader_->setUniform(glm::vec3(0.0f, 0.0f, 0.0f), "light_position");
+				terrain_shader_->setUniform(camera_position, "camera_position");
+				terrain_shader_->setUniform(0.5f * render_height_ * projection_[1][1], "pixel_scale");
+				glPatchParameteri(GL_PATCH_VERTICES, 3);
+			} else {
+				shader_->use();
+				shader_->setUniform(glm::vec3(0.0f, 0.0f, 0.0f), "light_position");
+				shader_->setUniform(camera_position, "camera_position");
+			}
+		}
+
+		if (item.mesh != current_mesh) {
+			current_mesh = item.mesh;
+			current_mesh->bind();
+		}
+
+		if (shader == kTerrainShader) {
+			terrain_shader_->setUniform(item.model, "model");
+			terrain_shader_->setUniform(item.terrain_offset, "terrain_offset");
+			terrain_shader_->setUniform(item.roughness, "roughness");
+			terrain_shader_->setUniform(item.color, "color");
+			terrain_shader_->setUniform(item.is_sun, "is_sun");
+		} else {
+			shader_->setUniform(item.model, "model");
+			shader_->setUniform(view_projection * item.model, "MVP");
+			shader_->setUniform(item.color, "color");
+			shader_->setUniform(item.is_sun, "is_sun");
+		}
+
+		current_mesh->draw(item.primitive_type);
+	}
+
+	current_mesh->unbind();
+	shader_->use();
+}
+
+void SpaceRenderer::setFrameBuffer(render::FrameBuffer* frame_buffer) {
+	frame_buffer_ = frame_buffer;
+}
+
+render::FrameBuffer* SpaceRenderer::getFrameBuffer() {
+	return frame_buffer_;
+}
+
+void SpaceRenderer::setFrameCapture(render::FrameCapture* frame_capture) {
+	frame_capture_ = frame_capture;
+}
+
+render::FrameCapture* SpaceRenderer::getFrameCapture() {
+	return frame_capture_;
+}
+
+void SpaceRenderer::setFramePrepared(std::function<void(void)> frame_prepared) {
+	frame_prepared_ = frame_prepared;
+}
+
+render::LatencyMeter* SpaceRenderer::getLatencyMeter() {
+	return latency_meter_;
+}
+
+void SpaceRenderer::setTessellateTerrain(bool tessellate_terrain) {
+	tessellate_terrain_ = tessellate_terrain;
+}
+
+bool SpaceRenderer::getTessellateTerrain() {
+	return tessellate_terrain_;
+}
+
+void SpaceRenderer::setBakeSky(bool bake_sky) {
+	bake_sky_ = bake_sky;
+	star_skybox_->invalidate();
+}
+
+bool SpaceRenderer::getBakeSky() {
+	return bake_sky_;
+}
+
+void SpaceRenderer::setUseImpostors(bool use_impostors) {
+	use_impostors_ = use_impostors;
+}
+
+bool SpaceRenderer::getUseImpostors() {
+	return use_impostors_;
 }
 
 bool SpaceRenderer::showOrbits() {
@@ -272,5 +538,14 @@ bool SpaceRenderer::getShowOrbits() {
 	return show_orbits_;
 }
 
+SpaceRenderer::~SpaceRenderer() {
+	delete orbit_renderer_;
+	delete terrain_shader_;
+	delete stars_shader_;
+	delete star_skybox_;
+	delete impostor_renderer_;
+	delete latency_meter_;
+}
+
 } // namespace render
 } // namespace wanderers
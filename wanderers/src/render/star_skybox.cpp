@@ -0,0 +1,139 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the StarSkybox class.                                   *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "render/star_skybox.h"
+
+/* External Includes */
+#include "glad/gl.h"
+#include "glm/ext.hpp"
+
+/* Internal Includes */
+#include "render/gl_state.h"
+
+/* STL Includes */
+#include <iostream>
+
+namespace wanderers {
+namespace render {
+
+/* Direction and up vector of each cubemap face, in the order of GL_TEXTURE_CUBE_MAP_POSITIVE_X and onwards. */
+static const glm::vec3 kFaceDirections[6]{ { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f },
+                                           { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f } };
+static const glm::vec3 kFaceUps[6]{ { 0.0f, -1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f },
+                                    { 0.0f, 0.0f, -1.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f } };
+
+/*
+ * StarSkybox Constructor:
+ * - Create and link the skybox shader.
+ * - Generate the cubemap texture with storage for each face.
+ * - Generate the framebuffer the faces are rendered through.
+ * - Generate the empty VAO of the full-screen pass.
+ */
+StarSkybox::StarSkybox(int face_size)
+	: shader_{ new shader::ShaderProgram{"shaders/skybox_vertex.glsl", "shaders/skybox_fragment.glsl"} },
+	  face_size_{ face_size }, cubemap_{ 0 }, FBO_{ 0 }, VAO_{ 0 },
+	  baked_{ false }, baked_position_{ 0.0f }, baked_field_of_view_{ 0.0f }, bake_count_{ 0 } {
+	shader_->link();
+
+	glGenTextures(1, &cubemap_);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap_);
+	glTexStorage2D(GL_TEXTURE_CUBE_MAP, 1, GL_RGBA8, face_size_, face_size_);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+	glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+
+	glGenFramebuffers(1, &FBO_);
+	glGenVertexArrays(1, &VAO_);
+}
+
+/*
+ * StarSkybox needsBake:
+ * - Bake if not baked or the field of view, and so the size of the stars, changed.
+ * - Bake if the closest stars have moved more than a texel since the last bake.
+ *   Stars at distance d move 1/d of the camera movement, seen from unit distance.
+ */
+bool StarSkybox::needsBake(glm::vec3 camera_position, float field_of_view, float min_distance) {
+	if (!baked_ || field_of_view != baked_field_of_view_)
+		return true;
+	const float texel_angle{ glm::half_pi<float>() / face_size_ };
+	return glm::length(camera_position - baked_position_) / min_distance > texel_angle;
+}
+
+/*
+ * StarSkybox bake:
+ * - Bind the framebuffer and set the viewport to the face size.
+ * - For each face:
+ *   - Attach the face and clear it.
+ *   - Render the stars with a 90 degree projection looking through the face.
+ * - Store the camera position and field of view of the bake.
+ */
+void StarSkybox::bake(glm::vec3 camera_position, float field_of_view, std::function<void(glm::mat4 view, glm::mat4 projection)> render_face) {
+	glBindFramebuffer(GL_FRAMEBUFFER, FBO_);
+	glViewport(0, 0, face_size_, face_size_);
+
+	const glm::mat4 projection{ glm::perspective(glm::half_pi<float>(), 1.0f, 0.01f, 1000.0f) };
+	for (int face = 0; face < 6; face++) {
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, cubemap_, 0);
+		if (face == 0 && glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+			std::cout << "Error: Skybox framebuffer is not complete." << std::endl;
+			return;
+		}
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		render_face(glm::lookAt(camera_position, camera_position + kFaceDirections[face], kFaceUps[face]), projection);
+	}
+
+	baked_ = true;
+	baked_position_ = camera_position;
+	baked_field_of_view_ = field_of_view;
+	bake_count_++;
+}
+
+/*
+ * StarSkybox draw:
+ * - Calculate the inverse of the projection with the rotation of the view, mapping the screen to directions.
+ * - Draw a full-screen triangle sampling the cubemap, without depth so it is behind everything.
+ */
+void StarSkybox::draw(glm::mat4 view, glm::mat4 projection) {
+	shader_->use();
+	shader_->setUniform(glm::inverse(projection * glm::mat4{ glm::mat3{ view } }), "inverse_view_projection");
+	shader_->setUniform(0, "sky");
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap_);
+	GLState::getGLState()->bindVertexArray(VAO_);
+
+	GLState::getGLState()->disable(GL_DEPTH_TEST);
+	GLState::getGLState()->depthMask(false);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	GLState::getGLState()->depthMask(true);
+	GLState::getGLState()->enable(GL_DEPTH_TEST);
+
+	GLState::getGLState()->bindVertexArray(0);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+}
+
+void StarSkybox::invalidate() { baked_ = false; }
+
+int StarSkybox::getFaceSize() { return face_size_; }
+
+int StarSkybox::getBakeCount() { return bake_count_; }
+
+StarSkybox::~StarSkybox() {
+	GLState::getGLState()->releaseVertexArray(VAO_);
+	glDeleteVertexArrays(1, &VAO_);
+	glDeleteFramebuffers(1, &FBO_);
+	glDeleteTextures(1, &cubemap_);
+	delete shader_;
+}
+
+} // namespace render
+} // namespace wanderers
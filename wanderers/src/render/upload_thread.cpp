@@ -0,0 +1,235 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the UploadThread class.                                 *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "render/upload_thread.h"
+
+/* External Includes */
+#include "glad/gl.h"
+
+/* STL Includes */
+#include <cstring>
+#include <iostream>
+
+namespace wanderers {
+namespace render {
+
+/* The upload thread singleton. */
+static UploadThread* upload_thread_singleton{ nullptr };
+
+/*
+ * UploadThread initUploadThread:
+ * - Create the upload thread singleton if not created.
+ * - If the shared context could not be created, destroy it again so buffers are uploaded by the render thread.
+ */
+void UploadThread::initUploadThread(GLFWwindow* window) {
+	if (upload_thread_singleton == nullptr) {
+		upload_thread_singleton = new UploadThread{ window };
+		if (upload_thread_singleton->upload_window_ == nullptr)
+			deinitUploadThread();
+	}
+}
+
+/*
+ * UploadThread deinitUploadThread:
+ * - Destroy the upload thread singleton if it exists.
+ */
+void UploadThread::deinitUploadThread() {
+	if (upload_thread_singleton != nullptr) {
+		delete upload_thread_singleton;
+		upload_thread_singleton = nullptr;
+	}
+}
+
+UploadThread* UploadThread::getUploadThread() {
+	return upload_thread_singleton;
+}
+
+/*
+ * UploadThread Constructor:
+ * - Create a hidden window sharing objects with the window, with the same context hints.
+ * - Start the upload thread if the window was created.
+ */
+UploadThread::UploadThread(GLFWwindow* window)
+	: upload_window_{ nullptr }, upload_thread_{}, requests_{}, should_stop_{ false }, staging_buffer_{ 0 },
+	  staging_data_{ nullptr }, staging_head_{ 0 }, staging_regions_{}, uploaded_bytes_{ 0 } {
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	upload_window_ = glfwCreateWindow(1, 1, "Wanderers Upload", nullptr, window);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+	if (upload_window_ == nullptr) {
+		std::cout << "Error: Could not create the shared context of the upload thread." << std::endl;
+		return;
+	}
+
+	upload_thread_ = std::thread{ &UploadThread::runUploader, this };
+}
+
+std::shared_ptr<UploadRequest> UploadThread::upload(std::vector<unsigned char> data) {
+	std::shared_ptr<UploadRequest> request{ std::make_shared<UploadRequest>() };
+	request->data = std::move(data);
+	request->issued = false;
+	request->buffer = 0;
+	request->fence = nullptr;
+	{
+		std::lock_guard<std::mutex> guard{ mutex_ };
+		requests_.push_back(request);
+	}
+	request_condition_.notify_one();
+	return request;
+}
+
+/*
+ * UploadThread poll:
+ * - If the copy is issued, check its fence without waiting.
+ * - Delete the fence when signaled.
+ */
+bool UploadThread::poll(UploadRequest& request) {
+	if (!request.issued)
+		return false;
+	if (request.fence == nullptr)
+		return true;
+
+	GLenum status{ glClientWaitSync(static_cast<GLsync>(request.fence), 0, 0) };
+	if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+		return false;
+
+	glDeleteSync(static_cast<GLsync>(request.fence));
+	request.fence = nullptr;
+	return true;
+}
+
+/*
+ * UploadThread wait:
+ * - Wait for the copy to be issued, it is if the thread is stopped.
+ * - Wait for its fence and delete it.
+ */
+void UploadThread::wait(UploadRequest& request) {
+	UploadThread* upload_thread{ getUploadThread() };
+	if (!request.issued && upload_thread != nullptr) {
+		std::unique_lock<std::mutex> lock{ upload_thread->mutex_ };
+		upload_thread->issued_condition_.wait(lock, [&request]() { return request.issued.load(); });
+	}
+	if (request.fence == nullptr)
+		return;
+
+	glClientWaitSync(static_cast<GLsync>(request.fence), GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+	glDeleteSync(static_cast<GLsync>(request.fence));
+	request.fence = nullptr;
+}
+
+std::size_t UploadThread::getUploadedBytes() {
+	std::lock_guard<std::mutex> guard{ mutex_ };
+	return uploaded_bytes_;
+}
+
+/*
+ * UploadThread runUploader:
+ * - Make the shared context current and create the persistently mapped staging buffer.
+ * - Until stopped and all requests are uploaded:
+ *   - Wait for a request.
+ *   - Upload it without holding the lock.
+ *   - Mark it as issued.
+ * - Wait for the copies in flight and delete the staging buffer.
+ */
+void UploadThread::runUploader() {
+	glfwMakeContextCurrent(upload_window_);
+
+	const GLbitfield map_flags{ GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT };
+	glCreateBuffers(1, &staging_buffer_);
+	glNamedBufferStorage(staging_buffer_, static_cast<GLsizeiptr>(kStagingSize), nullptr, map_flags);
+	staging_data_ = static_cast<unsigned char*>(glMapNamedBufferRange(staging_buffer_, 0, static_cast<GLsizeiptr>(kStagingSize), map_flags));
+
+	std::unique_lock<std::mutex> lock{ mutex_ };
+	while (true) {
+		request_condition_.wait(lock, [this]() { return should_stop_ || !requests_.empty(); });
+		if (requests_.empty())
+			break;
+
+		std::shared_ptr<UploadRequest> request{ requests_.front() };
+		requests_.pop_front();
+		lock.unlock();
+
+		uploadRequest(*request);
+
+		lock.lock();
+		uploaded_bytes_ += request->data.size();
+		// The data is in the buffer, only the fence is used from now on.
+		std::vector<unsigned char>{}.swap(request->data);
+		request->issued = true;
+		issued_condition_.notify_all();
+	}
+	lock.unlock();
+
+	for (StagingRegion& region : staging_regions_) {
+		glClientWaitSync(static_cast<GLsync>(region.fence), GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+		glDeleteSync(static_cast<GLsync>(region.fence));
+	}
+	staging_regions_.clear();
+	glUnmapNamedBuffer(staging_buffer_);
+	glDeleteBuffers(1, &staging_buffer_);
+
+	glfwMakeContextCurrent(nullptr);
+}
+
+/*
+ * UploadThread uploadRequest:
+ * - Create the buffer with immutable storage.
+ * - If the data is larger than the staging ring, let the driver copy it.
+ * - Otherwise:
+ *   - Place the data after the last region, or at the start of the ring if it does not fit.
+ *   - Wait for the copies from the regions it overlaps.
+ *   - Write it into the mapping and copy it into the buffer on the GPU, fencing the region.
+ * - Fence the request and flush, so the fence signals for the render thread.
+ */
+void UploadThread::uploadRequest(UploadRequest& request) {
+	const std::size_t size{ request.data.size() };
+
+	glCreateBuffers(1, &request.buffer);
+	if (size > kStagingSize || staging_data_ == nullptr) {
+		glNamedBufferStorage(request.buffer, static_cast<GLsizeiptr>(size), request.data.data(), 0);
+	} else {
+		glNamedBufferStorage(request.buffer, static_cast<GLsizeiptr>(size), nullptr, 0);
+
+		std::size_t offset{ staging_head_ };
+		if (offset + size > kStagingSize)
+			offset = 0;
+		while (!staging_regions_.empty() && staging_regions_.front().begin < offset + size && offset < staging_regions_.front().end) {
+			GLsync region_fence{ static_cast<GLsync>(staging_regions_.front().fence) };
+			glClientWaitSync(region_fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+			glDeleteSync(region_fence);
+			staging_regions_.pop_front();
+		}
+
+		std::memcpy(staging_data_ + offset, request.data.data(), size);
+		glCopyNamedBufferSubData(staging_buffer_, request.buffer, static_cast<GLintptr>(offset), 0, static_cast<GLsizeiptr>(size));
+		staging_regions_.push_back({ offset, offset + size, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+		staging_head_ = offset + size;
+	}
+
+	request.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glFlush();
+}
+
+/*
+ * UploadThread Destructor:
+ * - Stop the thread after the queued requests are uploaded and wait for it to finish.
+ * - Destroy the hidden window.
+ */
+UploadThread::~UploadThread() {
+	{
+		std::lock_guard<std::mutex> guard{ mutex_ };
+		should_stop_ = true;
+	}
+	request_condition_.notify_all();
+	if (upload_thread_.joinable())
+		upload_thread_.join();
+
+	if (upload_window_ != nullptr)
+		glfwDestroyWindow(upload_window_);
+}
+
+} // namespace render
+} // namespace wanderers
@@ -19,6 +19,8 @@
 /* STL Includes */
 #include <random>
 #include <chrono>
+#include <functional>
+#include <thread>
 #include <typeinfo>
 #include <iostream>
 
@@ -26,8 +28,13 @@ namespace wanderers {
 namespace simulation {
 namespace generator {
 
-/* Random generator with seed set as the time of execution. */
-static std::default_random_engine randomizer( std::chrono::system_clock::now().time_since_epoch().count());
+/* Random generator of each thread with seed set as the time of execution and the thread, as systems are generated on workers. */
+static thread_local std::default_random_engine randomizer(
+	std::chrono::system_clock::now().time_since_epoch().count() + std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+void seedRandomizer(unsigned int seed) {
+	randomizer.seed(seed);
+}
 
 float calcRotationalAxisAngle(float distr) {
 	return 170.0f * pow(distr, 80.0f) + 10.0f * pow(distr, 2.0f);
@@ -185,16 +192,17 @@ object::Orbit* generateOrbit(float lower_radius, float upper_radius, float veloc
  * - Generate the physical object.
  * - Generate the object parameters: Radius.
  * - Generate the astronomical object: Rotational parameters.
- * - Generate the planet with random color.
+ * - Generate the planet with random color and terrain.
  */
 object::Planet* generatePlanet(float radius) {
 	std::uniform_real_distribution<float> color(0.0f, 1.0f);
 	std::uniform_real_distribution<float> roughness(0.0f, 1.0f);
+	std::uniform_int_distribution<unsigned int> terrain_seed{};
 	std::uniform_real_distribution<float> angle(-360.0f, 360.0f);
 	std::uniform_real_distribution<float> angular_velocity(-360.0f, 360.0f);
 
 	// planet physical object
-	object::AggregateObject* physical_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+	object::AggregateObject* physical_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 	// planet
 	object::AbstractObject abstract_object{ object::AbstractObject::kOrigo, object::AbstractObject::kUp,
@@ -202,7 +210,8 @@ object::Planet* generatePlanet(float radius) {
 
 	object::AstronomicalObject astronomical_object{ abstract_object, physical_object, angle(randomizer), angular_velocity(randomizer),
 											 generateRotationalAxis(), object::AbstractObject::kFace };
-	object::Planet* planet = new object::Planet{ astronomical_object, glm::vec3{ color(randomizer), color(randomizer), color(randomizer) } };
+	object::Planet* planet = new object::Planet{ astronomical_object, glm::vec3{ color(randomizer), color(randomizer), color(randomizer) },
+												 roughness(randomizer), terrain_seed(randomizer) };
 
 	return planet;
 }
@@ -233,7 +242,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 	// MERCURY
 	{
 		// planet physical object
-		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 		// planet
 		float planet_radius{ 0.25f };
@@ -265,7 +274,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 
 	{
 		// planet physical object
-		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 
 		// planet
@@ -300,7 +309,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		object::OrbitalSystem* planet_system = new object::OrbitalSystem{};
 
 		// planet physical object
-		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 		// planet
 		float planet_radius{ 0.65f };
@@ -319,7 +328,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		// MOON
 		{
 			// planet physical object
-			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 			// planet
 			float planet_radius{ 0.17f };
@@ -369,7 +378,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		object::OrbitalSystem* planet_system = new object::OrbitalSystem{};
 
 		// planet physical object
-		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 		// planet
 		float planet_radius{ 0.34f };
@@ -388,7 +397,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		// PHOBOS
 		{
 			// planet physical object
-			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 			// planet
 			float planet_radius{ 0.05f };
@@ -420,7 +429,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		// DEIMOS
 		{
 			// planet physical object
-			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 			// planet
 			float planet_radius{ 0.025f };
@@ -468,7 +477,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		object::OrbitalSystem* planet_system = new object::OrbitalSystem{ };
 
 		// planet physical object
-		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 		// planet
 		float planet_radius{ 3.0f };
@@ -488,7 +497,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		// IO
 		{
 			// planet physical object
-			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 			// planet
 			float planet_radius{ 0.18f };
@@ -520,7 +529,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		// EUROPA
 		{
 			// planet physical object
-			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 			// planet
 			float planet_radius{ 0.15f };
@@ -552,7 +561,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		// GANYMEDE
 		{
 			// planet physical object
-			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 			// planet
 			float planet_radius{ 0.26f };
@@ -584,7 +593,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		// CALLISTO
 		{
 			// planet physical object
-			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 			// planet
 			float planet_radius{ 0.26f };
@@ -633,7 +642,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		object::OrbitalSystem* planet_system = new object::OrbitalSystem{ };
 
 		// planet physical object
-		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 		// planet
 		float planet_radius{ 2.0f };
@@ -653,7 +662,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		// MIMAS
 		{
 			// planet physical object
-			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 			// planet
 			float planet_radius{ 0.02f };
@@ -685,7 +694,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		// Enceladus
 		{
 			// planet physical object
-			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 			// planet
 			float planet_radius{ 0.025f };
@@ -717,7 +726,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		// TETHYS
 		{
 			// planet physical object
-			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 			// planet
 			float planet_radius{ 0.053f };
@@ -749,7 +758,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		// DIONE
 		{
 			// planet physical object
-			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 			// planet
 			float planet_radius{ 0.056f };
@@ -781,7 +790,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		// RHEA
 		{
 			// planet physical object
-			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 			// planet
 			float planet_radius{ 0.076f };
@@ -813,7 +822,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		// TITAN
 		{
 			// planet physical object
-			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 			// planet
 			float planet_radius{ 0.26f };
@@ -845,7 +854,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		// IAPETUS
 		{
 			// planet physical object
-			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 			// planet
 			float planet_radius{ 0.073f };
@@ -896,7 +905,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 	object::OrbitalSystem* planet_system = new object::OrbitalSystem{ };
 
 	// planet physical object
-	object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+	object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 	// planet
 	float planet_radius{ 1.3f };
@@ -916,7 +925,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 	// MIRANDA
 	{
 		// planet physical object
-		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 		// planet
 		float planet_radius{ 0.024f };
@@ -948,7 +957,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 	// ARIEL
 	{
 		// planet physical object
-		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 		// planet
 		float planet_radius{ 0.058f };
@@ -980,7 +989,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 	// UMBRIEL
 	{
 		// planet physical object
-		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 		// planet
 		float planet_radius{ 0.059f };
@@ -1012,7 +1021,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 	// TITANIA
 	{
 		// planet physical object
-		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 		// planet
 		float planet_radius{ 0.079f };
@@ -1044,7 +1053,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 	// OBERON
 	{
 		// planet physical object
-		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 		// planet
 		float planet_radius{ 0.076f };
@@ -1093,7 +1102,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 	object::OrbitalSystem* planet_system = new object::OrbitalSystem{ };
 
 	// planet physical object
-	object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+	object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 	// planet
 	float planet_radius{ 1.3f };
@@ -1113,7 +1122,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 	// TRITON
 	{
 		// planet physical object
-		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 		// planet
 		float planet_radius{ 0.14f };
@@ -1162,7 +1171,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		object::OrbitalSystem* planet_system = new object::OrbitalSystem{ };
 
 		// planet physical object
-		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+		object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 		// planet
 		float planet_radius{ 0.12f };
@@ -1198,7 +1207,7 @@ object::OrbitalSystem* generateTheSolarSystem() {
 		// CHARON
 		{
 			// planet physical object
-			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getDefaultSurface() } } };
+			object::AggregateObject* planet_object{ new object::AggregateObject{ new object::Object{ object::model::getCoarseIcosahedron() } } };
 
 			// planet
 			float planet_radius{ 0.06f };
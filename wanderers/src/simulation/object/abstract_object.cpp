@@ -69,11 +69,15 @@ glm::mat4 AbstractObject::getMatrix() {
 	glm::mat4 translation_matrix{ glm::translate(glm::mat4{1.0f}, position_) };
 	glm::mat4 scale_matrix{ glm::scale(glm::mat4{1.0f}, scale_)};
 	
-	return translation_matrix * scale_matrix * orientation_.orientationMatrix(common::kYOrientation);
+	return translation_matrix * scale_matrix * orientation_.orientationMatrix();
 }
 
 void AbstractObject::elapseTime(double seconds) {}
 
+void AbstractObject::setTime(double time, double seconds) {}
+
+void AbstractObject::interpolate(float alpha) {}
+
 } // namespace object
 } // namespace simulation
 } // namespace wanderers
@@ -43,6 +43,14 @@ void AggregateObject::elapseTime(double seconds) {
 	std::for_each(objects_.begin(), objects_.end(), [seconds](std::pair<Object*, glm::vec3> current_object) { current_object.first->elapseTime(seconds); });
 }
 
+void AggregateObject::setTime(double time, double seconds) {
+	std::for_each(objects_.begin(), objects_.end(), [time, seconds](std::pair<Object*, glm::vec3> current_object) { current_object.first->setTime(time, seconds); });
+}
+
+void AggregateObject::interpolate(float alpha) {
+	std::for_each(objects_.begin(), objects_.end(), [alpha](std::pair<Object*, glm::vec3> current_object) { current_object.first->interpolate(alpha); });
+}
+
 } // namespace object
 } // namespace simulation
 } // namespace wanderers
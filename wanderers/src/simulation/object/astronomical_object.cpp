@@ -15,19 +15,24 @@
 
 /* STL Includes */
 #include <algorithm>
+#include <cmath>
 
 namespace wanderers {
 namespace simulation {
 namespace object {
 
+const AstronomicalObject kAbstractAstronomicalObject{ kDefaultObject, new AggregateObject{kDefaultAggregate} };
+
 AstronomicalObject::AstronomicalObject(AbstractObject abstract_object, AggregateObject* physical_object) 
 	: AstronomicalObject{abstract_object, physical_object, 0.0f, 0.0f, kUp, kFace} {}
 
 AstronomicalObject::AstronomicalObject(AbstractObject abstract_object, AggregateObject* physical_object, 
 									   float rotational_angle, float angular_velocity, 
 									   glm::vec3 rotational_axis, glm::vec3 rotational_face)
-	: AbstractObject{ abstract_object }, physical_object_{ physical_object }, 
-	  rotational_angle_{ rotational_angle }, angular_velocity_{ angular_velocity },
+	: AbstractObject{ abstract_object }, time_{ 0.0 }, physical_object_{ physical_object }, 
+	  rotational_angle_{ rotational_angle }, previous_rotational_angle_{ rotational_angle },
+	  interpolated_rotational_angle_{ rotational_angle }, angular_velocity_{ angular_velocity },
+	  rotational_epoch_{ rotational_angle },
 	  rotational_orientation_{rotational_axis, rotational_face},
 	  parent_{nullptr} {}
 
@@ -65,14 +70,22 @@ glm::vec3 AstronomicalObject::getRotationalSide() const {
 }
 
 void AstronomicalObject::setRotationalAngle(float rotational_angle) {
+	rotational_epoch_ = rotational_angle - angular_velocity_ * time_;
 	rotational_angle_ = rotational_angle;
+	previous_rotational_angle_ = rotational_angle;
+	interpolated_rotational_angle_ = rotational_angle;
 }
 
 float AstronomicalObject::getRotationalAngle() {
 	return rotational_angle_;
 }
 
+float AstronomicalObject::getInterpolatedRotationalAngle() {
+	return interpolated_rotational_angle_;
+}
+
 void AstronomicalObject::setAngularVelocity(float angular_velocity) {
+	rotational_epoch_ += (static_cast<double>(angular_velocity_) - angular_velocity) * time_;
 	angular_velocity_ = angular_velocity;
 }
 
@@ -89,7 +102,7 @@ AstronomicalObject* AstronomicalObject::getParent() const {
 }
 
 glm::mat4 AstronomicalObject::getRotationalMatrix() {
-	return glm::rotate(glm::mat4{ 1.0f }, glm::radians(rotational_angle_), getRotationalAxis());
+	return glm::rotate(glm::mat4{ 1.0f }, glm::radians(interpolated_rotational_angle_), getRotationalAxis());
 }
 
 glm::mat4 AstronomicalObject::getPhysicalMatrix() {
@@ -100,19 +113,50 @@ glm::mat4 AstronomicalObject::getMatrix() {
 	return getRotationalMatrix() * getPhysicalMatrix();
 }
 
+void AstronomicalObject::elapseTime(double seconds) {
+	setTime(time_ + seconds, seconds);
+}
+
 /*
- * AstronomicalObject elapseTime:
- * - Increase rotational angle according to the velocity and time passed.
- * - Elapse time for the contained physical object.
+ * AstronomicalObject setTime:
+ * - Derive the rotational angles at the time and the step before from the angle at time zero, in double.
+ *   Accumulating the angle step by step would make it differ with the number of steps taken to the time.
+ * - Set the time for the contained physical object.
  */
-void AstronomicalObject::elapseTime(double seconds) {
-	rotational_angle_ += angular_velocity_ * seconds;
-	rotational_angle_ = fmod(rotational_angle_, 360.0f);
+void AstronomicalObject::setTime(double time, double seconds) {
+	previous_rotational_angle_ = rotationalAngleAt(time - seconds);
+	rotational_angle_ = rotationalAngleAt(time);
+	time_ = time;
 	if (physical_object_ != nullptr) {
-		physical_object_->elapseTime(seconds);
+		physical_object_->setTime(time, seconds);
 	}
 }
 
+float AstronomicalObject::rotationalAngleAt(double time) {
+	return static_cast<float>(std::fmod(rotational_epoch_ + angular_velocity_ * time, 360.0));
+}
+
+void AstronomicalObject::interpolate(float alpha) {
+	interpolated_rotational_angle_ = interpolateAngle(previous_rotational_angle_, rotational_angle_, alpha);
+	if (physical_object_ != nullptr) {
+		physical_object_->interpolate(alpha);
+	}
+}
+
+/*
+ * AstronomicalObject interpolateAngle:
+ * - Take the difference the shortest way around, assuming less than half a revolution per step.
+ * - Move the fraction of it from the previous angle.
+ */
+float AstronomicalObject::interpolateAngle(float previous_angle, float current_angle, float alpha) {
+	float difference{ current_angle - previous_angle };
+	if (difference > 180.0f)
+		difference -= 360.0f;
+	else if (difference < -180.0f)
+		difference += 360.0f;
+	return previous_angle + alpha * difference;
+}
+
 } // namespace object
 } // namespace simulation
 } // namespace wanderers
@@ -0,0 +1,210 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the BodyTransforms class.                               *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "simulation/object/body_transforms.h"
+
+/* External Includes */
+#include "glm/gtc/constants.hpp"
+
+/* Internal Includes */
+#include "simulation/object/astronomical_object.h"
+#include "simulation/object/orbit.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WANDERERS_BODY_TRANSFORMS_SSE2
+#include <emmintrin.h>
+#endif
+
+/* STL Includes */
+#include <algorithm>
+#include <cmath>
+
+namespace wanderers {
+namespace simulation {
+namespace object {
+
+BodyTransforms::BodyTransforms() : count_{ 0 }, stride_{ 0 }, arrays_{}, matrices_{} {}
+
+float* BodyTransforms::getArray(int array) {
+	return arrays_.data() + array * stride_;
+}
+
+/*
+ * BodyTransforms build:
+ * - Size the arrays for the bodies rounded up to a group of four, the padding bodies are all zero.
+ * - For each body:
+ *   - The orbit matrix is the orbital rotation O, and a translation of O (b sin(angle), 0, a cos(angle) - c)
+ *     where b is the minor axis, a the major axis and c the distance of the focus from the center.
+ *   - The rotation of the body around the unit axis n is n n^T + cos(angle) (I - n n^T) + sin(angle) [n]x,
+ *     each part is multiplied by O and the fixed matrix of the body.
+ *   - Store the parts in the arrays.
+ */
+void BodyTransforms::build(const std::vector<std::pair<AstronomicalObject*, Orbit*>>& orbits) {
+	count_ = orbits.size();
+	stride_ = (count_ + 3) / 4 * 4;
+	arrays_.assign(kArrayCount * stride_, 0.0f);
+	matrices_.assign(stride_, glm::mat3x4{ 0.0f });
+
+	for (std::size_t i = 0; i < count_; i++) {
+		Orbit* orbit{ orbits[i].second };
+		AstronomicalObject* object{ orbits[i].first };
+
+		const glm::mat3 orbital_rotation{ orbit->getOrbitalRotation() };
+		const float minor_axis{ orbit->getMinorAxis() };
+		const float normalized_major{ minor_axis > 0.00001f ? orbit->getMajorAxis() / minor_axis : 1.0f };
+		const float focus_point{ std::sqrt(std::max(normalized_major * normalized_major - 1.0f, 0.0f)) };
+		const glm::vec3 orbit_sin{ orbital_rotation[0] * minor_axis };
+		const glm::vec3 orbit_cos{ orbital_rotation[2] * (minor_axis * normalized_major) };
+		const glm::vec3 orbit_focus{ orbital_rotation[2] * (minor_axis * focus_point) };
+
+		const glm::vec3 axis{ glm::normalize(object->getRotationalAxis()) };
+		const glm::mat3 aligned{ glm::outerProduct(axis, axis) };
+		const glm::mat3 cross{ 0.0f, axis.z, -axis.y, -axis.z, 0.0f, axis.x, axis.y, -axis.x, 0.0f };
+		const glm::mat4 body_matrix{ object->getPhysicalMatrix() };
+		const glm::mat4 parts[3]{ glm::mat4{ orbital_rotation * aligned } * body_matrix,
+		                          glm::mat4{ orbital_rotation * (glm::mat3{ 1.0f } - aligned) } * body_matrix,
+		                          glm::mat4{ orbital_rotation * cross } * body_matrix };
+		const int part_arrays[3]{ kRotationAligned, kRotationCos, kRotationSin };
+
+		for (int part = 0; part < 3; part++) {
+			for (int row = 0; row < 3; row++) {
+				for (int column = 0; column < 4; column++)
+					getArray(part_arrays[part] + row * 4 + column)[i] = parts[part][column][row];
+			}
+		}
+		for (int row = 0; row < 3; row++) {
+			getArray(kOrbitSin + row)[i] = orbit_sin[row];
+			getArray(kOrbitCos + row)[i] = orbit_cos[row];
+			getArray(kOrbitFocus + row)[i] = orbit_focus[row];
+		}
+	}
+}
+
+std::size_t BodyTransforms::getCount() {
+	return count_;
+}
+
+const glm::mat3x4* BodyTransforms::getMatrices() {
+	return matrices_.data();
+}
+
+glm::mat4 BodyTransforms::toMatrix(const glm::mat3x4& rows) {
+	return glm::transpose(glm::mat4{ rows[0], rows[1], rows[2], glm::vec4{ 0.0f, 0.0f, 0.0f, 1.0f } });
+}
+
+#ifdef WANDERERS_BODY_TRANSFORMS_SSE2
+
+namespace {
+
+/*
+ * Four lane sine and cosine of angles in radians.
+ * The angle is reduced by the nearest multiple of a quarter turn, in three parts to keep the precision,
+ *   and the sine and cosine of the rest are polynomials swapped and negated by the quarter.
+ */
+void sincos4(__m128 x, __m128& sine, __m128& cosine) {
+	const __m128i quarter{ _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(2.0f / glm::pi<float>()))) };
+	const __m128 quarters{ _mm_cvtepi32_ps(quarter) };
+	x = _mm_sub_ps(x, _mm_mul_ps(quarters, _mm_set1_ps(1.5703125f)));
+	x = _mm_sub_ps(x, _mm_mul_ps(quarters, _mm_set1_ps(4.837512969970703125e-4f)));
+	x = _mm_sub_ps(x, _mm_mul_ps(quarters, _mm_set1_ps(7.549789948768648e-8f)));
+
+	const __m128 z{ _mm_mul_ps(x, x) };
+	__m128 sine_poly{ _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(-1.9515295891e-4f)), _mm_set1_ps(8.3321608736e-3f)) };
+	sine_poly = _mm_add_ps(_mm_mul_ps(sine_poly, z), _mm_set1_ps(-1.6666654611e-1f));
+	sine_poly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sine_poly, z), x), x);
+	__m128 cosine_poly{ _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(2.443315711809948e-5f)), _mm_set1_ps(-1.388731625493765e-3f)) };
+	cosine_poly = _mm_add_ps(_mm_mul_ps(cosine_poly, z), _mm_set1_ps(4.166664568298827e-2f));
+	cosine_poly = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_mul_ps(cosine_poly, z), z), _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+	// Odd quarters swap sine and cosine, the sine is negated in the second half turn and the cosine in the middle half.
+	const __m128 swap{ _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quarter, _mm_set1_epi32(1)), _mm_set1_epi32(1))) };
+	const __m128 sine_sign{ _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quarter, _mm_set1_epi32(2)), 30)) };
+	const __m128 cosine_sign{ _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quarter, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30)) };
+	sine = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, cosine_poly), _mm_andnot_ps(swap, sine_poly)), sine_sign);
+	cosine = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, sine_poly), _mm_andnot_ps(swap, cosine_poly)), cosine_sign);
+}
+
+} // namespace
+
+/*
+ * BodyTransforms evaluate:
+ * - Gather the interpolated angles of the bodies.
+ * - For each group of four bodies:
+ *   - Find the sine and cosine of both angles in radians.
+ *   - Sum the parts of each element of the rows weighted by the rotational sine and cosine.
+ *   - Add the translation along the orbit to the last column.
+ *   - Transpose each row from a register per element into a register per body and store it.
+ */
+void BodyTransforms::evaluate(const std::vector<std::pair<AstronomicalObject*, Orbit*>>& orbits) {
+	if (orbits.size() != count_)
+		build(orbits);
+	for (std::size_t i = 0; i < count_; i++) {
+		getArray(kOrbitalAngle)[i] = orbits[i].second->getInterpolatedOrbitalAngle();
+		getArray(kRotationalAngle)[i] = orbits[i].first->getInterpolatedRotationalAngle();
+	}
+
+	const __m128 radians{ _mm_set1_ps(glm::pi<float>() / 180.0f) };
+	for (std::size_t i = 0; i < stride_; i += 4) {
+		__m128 orbit_sine, orbit_cosine, rotation_sine, rotation_cosine;
+		sincos4(_mm_mul_ps(_mm_loadu_ps(getArray(kOrbitalAngle) + i), radians), orbit_sine, orbit_cosine);
+		sincos4(_mm_mul_ps(_mm_loadu_ps(getArray(kRotationalAngle) + i), radians), rotation_sine, rotation_cosine);
+
+		for (int row = 0; row < 3; row++) {
+			__m128 elements[4];
+			for (int column = 0; column < 4; column++) {
+				const int element{ row * 4 + column };
+				elements[column] = _mm_add_ps(_mm_loadu_ps(getArray(kRotationAligned + element) + i),
+				                              _mm_add_ps(_mm_mul_ps(rotation_cosine, _mm_loadu_ps(getArray(kRotationCos + element) + i)),
+				                                         _mm_mul_ps(rotation_sine, _mm_loadu_ps(getArray(kRotationSin + element) + i))));
+			}
+			const __m128 translation{ _mm_sub_ps(_mm_add_ps(_mm_mul_ps(orbit_sine, _mm_loadu_ps(getArray(kOrbitSin + row) + i)),
+			                                                _mm_mul_ps(orbit_cosine, _mm_loadu_ps(getArray(kOrbitCos + row) + i))),
+			                                     _mm_loadu_ps(getArray(kOrbitFocus + row) + i)) };
+			elements[3] = _mm_add_ps(elements[3], translation);
+
+			_MM_TRANSPOSE4_PS(elements[0], elements[1], elements[2], elements[3]);
+			for (int lane = 0; lane < 4; lane++)
+				_mm_storeu_ps(&matrices_[i + lane][row][0], elements[lane]);
+		}
+	}
+}
+
+#else
+
+/*
+ * BodyTransforms evaluate:
+ * - For each body:
+ *   - Find the sine and cosine of its interpolated angles.
+ *   - Sum the parts of each element of the rows weighted by the rotational sine and cosine.
+ *   - Add the translation along the orbit to the last column.
+ */
+void BodyTransforms::evaluate(const std::vector<std::pair<AstronomicalObject*, Orbit*>>& orbits) {
+	if (orbits.size() != count_)
+		build(orbits);
+	for (std::size_t i = 0; i < count_; i++) {
+		const float orbital_angle{ glm::radians(orbits[i].second->getInterpolatedOrbitalAngle()) };
+		const float rotational_angle{ glm::radians(orbits[i].first->getInterpolatedRotationalAngle()) };
+		const float orbit_sine{ std::sin(orbital_angle) }, orbit_cosine{ std::cos(orbital_angle) };
+		const float rotation_sine{ std::sin(rotational_angle) }, rotation_cosine{ std::cos(rotational_angle) };
+
+		for (int row = 0; row < 3; row++) {
+			for (int column = 0; column < 4; column++) {
+				const int element{ row * 4 + column };
+				matrices_[i][row][column] = getArray(kRotationAligned + element)[i] + rotation_cosine * getArray(kRotationCos + element)[i]
+				                            + rotation_sine * getArray(kRotationSin + element)[i];
+			}
+			matrices_[i][row][3] += orbit_sine * getArray(kOrbitSin + row)[i] + orbit_cosine * getArray(kOrbitCos + row)[i]
+			                        - getArray(kOrbitFocus + row)[i];
+		}
+	}
+}
+
+#endif // WANDERERS_BODY_TRANSFORMS_SSE2
+
+} // namespace object
+} // namespace simulation
+} // namespace wanderers
@@ -190,10 +190,12 @@ AstronomicalObject* CameraObject::getCameraFocus() {
     return camera_focus_;
 }
 
-void CameraObject::withMutext(std::function<void(void)> func) {
-    assert(func);
-    std::lock_guard<std::mutex> guard{ camera_object_mutex_ };
-    func();
+void CameraObject::lock() {
+    camera_object_mutex_.lock();
+}
+
+void CameraObject::unlock() {
+    camera_object_mutex_.unlock();
 }
 
 void CameraObject::focus() {
@@ -206,6 +208,10 @@ void CameraObject::focus() {
         setRelativeDirection(-relative_position_);
     }
 }
+
+glm::vec3 CameraObject::getFocusPosition() {
+    return glm::vec3{ getFocusMatrix(camera_focus_) * camera_focus_->getPhysicalMatrix() * glm::vec4{ 0.0f, 0.0f, 0.0f, 1.0f } };
+}
 /*
  * CameraObject modeUpdate.
  * - Set relative position if not set.
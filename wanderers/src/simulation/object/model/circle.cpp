@@ -11,6 +11,9 @@
 #include "glad/gl.h"
 #include "glfw/glfw3.h"
 
+/* Internal Includes */
+#include "simulation/object/model/mesh_registry.h"
+
 namespace wanderers {
 namespace simulation {
 namespace object {
@@ -30,6 +33,10 @@ std::vector<glm::vec3>* Circle::generateCircle(int num_of_points) {
 	return vertices;
 }
 
+MeshHandle getCircle() {
+	return MeshRegistry::getMeshRegistry()->get("circle", []() -> Mesh* { return new Circle{}; });
+}
+
 } // namespace model
 } // namespace object
 } // namespace simulation
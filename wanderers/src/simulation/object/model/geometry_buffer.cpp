@@ -0,0 +1,210 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the GeometryBuffer class.                               *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "simulation/object/model/geometry_buffer.h"
+
+/* External Includes */
+#include "glad/gl.h"
+
+/* Internal Includes */
+#include "render/gl_state.h"
+
+/* STL Includes */
+#include <iostream>
+
+namespace wanderers {
+namespace simulation {
+namespace object {
+namespace model {
+
+VertexLayout::VertexLayout() : attributes_{}, stride_{ 0 } {}
+
+VertexLayout& VertexLayout::add(unsigned int location, AttributeFormat format) {
+	attributes_.push_back(VertexAttribute{ location, format, stride_ });
+	stride_ += formatSize(format);
+	return *this;
+}
+
+const std::vector<VertexAttribute>& VertexLayout::getAttributes() const { return attributes_; }
+
+std::size_t VertexLayout::getStride() const { return stride_; }
+
+std::size_t VertexLayout::formatSize(AttributeFormat format) {
+	switch (format) {
+	case AttributeFormat::Float2:
+		return 2 * sizeof(float);
+	case AttributeFormat::Float3:
+		return 3 * sizeof(float);
+	case AttributeFormat::Float4:
+		return 4 * sizeof(float);
+	case AttributeFormat::HalfFloat4:
+		return 4 * sizeof(unsigned short);
+	case AttributeFormat::Short2:
+		return 2 * sizeof(short);
+	case AttributeFormat::Short4:
+		return 4 * sizeof(short);
+	case AttributeFormat::UnsignedByte4:
+	case AttributeFormat::Int2101010:
+		return 4;
+	}
+	return 0;
+}
+
+/*
+ * setAttributePointer:
+ * - Set the component count, type and normalization of the format for the attribute.
+ */
+static void setAttributePointer(const VertexAttribute& attribute, std::size_t stride) {
+	GLint components{ 4 };
+	GLenum type{ GL_FLOAT };
+	GLboolean normalized{ GL_FALSE };
+	switch (attribute.format) {
+	case AttributeFormat::Float2:
+		components = 2;
+		break;
+	case AttributeFormat::Float3:
+		components = 3;
+		break;
+	case AttributeFormat::Float4:
+		break;
+	case AttributeFormat::HalfFloat4:
+		type = GL_HALF_FLOAT;
+		break;
+	case AttributeFormat::Short2:
+		components = 2;
+		type = GL_SHORT;
+		normalized = GL_TRUE;
+		break;
+	case AttributeFormat::Short4:
+		type = GL_SHORT;
+		normalized = GL_TRUE;
+		break;
+	case AttributeFormat::UnsignedByte4:
+		type = GL_UNSIGNED_BYTE;
+		normalized = GL_TRUE;
+		break;
+	case AttributeFormat::Int2101010:
+		type = GL_INT_2_10_10_10_REV;
+		normalized = GL_TRUE;
+		break;
+	}
+	glVertexAttribPointer(attribute.location, components, type, normalized, static_cast<GLsizei>(stride), 
+	                      reinterpret_cast<void*>(attribute.offset));
+	glEnableVertexAttribArray(attribute.location);
+}
+
+GeometryBuffer::GeometryBuffer(unsigned int primitive_type)
+	: primitive_type_{ primitive_type }, VAO_{ 0 }, vertex_VBOs_{}, index_EBO_{ 0 },
+	  vertex_count_{ 0 }, index_count_{ 0 }, byte_size_{ 0 } {
+	glGenVertexArrays(1, &VAO_);
+}
+
+/*
+ * GeometryBuffer addVertexBuffer:
+ * - Check that the vertex count matches the previous buffers.
+ * - Generate VBO, bind it and upload the vertices.
+ * - Add the buffer.
+ */
+int GeometryBuffer::addVertexBuffer(const VertexLayout& layout, const void* data, std::size_t vertex_count) {
+	if (!vertex_VBOs_.empty() && vertex_count != vertex_count_) {
+		std::cout << "Error: Vertex buffer has " << vertex_count << " vertices, expected " << vertex_count_ << "." << std::endl;
+		return 1;
+	}
+
+	unsigned int VBO{ 0 };
+	glGenBuffers(1, &VBO);
+	render::GLState::getGLState()->bindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(layout.getStride() * vertex_count), data, GL_STATIC_DRAW);
+
+	return addVertexBuffer(layout, VBO, vertex_count);
+}
+
+/*
+ * GeometryBuffer addVertexBuffer uploaded:
+ * - Check that the vertex count matches the previous buffers.
+ * - Bind the VAO and the buffer.
+ * - Point each attribute of the layout into the buffer.
+ */
+int GeometryBuffer::addVertexBuffer(const VertexLayout& layout, unsigned int VBO, std::size_t vertex_count) {
+	if (!vertex_VBOs_.empty() && vertex_count != vertex_count_) {
+		std::cout << "Error: Vertex buffer has " << vertex_count << " vertices, expected " << vertex_count_ << "." << std::endl;
+		return 1;
+	}
+
+	const std::size_t buffer_size{ layout.getStride() * vertex_count };
+
+	render::GLState::getGLState()->bindVertexArray(VAO_);
+	render::GLState::getGLState()->bindBuffer(GL_ARRAY_BUFFER, VBO);
+
+	for (const VertexAttribute& attribute : layout.getAttributes())
+		setAttributePointer(attribute, layout.getStride());
+
+	render::GLState::getGLState()->bindVertexArray(0);
+	render::GLState::getGLState()->bindBuffer(GL_ARRAY_BUFFER, 0);
+
+	vertex_VBOs_.push_back(VBO);
+	vertex_count_ = vertex_count;
+	byte_size_ += buffer_size;
+	return 0;
+}
+
+/*
+ * GeometryBuffer setIndices:
+ * - Generate EBO if not generated, it is stored in the VAO.
+ * - Upload the indices.
+ */
+void GeometryBuffer::setIndices(const std::vector<unsigned int>& indices) {
+	render::GLState::getGLState()->bindVertexArray(VAO_);
+	if (index_EBO_ == 0)
+		glGenBuffers(1, &index_EBO_);
+	render::GLState::getGLState()->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_EBO_);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(unsigned int) * indices.size()), indices.data(), GL_STATIC_DRAW);
+	render::GLState::getGLState()->bindVertexArray(0);
+
+	byte_size_ -= sizeof(unsigned int) * index_count_;
+	index_count_ = indices.size();
+	byte_size_ += sizeof(unsigned int) * index_count_;
+}
+
+std::size_t GeometryBuffer::getVertexCount() { return vertex_count_; }
+
+std::size_t GeometryBuffer::getIndexCount() { return index_count_; }
+
+std::size_t GeometryBuffer::getElementCount() { return index_EBO_ != 0 ? index_count_ : vertex_count_; }
+
+std::size_t GeometryBuffer::getByteSize() { return byte_size_; }
+
+unsigned int GeometryBuffer::getPrimitiveType() { return primitive_type_; }
+
+void GeometryBuffer::bind() { render::GLState::getGLState()->bindVertexArray(VAO_); }
+
+void GeometryBuffer::unbind() { render::GLState::getGLState()->bindVertexArray(0); }
+
+void GeometryBuffer::draw() { draw(primitive_type_); }
+
+void GeometryBuffer::draw(unsigned int primitive_type) {
+	if (index_EBO_ != 0)
+		glDrawElements(primitive_type, static_cast<GLsizei>(index_count_), GL_UNSIGNED_INT, nullptr);
+	else
+		glDrawArrays(primitive_type, 0, static_cast<GLsizei>(vertex_count_));
+}
+
+GeometryBuffer::~GeometryBuffer() {
+	if (index_EBO_ != 0)
+		glDeleteBuffers(1, &index_EBO_);
+	for (unsigned int VBO : vertex_VBOs_)
+		render::GLState::getGLState()->releaseBuffer(VBO);
+	if (!vertex_VBOs_.empty())
+		glDeleteBuffers(static_cast<GLsizei>(vertex_VBOs_.size()), vertex_VBOs_.data());
+	render::GLState::getGLState()->releaseVertexArray(VAO_);
+	glDeleteVertexArrays(1, &VAO_);
+}
+
+} // namespace model
+} // namespace object
+} // namespace simulation
+} // namespace wanderers
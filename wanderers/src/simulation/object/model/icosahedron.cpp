@@ -11,6 +11,9 @@
 #include "glad/gl.h"
 #include "glfw/glfw3.h"
 
+/* Internal Includes */
+#include "simulation/object/model/mesh_registry.h"
+
 namespace wanderers {
 namespace simulation {
 namespace object {
@@ -20,10 +23,13 @@ namespace model {
 
 Icosahedron::Icosahedron() : Icosahedron{ 0 } {}
 
-Icosahedron::Icosahedron(int sub_division_level) : Icosahedron(subDivide(generateIcosahedron(), sub_division_level)) { }
+/* The vertices are on the unit sphere, so the normals are derived from the positions in the shader. */
+Icosahedron::Icosahedron(int sub_division_level) : Icosahedron(subDivide(generateIcosahedron(), sub_division_level), nullptr) { }
 
 Icosahedron::Icosahedron(std::vector<glm::vec3>* vertices) : Mesh(vertices, GL_TRIANGLES) {}
 
+Icosahedron::Icosahedron(std::vector<glm::vec3>* vertices, std::vector<glm::vec3>* normals) : Mesh(vertices, normals, GL_TRIANGLES) {}
+
 // TODO: Make algorithm for generating icosahedron instead of having it hardcoded.
 
 /*
@@ -127,6 +133,7 @@ std::vector<glm::vec3>* Icosahedron::generateIcosahedron() {
  * - If sub division level is not zero.
  *   - Generate four new triangles within the triangle.
  *   - Set the vertices whitin the triangles to be of same distance to origo.
+ *     The middle of an edge does not depend on its direction, so triangles sharing the edge get identical vertices.
  *   - Delete old vertices.
  *   - Call subDivide with a level less.
  * - Return vertices.
@@ -142,13 +149,9 @@ std::vector<glm::vec3>* Icosahedron::subDivide(std::vector<glm::vec3>* vertices,
 			glm::vec3 v2{ vertices->at(i + 1) };
 			glm::vec3 v3{ vertices->at(i + 2) };
 
-			glm::vec3 edge1{ v2 - v1 };
-			glm::vec3 edge2{ v3 - v2 };
-			glm::vec3 edge3{ v1 - v3 };
-
-			glm::vec3 middle1{ glm::normalize(v1 + edge1 / 2.0f) };
-			glm::vec3 middle2{ glm::normalize(v2 + edge2 / 2.0f) };
-			glm::vec3 middle3{ glm::normalize(v3 + edge3 / 2.0f) };
+			glm::vec3 middle1{ glm::normalize((v1 + v2) / 2.0f) };
+			glm::vec3 middle2{ glm::normalize((v2 + v3) / 2.0f) };
+			glm::vec3 middle3{ glm::normalize((v3 + v1) / 2.0f) };
 
 			sub_divided_vertices->at(i * 4) = v1;
 			sub_divided_vertices->at(i * 4 + 1) = middle1;
@@ -172,6 +175,14 @@ std::vector<glm::vec3>* Icosahedron::subDivide(std::vector<glm::vec3>* vertices,
 	return sub_divided_vertices;
 }
 
+MeshHandle getIcosahedron() {
+	return MeshRegistry::getMeshRegistry()->get("icosahedron_3", []() -> Mesh* { return new Icosahedron{ 3 }; });
+}
+
+MeshHandle getCoarseIcosahedron() {
+	return MeshRegistry::getMeshRegistry()->get("icosahedron_1", []() -> Mesh* { return new Icosahedron{ 1 }; });
+}
+
 } // namespace model
 } // namespace object
 } // namespace simulation
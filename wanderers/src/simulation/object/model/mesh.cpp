@@ -10,15 +10,25 @@
 /* External Includes */
 #include "glad/gl.h"
 #include "glfw/glfw3.h"
+#include "glm/gtc/packing.hpp"
 
 /* STL Includes */
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
 
 namespace wanderers {
 namespace simulation {
 namespace object {
 namespace model {
 
+/* Returns the id of the next constructed mesh. Meshes can be constructed on any thread. */
+static unsigned int nextMeshId() {
+	static std::atomic<unsigned int> next_mesh_id{ 1 };
+	return next_mesh_id++;
+}
+
 /*
  * Mesh generateNormals:
  * - Create normals as the same size as the vertices.
@@ -79,58 +89,285 @@ float* Mesh::verticesData() {
 }
 
 float* Mesh::normalsData() {
-	return reinterpret_cast<float*>(&normals_->data()[0]);
+	return normals_ != nullptr ? reinterpret_cast<float*>(&normals_->data()[0]) : nullptr;
 }
 
-int Mesh::size() {
+std::size_t Mesh::count() {
+	return vertices_->size();
+}
+
+std::size_t Mesh::byteSize() {
 	return sizeof(glm::vec3) * vertices_->size();
 }
 
+unsigned int Mesh::getMeshType() { return mesh_type_; }
+
+unsigned int Mesh::getMeshId() { return mesh_id_; }
+
+/* Returns if the vertex format stores normals. */
+static bool hasNormals(Mesh::VertexFormat vertex_format) {
+	return vertex_format == Mesh::VertexFormat::Float || vertex_format == Mesh::VertexFormat::PackedNormal
+	    || vertex_format == Mesh::VertexFormat::HalfPosition;
+}
+
+/*
+ * Mesh setVertexFormat:
+ * - Check that the format can be used, and that no upload is requested.
+ * - If the format encodes directions, set the position scale to the longest position.
+ */
+void Mesh::setVertexFormat(VertexFormat vertex_format) {
+	// The format is read when the upload is requested, which can be on a worker.
+	std::lock_guard<std::mutex> guard{ upload_mutex_ };
+	if (uploaded_ || upload_request_ != nullptr) {
+		std::cout << "Warning: Vertex format set after the mesh is uploaded." << std::endl;
+		return;
+	}
+	if (normals_ == nullptr && hasNormals(vertex_format)) {
+		std::cout << "Warning: Mesh without normals can not use a vertex format with normals." << std::endl;
+		return;
+	}
+	vertex_format_ = vertex_format;
+
+	position_scale_ = 1.0f;
+	if (vertex_format_ == VertexFormat::Direction || vertex_format_ == VertexFormat::DirectionDistance) {
+		position_scale_ = 0.0f;
+		for (const glm::vec3& vertex : *vertices_)
+			position_scale_ = std::max(position_scale_, glm::length(vertex));
+		if (position_scale_ == 0.0f)
+			position_scale_ = 1.0f;
+	}
+}
+
+Mesh::VertexFormat Mesh::getVertexFormat() { return vertex_format_; }
+
+float Mesh::getPositionScale() { return position_scale_; }
+
+/*
+ * Mesh octahedralEncode:
+ * - Project the direction onto the octahedron |x| + |y| + |z| = 1.
+ * - Fold the lower half over the upper half, so it covers the square.
+ */
+glm::vec2 Mesh::octahedralEncode(glm::vec3 direction) {
+	const float length{ std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z) };
+	if (length == 0.0f)
+		return glm::vec2{ 0.0f, 0.0f };
+	direction /= length;
+	glm::vec2 encoded{ direction.x, direction.y };
+	if (direction.z < 0.0f) {
+		encoded = glm::vec2{ (1.0f - std::abs(direction.y)) * (direction.x >= 0.0f ? 1.0f : -1.0f),
+		                     (1.0f - std::abs(direction.x)) * (direction.y >= 0.0f ? 1.0f : -1.0f) };
+	}
+	return encoded;
+}
+
+std::size_t Mesh::getCpuBytes() {
+	std::size_t bytes{ sizeof(glm::vec3) * vertices_->capacity() };
+	if (normals_ != nullptr)
+		bytes += sizeof(glm::vec3) * normals_->capacity();
+	return bytes;
+}
+
+std::size_t Mesh::getGpuBytes() {
+	return uploaded_ ? geometry_buffer_->getByteSize() : 0;
+}
+
+/*
+ * appendAttribute:
+ * - Append the bytes of the attribute to the interleaved vertices.
+ */
+template<typename T>
+static void appendAttribute(std::vector<unsigned char>& interleaved, const T& attribute) {
+	const std::size_t offset{ interleaved.size() };
+	interleaved.resize(offset + sizeof(T));
+	std::memcpy(interleaved.data() + offset, &attribute, sizeof(T));
+}
+
+/*
+ * Mesh makeLayout:
+ * - Add the attributes of the vertex format.
+ */
+VertexLayout Mesh::makeLayout() {
+	VertexLayout layout{};
+	switch (vertex_format_) {
+	case VertexFormat::Float:
+		layout.add(kPositionLocation, AttributeFormat::Float3).add(kNormalLocation, AttributeFormat::Float3);
+		break;
+	case VertexFormat::PackedNormal:
+		layout.add(kPositionLocation, AttributeFormat::Float3).add(kNormalLocation, AttributeFormat::Int2101010);
+		break;
+	case VertexFormat::HalfPosition:
+		layout.add(kPositionLocation, AttributeFormat::HalfFloat4).add(kNormalLocation, AttributeFormat::Int2101010);
+		break;
+	case VertexFormat::Position:
+		layout.add(kPositionLocation, AttributeFormat::Float3);
+		break;
+	case VertexFormat::Direction:
+		layout.add(kPositionLocation, AttributeFormat::Short2);
+		break;
+	case VertexFormat::DirectionDistance:
+		layout.add(kPositionLocation, AttributeFormat::Short4);
+		break;
+	}
+	return layout;
+}
+
+/*
+ * Mesh packVertices:
+ * - If the format is only positions, copy the vertices as they are.
+ * - Otherwise interleave and pack vertices and normals, or encode the directions.
+ */
+std::vector<unsigned char> Mesh::packVertices(const VertexLayout& layout) {
+	std::vector<unsigned char> interleaved{};
+	if (vertex_format_ == VertexFormat::Position) {
+		interleaved.resize(sizeof(glm::vec3) * vertices_->size());
+		std::memcpy(interleaved.data(), vertices_->data(), interleaved.size());
+		return interleaved;
+	}
+
+	interleaved.reserve(layout.getStride() * vertices_->size());
+	for (std::size_t i = 0; i < vertices_->size(); i++) {
+		const glm::vec3& vertex{ vertices_->at(i) };
+		const glm::vec3 normal{ hasNormals(vertex_format_) ? normals_->at(i) : glm::vec3{} };
+		switch (vertex_format_) {
+		case VertexFormat::Float:
+			appendAttribute(interleaved, vertex);
+			appendAttribute(interleaved, normal);
+			break;
+		case VertexFormat::PackedNormal:
+			appendAttribute(interleaved, vertex);
+			appendAttribute(interleaved, glm::packSnorm3x10_1x2(glm::vec4{ normal, 0.0f }));
+			break;
+		case VertexFormat::HalfPosition:
+			appendAttribute(interleaved, glm::packHalf4x16(glm::vec4{ vertex, 1.0f }));
+			appendAttribute(interleaved, glm::packSnorm3x10_1x2(glm::vec4{ normal, 0.0f }));
+			break;
+		case VertexFormat::Direction:
+			appendAttribute(interleaved, glm::packSnorm2x16(octahedralEncode(vertex)));
+			break;
+		case VertexFormat::DirectionDistance:
+			appendAttribute(interleaved, glm::packSnorm4x16(glm::vec4{ octahedralEncode(vertex), glm::length(vertex) / position_scale_, 0.0f }));
+			break;
+		case VertexFormat::Position:
+			break;
+		}
+	}
+	return interleaved;
+}
+
 /*
  * Mesh generateBuffers:
- * - Generate VAO and bind it.
- * - Generate VBO for vertices and bind it.
- * - Generate VBO for normals and bind it.
- * - unbind VAO.
+ * - If the upload is requested, wait for it and add its buffer, which is already uploaded.
+ * - Otherwise, if the format is only positions, upload the vertices as they are.
+ * - Otherwise pack the vertices and upload them as a single buffer.
+ * - Mark as uploaded.
  */
 void Mesh::generateBuffers() {
-	glGenVertexArrays(1, &VAO_);
-	glBindVertexArray(VAO_);
+	const VertexLayout layout{ makeLayout() };
+	geometry_buffer_ = new GeometryBuffer{ mesh_type_ };
 
-	glGenBuffers(1, &vertex_VBO_);
-	glBindBuffer(GL_ARRAY_BUFFER, vertex_VBO_);
-	glBufferData(GL_ARRAY_BUFFER, size(), verticesData(), GL_STATIC_DRAW);
+	if (upload_request_ != nullptr) {
+		render::UploadThread::wait(*upload_request_);
+		geometry_buffer_->addVertexBuffer(layout, upload_request_->buffer, vertices_->size());
+		upload_request_.reset();
+	} else if (vertex_format_ == VertexFormat::Position) {
+		geometry_buffer_->addVertexBuffer(layout, vertices_->data(), vertices_->size());
+	} else {
+		geometry_buffer_->addVertexBuffer(layout, packVertices(layout).data(), vertices_->size());
+	}
 
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-	glEnableVertexAttribArray(0);
+	uploaded_ = true;
+}
 
-	glGenBuffers(1, &normal_VBO_);
-	glBindBuffer(GL_ARRAY_BUFFER, normal_VBO_);
-	glBufferData(GL_ARRAY_BUFFER, size(), normalsData(), GL_STATIC_DRAW);
+/*
+ * Mesh requestUpload:
+ * - If not uploaded or requested and there is an upload thread, pack the vertices and queue them.
+ */
+void Mesh::requestUpload() {
+	if (uploaded_)
+		return;
+	render::UploadThread* upload_thread{ render::UploadThread::getUploadThread() };
+	if (upload_thread == nullptr)
+		return;
 
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-	glEnableVertexAttribArray(1);
+	std::lock_guard<std::mutex> guard{ upload_mutex_ };
+	if (uploaded_ || upload_request_ != nullptr)
+		return;
+	upload_request_ = upload_thread->upload(packVertices(makeLayout()));
+}
 
-	glBindVertexArray(0);
+bool Mesh::isUploading() {
+	std::lock_guard<std::mutex> guard{ upload_mutex_ };
+	return !uploaded_ && upload_request_ != nullptr;
 }
 
-void Mesh::bind() { glBindVertexArray(VAO_); }
+void Mesh::upload() {
+	if (uploaded_)
+		return;
+	std::lock_guard<std::mutex> guard{ upload_mutex_ };
+	if (!uploaded_)
+		generateBuffers();
+}
+
+/*
+ * Mesh isUploaded:
+ * - If not uploaded, but the requested upload is done, generate the buffers from it without waiting.
+ */
+bool Mesh::isUploaded() {
+	if (uploaded_)
+		return true;
+	std::lock_guard<std::mutex> guard{ upload_mutex_ };
+	if (!uploaded_ && upload_request_ != nullptr && render::UploadThread::poll(*upload_request_))
+		generateBuffers();
+	return uploaded_;
+}
+
+/*
+ * Mesh bind:
+ * - Generate the buffers if not generated.
+ * - Bind the buffers.
+ * - If the format has no normals, set the normal attribute to zero so the shader uses the position.
+ */
+void Mesh::bind() {
+	upload();
+	geometry_buffer_->bind();
+	if (!hasNormals(vertex_format_))
+		glVertexAttrib3f(kNormalLocation, 0.0f, 0.0f, 0.0f);
+}
+
+void Mesh::unbind() { geometry_buffer_->unbind(); }
 
-void Mesh::unbind() { glBindVertexArray(0);  }
+void Mesh::draw() { geometry_buffer_->draw(); }
+
+void Mesh::draw(unsigned int primitive_type) { geometry_buffer_->draw(primitive_type); }
 
 /*
  * Mesh Constructor:
  * - Generate vertices.
- * - Generate normals.
- * - Generate Buffers.
+ * - Generate normals if triangles, other meshes have no normals.
+ * - The buffers are generated when first bound.
  */
 Mesh::Mesh(std::vector<glm::vec3>* vertices, unsigned int mesh_type) 
-	: vertices_{ vertices }, normals_{ mesh_type != GL_TRIANGLES ? vertices : smoothNormals(vertices_, generateNormals(vertices_, mesh_type)) },
-	  VAO_{ 0 }, vertex_VBO_{ 0 }, normal_VBO_{ 0 } {
-	generateBuffers();
-}
+	: mesh_type_{ mesh_type }, mesh_id_{ nextMeshId() }, vertex_format_{ mesh_type != GL_TRIANGLES ? VertexFormat::Position : VertexFormat::PackedNormal },
+	  position_scale_{ 1.0f }, vertices_{ vertices }, normals_{ mesh_type != GL_TRIANGLES ? nullptr : smoothNormals(vertices_, generateNormals(vertices_, mesh_type)) },
+	  geometry_buffer_{ nullptr }, uploaded_{ false }, upload_request_{ nullptr }, upload_mutex_{} { }
 
+Mesh::Mesh(std::vector<glm::vec3>* vertices, std::vector<glm::vec3>* normals, unsigned int mesh_type)
+	: mesh_type_{ mesh_type }, mesh_id_{ nextMeshId() }, vertex_format_{ normals != nullptr ? VertexFormat::PackedNormal : VertexFormat::Position },
+	  position_scale_{ 1.0f }, vertices_{ vertices }, normals_{ normals }, geometry_buffer_{ nullptr }, uploaded_{ false }, upload_request_{ nullptr }, upload_mutex_{} { }
+
+/*
+ * Mesh Destructor:
+ * - Delete the buffers if uploaded and the context is still alive.
+ * - Otherwise delete the buffer of a requested upload when it is done.
+ * - Delete vertices and normals.
+ */
 Mesh::~Mesh() {
+	if (uploaded_ && glfwGetCurrentContext() != nullptr) {
+		delete geometry_buffer_;
+	} else if (upload_request_ != nullptr && glfwGetCurrentContext() != nullptr) {
+		render::UploadThread::wait(*upload_request_);
+		glDeleteBuffers(1, &upload_request_->buffer);
+	}
 	delete vertices_;
 	delete normals_;
 }
@@ -0,0 +1,111 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the MeshRegistry class.                                 *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "simulation/object/model/mesh_registry.h"
+
+/* STL Includes */
+#include <iomanip>
+
+namespace wanderers {
+namespace simulation {
+namespace object {
+namespace model {
+
+MeshRegistry::MeshRegistry() : meshes_{}, added_count_{} {}
+
+/*
+ * MeshRegistry get:
+ * - Return the mesh if a handle to it is alive.
+ * - Otherwise create the mesh and register it.
+ *   The mesh is created while holding the lock, so it is only created once.
+ */
+MeshHandle MeshRegistry::get(const std::string& name, std::function<Mesh*(void)> create) {
+	std::lock_guard<std::mutex> guard{ registry_mutex_ };
+	MeshHandle mesh{ meshes_[name].lock() };
+	if (!mesh) {
+		mesh = MeshHandle{ create() };
+		meshes_[name] = mesh;
+	}
+	return mesh;
+}
+
+MeshHandle MeshRegistry::add(const std::string& name, Mesh* mesh) {
+	std::lock_guard<std::mutex> guard{ registry_mutex_ };
+	MeshHandle handle{ mesh };
+	meshes_[name + "#" + std::to_string(added_count_[name]++)] = handle;
+	return handle;
+}
+
+std::size_t MeshRegistry::getCpuBytes() {
+	std::lock_guard<std::mutex> guard{ registry_mutex_ };
+	std::size_t bytes{ 0 };
+	for (std::pair<const std::string, std::weak_ptr<Mesh>>& entry : meshes_) {
+		MeshHandle mesh{ entry.second.lock() };
+		if (mesh)
+			bytes += mesh->getCpuBytes();
+	}
+	return bytes;
+}
+
+std::size_t MeshRegistry::getGpuBytes() {
+	std::lock_guard<std::mutex> guard{ registry_mutex_ };
+	std::size_t bytes{ 0 };
+	for (std::pair<const std::string, std::weak_ptr<Mesh>>& entry : meshes_) {
+		MeshHandle mesh{ entry.second.lock() };
+		if (mesh)
+			bytes += mesh->getGpuBytes();
+	}
+	return bytes;
+}
+
+/*
+ * MeshRegistry report:
+ * - Forget the meshes that have been deleted.
+ * - For each alive mesh, write its name, handle count, vertex count and memory.
+ * - Write the total memory.
+ */
+void MeshRegistry::report(std::ostream& out) {
+	std::lock_guard<std::mutex> guard{ registry_mutex_ };
+	std::size_t cpu_bytes{ 0 };
+	std::size_t gpu_bytes{ 0 };
+
+	out << std::left << std::setw(32) << "Mesh" << std::right << std::setw(10) << "Handles" << std::setw(12) << "Vertices"
+	    << std::setw(12) << "CPU KiB" << std::setw(12) << "GPU KiB" << "\n";
+	for (auto it = meshes_.begin(); it != meshes_.end();) {
+		MeshHandle mesh{ it->second.lock() };
+		if (!mesh) {
+			it = meshes_.erase(it);
+			continue;
+		}
+		// The handle held here is not counted.
+		out << std::left << std::setw(32) << it->first << std::right << std::setw(10) << mesh.use_count() - 1
+		    << std::setw(12) << mesh->count()
+		    << std::setw(12) << mesh->getCpuBytes() / 1024 << std::setw(12) << mesh->getGpuBytes() / 1024 << "\n";
+		cpu_bytes += mesh->getCpuBytes();
+		gpu_bytes += mesh->getGpuBytes();
+		it++;
+	}
+	out << std::left << std::setw(54) << "Total" << std::right << std::setw(12) << cpu_bytes / 1024 
+	    << std::setw(12) << gpu_bytes / 1024 << std::endl;
+}
+
+/*
+ * MeshRegistry getMeshRegistry:
+ * - Construct the mesh registry singleton if not constructed.
+ */
+MeshRegistry* MeshRegistry::getMeshRegistry() {
+	static MeshRegistry* mesh_registry;
+	if (!mesh_registry) {
+		mesh_registry = new MeshRegistry{};
+	}
+	return mesh_registry;
+}
+
+} // namespace model
+} // namespace object
+} // namespace simulation
+} // namespace wanderers
@@ -11,12 +11,29 @@
 #include "glad/gl.h"
 #include "glfw/glfw3.h"
 
+/* STL Includes */
+#include <algorithm>
+#include <limits>
+
 namespace wanderers {
 namespace simulation {
 namespace object {
 namespace model {
 
-Points::Points(std::vector<glm::vec3>* points) : Mesh(points, GL_POINTS) { }
+/*
+ * Points Constructor:
+ * - Find the shortest and longest point.
+ * - Encode only the directions if all points have the same length, otherwise also the distances.
+ */
+Points::Points(std::vector<glm::vec3>* points) : Mesh(points, GL_POINTS) {
+	float min_length{ std::numeric_limits<float>::max() };
+	float max_length{ 0.0f };
+	for (const glm::vec3& point : *points) {
+		min_length = std::min(min_length, glm::length(point));
+		max_length = std::max(max_length, glm::length(point));
+	}
+	setVertexFormat(max_length - min_length <= kUnitLengthTolerance * max_length ? VertexFormat::Direction : VertexFormat::DirectionDistance);
+}
 
 
 } // namespace model
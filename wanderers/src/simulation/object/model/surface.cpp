@@ -9,13 +9,19 @@
 
 /* External Includes */
 #include "glad/gl.h"
-#include "glfw/glfw3.h"
 
 #include "glm/ext.hpp"
 
+/* Internal Includes */
+#include "common/noise.h"
+#include "common/thread_pool.h"
+#include "simulation/object/model/mesh_registry.h"
+
 /* STL Includes */
+#include <cstdint>
+#include <cstring>
 #include <random>
-#include <chrono>
+#include <unordered_map>
 
 namespace wanderers {
 namespace simulation {
@@ -24,25 +30,138 @@ namespace model {
 
 Surface::Surface() : Surface{ 0, 0.0f } {}
 
-Surface::Surface(int sub_division_level, float roughness) : Icosahedron{ generateSurface(subDivide(generateIcosahedron(), sub_division_level), roughness) } { }
+Surface::Surface(int sub_division_level, float roughness, unsigned int seed) 
+	: Surface{ generateGeometry(sub_division_level, roughness, seed) } { }
+
+/* The surface stays close to the unit sphere, so the positions are stored as half floats. */
+Surface::Surface(Geometry geometry) : Icosahedron{ geometry.vertices, geometry.normals } {
+	setVertexFormat(VertexFormat::HalfPosition);
+}
 
 /*
- * Surface generateSurface:
- * - Get seed
- * - For each vertice:
- *   - Calculate surface displacement from seed and position and apply it.
+ * Surface seedOffset:
+ * - Draw each component from a generator seeded with the seed.
+ *   The offset is kept small so the noise keeps its precision as 32-bit float on the GPU.
  */
-std::vector<glm::vec3>* Surface::generateSurface(std::vector<glm::vec3>* vertices, float roughness) {
-	glm::vec3 seed_vec{ static_cast<float>(glfwGetTime()) * 10000.0f };
-	for (int i = 0; i < vertices->size(); i++) {
-		glm::vec3 vec{ vertices->at(i) };
-		
-		float displacement = 0.5f * glm::perlin(0.2f * vec + seed_vec) + 0.3f * glm::perlin(vec + seed_vec) + 0.15f * glm::perlin(2.0f * vec + seed_vec) + 0.05f * glm::perlin(4.0f * vec + seed_vec);
-		displacement = (displacement + 1.0f) / 2.0f;
-		vertices->at(i) = vec * (-displacement * roughness + 1.0f);
+glm::vec3 Surface::seedOffset(unsigned int seed) {
+	std::minstd_rand generator{ seed };
+	glm::vec3 offset{};
+	for (int i = 0; i < 3; i++)
+		offset[i] = static_cast<float>(generator() % 65536) / 256.0f;
+	return offset;
+}
+
+namespace {
+
+/* Key of a vertex position by its exact bits. */
+struct PointKey {
+	std::uint32_t bits[3];
+
+	bool operator==(const PointKey& other) const {
+		return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+	}
+};
+
+struct PointKeyHash {
+	std::size_t operator()(const PointKey& key) const {
+		return (key.bits[0] * 73856093u) ^ (key.bits[1] * 19349663u) ^ (key.bits[2] * 83492791u);
+	}
+};
+
+PointKey pointKey(const glm::vec3& point) {
+	PointKey key;
+	std::memcpy(key.bits, &point[0], sizeof(key.bits));
+	return key;
+}
+
+} // namespace
+
+/*
+ * Surface generateGeometry:
+ * - Generate the subdivided unit icosahedron.
+ * - Index the vertices by position. Each point is shared by about six triangle corners
+ *   and subdividing gives them identical bits, so the noise is evaluated once per point.
+ * - Displace the points.
+ * - Expand the points into triangle vertices.
+ * - Sum the triangle normals of each point and normalize them as smooth normals.
+ */
+Surface::Geometry Surface::generateGeometry(int sub_division_level, float roughness, unsigned int seed) {
+	std::vector<glm::vec3>* vertices{ subDivide(generateIcosahedron(), sub_division_level) };
+
+	std::unordered_map<PointKey, std::uint32_t, PointKeyHash> point_indices{};
+	point_indices.reserve(vertices->size() / 4);
+	std::vector<std::uint32_t> indices(vertices->size());
+	std::vector<glm::vec3> points{};
+	for (std::size_t i = 0; i < vertices->size(); i++) {
+		auto inserted{ point_indices.insert({ pointKey(vertices->at(i)), static_cast<std::uint32_t>(points.size()) }) };
+		if (inserted.second)
+			points.push_back(vertices->at(i));
+		indices[i] = inserted.first->second;
 	}
-		
-	return vertices;
+
+	displace(points, roughness, seed);
+
+	for (std::size_t i = 0; i < vertices->size(); i++)
+		vertices->at(i) = points[indices[i]];
+
+	std::vector<glm::vec3> point_normals(points.size(), glm::vec3{ 0.0f });
+	for (std::size_t i = 0; i + 2 < vertices->size(); i += 3) {
+		glm::vec3 v1{ vertices->at(i) };
+		glm::vec3 v2{ vertices->at(i + 1) };
+		glm::vec3 v3{ vertices->at(i + 2) };
+
+		glm::vec3 normal{ glm::normalize(-glm::cross(v2 - v1, v2 - v3)) };
+
+		point_normals[indices[i]] += normal;
+		point_normals[indices[i + 1]] += normal;
+		point_normals[indices[i + 2]] += normal;
+	}
+
+	std::vector<glm::vec3>* normals{ new std::vector<glm::vec3>(vertices->size()) };
+	for (std::size_t i = 0; i < vertices->size(); i++)
+		normals->at(i) = glm::normalize(point_normals[indices[i]]);
+
+	return Geometry{ vertices, normals };
+}
+
+/*
+ * Surface displace:
+ * - Get seed offset.
+ * - For batches of points in parallel:
+ *   - Split the points into coordinate arrays.
+ *   - For each octave, calculate the noise of the whole batch at once and add it to the displacement.
+ *   - Apply the displacement.
+ */
+void Surface::displace(std::vector<glm::vec3>& points, float roughness, unsigned int seed) {
+	const glm::vec3 seed_vec{ seedOffset(seed) };
+	const float scales[]{ 0.2f, 1.0f, 2.0f, 4.0f };
+	const float weights[]{ 0.5f, 0.3f, 0.15f, 0.05f };
+
+	common::ThreadPool::getThreadPool()->parallelFor(points.size(), 1024, [&](std::size_t begin, std::size_t end) {
+		std::size_t count{ end - begin };
+		std::vector<float> x(count), y(count), z(count), noise(count), displacement(count, 0.0f);
+
+		for (int octave = 0; octave < 4; octave++) {
+			for (std::size_t i = 0; i < count; i++) {
+				glm::vec3 point{ scales[octave] * points[begin + i] + seed_vec };
+				x[i] = point.x;
+				y[i] = point.y;
+				z[i] = point.z;
+			}
+			common::perlin(x.data(), y.data(), z.data(), noise.data(), count);
+			for (std::size_t i = 0; i < count; i++)
+				displacement[i] += weights[octave] * noise[i];
+		}
+
+		for (std::size_t i = 0; i < count; i++) {
+			float normalized_displacement{ (displacement[i] + 1.0f) / 2.0f };
+			points[begin + i] *= -normalized_displacement * roughness + 1.0f;
+		}
+	});
+}
+
+MeshHandle getDefaultSurface() {
+	return MeshRegistry::getMeshRegistry()->get("surface_default", []() -> Mesh* { return new Surface{ 3, 0.5 }; });
 }
 
 } // namespace model
@@ -0,0 +1,219 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ * Implementation of the SurfaceCache class.                                 *
+ *                                                                           *
+ * Copyright (c) 2022 Karl Andersson                                         *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "simulation/object/model/surface_cache.h"
+
+/* Internal Includes */
+#include "common/thread_pool.h"
+
+/* STL Includes */
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace wanderers {
+namespace simulation {
+namespace object {
+namespace model {
+
+namespace {
+
+/* Identifies a surface cache file, "WSRF". */
+constexpr std::uint32_t kCacheMagic{ 0x46525357 };
+/* Increase when the generation or the file layout changes, so old files are regenerated. */
+constexpr std::uint32_t kCacheVersion{ 1 };
+
+/* Header of a surface cache file, followed by the vertices and the normals. */
+struct CacheHeader {
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::uint32_t seed;
+	std::int32_t sub_division_level;
+	std::uint32_t roughness;
+	std::uint32_t vertex_count;
+};
+
+void makeDirectory(const std::string& directory) {
+#ifdef _WIN32
+	_mkdir(directory.c_str());
+#else
+	mkdir(directory.c_str(), 0755);
+#endif
+}
+
+} // namespace
+
+SurfaceCache::SurfaceCache() : surfaces_{}, loading_{}, cache_directory_{ "cache" } {}
+
+/*
+ * SurfaceCache requestSurface:
+ * - Return the surface if it is in memory.
+ * - Otherwise, unless it is already loading, load it with a task on the thread pool:
+ *   - Read the geometry from disk, or generate it and write it to disk, without holding the lock.
+ *   - Keep the surface in memory.
+ * - Return null until it is loaded.
+ */
+Surface* SurfaceCache::requestSurface(unsigned int seed, int sub_division_level, float roughness) {
+	Key key{ makeKey(seed, sub_division_level, roughness) };
+	std::string cache_directory{};
+	{
+		std::lock_guard<std::mutex> guard{ cache_mutex_ };
+		auto it{ surfaces_.find(key) };
+		if (it != surfaces_.end())
+			return static_cast<Surface*>(it->second.get());
+		if (!loading_.insert(key).second)
+			return nullptr;
+		cache_directory = cache_directory_;
+	}
+
+	common::ThreadPool::getThreadPool()->submit([this, cache_directory, key]() {
+		Surface* surface{ loadSurface(cache_directory, key) };
+		MeshHandle handle{ MeshRegistry::getMeshRegistry()->add(
+			"surface_" + std::to_string(std::get<0>(key)) + "_" + std::to_string(std::get<1>(key)), surface) };
+
+		std::lock_guard<std::mutex> guard{ cache_mutex_ };
+		surfaces_[key] = handle;
+		loading_.erase(key);
+	});
+	return nullptr;
+}
+
+/*
+ * SurfaceCache loadSurface:
+ * - Read the geometry from disk, or generate it and write it to disk.
+ * - Create the surface and request its upload.
+ */
+Surface* SurfaceCache::loadSurface(const std::string& cache_directory, const Key& key) {
+	float roughness;
+	std::uint32_t roughness_bits{ std::get<2>(key) };
+	std::memcpy(&roughness, &roughness_bits, sizeof(roughness));
+
+	Surface::Geometry geometry{};
+	if (read(cache_directory, key, geometry) != 0) {
+		geometry = Surface::generateGeometry(std::get<1>(key), roughness, std::get<0>(key));
+		write(cache_directory, key, geometry);
+	}
+
+	Surface* surface{ new Surface{ geometry } };
+	surface->requestUpload();
+	return surface;
+}
+
+void SurfaceCache::setCacheDirectory(std::string cache_directory) {
+	std::lock_guard<std::mutex> guard{ cache_mutex_ };
+	cache_directory_ = cache_directory;
+}
+
+std::string SurfaceCache::getCacheDirectory() {
+	std::lock_guard<std::mutex> guard{ cache_mutex_ };
+	return cache_directory_;
+}
+
+std::size_t SurfaceCache::size() {
+	std::lock_guard<std::mutex> guard{ cache_mutex_ };
+	return surfaces_.size();
+}
+
+SurfaceCache::Key SurfaceCache::makeKey(unsigned int seed, int sub_division_level, float roughness) {
+	std::uint32_t roughness_bits;
+	std::memcpy(&roughness_bits, &roughness, sizeof(roughness_bits));
+	return Key{ seed, sub_division_level, roughness_bits };
+}
+
+std::string SurfaceCache::cachePath(const std::string& cache_directory, const Key& key) {
+	std::stringstream path;
+	path << cache_directory << "/surface_" << std::get<0>(key) << "_" << std::get<1>(key) << "_"
+	     << std::hex << std::setw(8) << std::setfill('0') << std::get<2>(key) << ".bin";
+	return path.str();
+}
+
+/*
+ * SurfaceCache read:
+ * - Open the cache file of the key.
+ * - Check that the header matches the key and the version.
+ * - Read the vertices and normals.
+ * - Return 0 if successful.
+ */
+int SurfaceCache::read(const std::string& cache_directory, const Key& key, Surface::Geometry& geometry) {
+	if (cache_directory.empty())
+		return 1;
+
+	std::ifstream cache_file{ cachePath(cache_directory, key), std::ios::binary };
+	if (!cache_file)
+		return 1;
+
+	CacheHeader header{};
+	cache_file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!cache_file || header.magic != kCacheMagic || header.version != kCacheVersion
+		|| header.seed != std::get<0>(key) || header.sub_division_level != std::get<1>(key) || header.roughness != std::get<2>(key))
+		return 1;
+
+	std::vector<glm::vec3>* vertices{ new std::vector<glm::vec3>(header.vertex_count) };
+	std::vector<glm::vec3>* normals{ new std::vector<glm::vec3>(header.vertex_count) };
+	cache_file.read(reinterpret_cast<char*>(vertices->data()), sizeof(glm::vec3) * vertices->size());
+	cache_file.read(reinterpret_cast<char*>(normals->data()), sizeof(glm::vec3) * normals->size());
+	if (!cache_file) {
+		std::cout << "Warning: Surface cache file " << cachePath(cache_directory, key) << " is truncated, regenerating it." << std::endl;
+		delete vertices;
+		delete normals;
+		return 1;
+	}
+
+	geometry = Surface::Geometry{ vertices, normals };
+	return 0;
+}
+
+/*
+ * SurfaceCache write:
+ * - Create the cache directory if needed and open the cache file of the key.
+ * - Write the header, vertices and normals.
+ * - Return 0 if successful.
+ */
+int SurfaceCache::write(const std::string& cache_directory, const Key& key, const Surface::Geometry& geometry) {
+	if (cache_directory.empty())
+		return 1;
+
+	makeDirectory(cache_directory);
+	std::ofstream cache_file{ cachePath(cache_directory, key), std::ios::binary };
+	if (!cache_file) {
+		std::cout << "Warning: Could not write surface cache file " << cachePath(cache_directory, key) << "." << std::endl;
+		return 1;
+	}
+
+	CacheHeader header{ kCacheMagic, kCacheVersion, std::get<0>(key), std::get<1>(key), std::get<2>(key),
+	                    static_cast<std::uint32_t>(geometry.vertices->size()) };
+	cache_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	cache_file.write(reinterpret_cast<const char*>(geometry.vertices->data()), sizeof(glm::vec3) * geometry.vertices->size());
+	cache_file.write(reinterpret_cast<const char*>(geometry.normals->data()), sizeof(glm::vec3) * geometry.normals->size());
+
+	return cache_file.good() ? 0 : 1;
+}
+
+/*
+ * SurfaceCache getSurfaceCache:
+ * - Construct the surface cache singleton if not constructed.
+ */
+SurfaceCache* SurfaceCache::getSurfaceCache() {
+	static SurfaceCache* surface_cache;
+	if (!surface_cache) {
+		surface_cache = new SurfaceCache{};
+	}
+	return surface_cache;
+}
+
+} // namespace model
+} // namespace object
+} // namespace simulation
+} // namespace wanderers
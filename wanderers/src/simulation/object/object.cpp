@@ -11,19 +11,19 @@ namespace wanderers {
 namespace simulation {
 namespace object {
 
-Object::Object(model::Mesh* model) : Object{kDefaultObject, model} {}
+Object::Object(model::MeshHandle model) : Object{kDefaultObject, model} {}
 
-Object::Object(AbstractObject abstract_object, model::Mesh* model)
+Object::Object(AbstractObject abstract_object, model::MeshHandle model)
 	: AbstractObject{ abstract_object }, model_{ model } { assert(model_ != nullptr); }
 
-void Object::setModel(model::Mesh* model) {
+void Object::setModel(model::MeshHandle model) {
 	if (model != nullptr) {
 		model_ = model;
 	}
 }
 
 model::Mesh* const Object::getModel() const {
-	return model_;
+	return model_.get();
 }
 
 void Object::bind() { model_->bind(); }
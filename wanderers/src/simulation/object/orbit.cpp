@@ -13,12 +13,31 @@
 #include "glm/gtx/rotate_vector.hpp"
 #include "glm/gtx/vector_angle.hpp"
 
+/* STL Includes */
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 namespace wanderers {
 namespace simulation {
 namespace object {
 
+/*
+ * solveKepler:
+ * - Start from the mean anomaly, or half a revolution for very eccentric orbits where Newton's method can overshoot.
+ * - Refine the eccentric anomaly with Newton's method on E - e sin(E) - M until the step is negligible.
+ */
+static double solveKepler(double mean_anomaly, double eccentricity) {
+    double eccentric_anomaly{ eccentricity < 0.8 ? mean_anomaly : glm::pi<double>() };
+    for (int i = 0; i < 16; i++) {
+        double step{ (eccentric_anomaly - eccentricity * sin(eccentric_anomaly) - mean_anomaly) / (1.0 - eccentricity * cos(eccentric_anomaly)) };
+        eccentric_anomaly -= step;
+        if (std::abs(step) < 1e-9)
+            break;
+    }
+    return eccentric_anomaly;
+}
+
 Orbit::Orbit(float eccentricity, float semimajor_axis, float inclination, float longitude_of_acending_node, float argument_of_periapsis, float true_anomaly, float angular_velocity)
     : Orbit{semimajor_axis, 
             semimajor_axis * sqrt(1 - eccentricity * eccentricity),
@@ -51,18 +70,23 @@ Orbit::Orbit(float major_axis, float minor_axis, float angular_velocity, float o
 
 Orbit::Orbit(float radius, float angular_velocity, float orbital_angle, glm::vec3 orbital_axis, glm::vec3 orbital_face) 
     : Orbit{radius, radius, angular_velocity, orbital_angle, orbital_axis, orbital_face} {}
+// The orbit has no physical object, the orbit line is generated by the renderer.
 Orbit::Orbit(float major_axis, float minor_axis, float angular_velocity, float orbital_angle, glm::vec3 orbital_axis, glm::vec3 orbital_face) 
-    : Orbit{ getOrbitTrailObject(), major_axis, minor_axis, angular_velocity, orbital_angle, orbital_axis, orbital_face } {}
+    : Orbit{ AstronomicalObject{ kDefaultObject, nullptr }, major_axis, minor_axis, angular_velocity, orbital_angle, orbital_axis, orbital_face } {}
 
 Orbit::Orbit(AstronomicalObject astronomical_object, float major_axis, float minor_axis, 
              float angular_velocity, float orbital_angle, glm::vec3 orbital_axis, glm::vec3 orbital_face)
             : AstronomicalObject{ astronomical_object },
               major_axis_{ major_axis }, minor_axis_{ minor_axis },
-              angular_velocity_{ angular_velocity }, orbital_angle_{ orbital_angle },
-              orbital_orientation_{orbital_axis, orbital_face} {}
+              angular_velocity_{ angular_velocity }, orbital_angle_{ orbital_angle }, mean_anomaly_epoch_{ 0.0 },
+              previous_orbital_angle_{ orbital_angle }, interpolated_orbital_angle_{ orbital_angle },
+              orbital_orientation_{orbital_axis, orbital_face} {
+    updateMeanAnomaly();
+}
 
 void Orbit::setMajorAxis(float major_axis) {
     major_axis_ = major_axis;
+    updateMeanAnomaly();
 }
 float Orbit::getMajorAxis() {
     return major_axis_;
@@ -70,12 +94,14 @@ float Orbit::getMajorAxis() {
 
 void Orbit::setMinorAxis(float minor_axis) {
     minor_axis_ = minor_axis;
+    updateMeanAnomaly();
 }
 float Orbit::getMinorAxis() {
     return minor_axis_;
 }
 
 void Orbit::setAngularVelocity(float angular_velocity) {
+    mean_anomaly_epoch_ += (static_cast<double>(angular_velocity_) - angular_velocity) * time_;
     angular_velocity_ = angular_velocity;
 }
 
@@ -85,12 +111,19 @@ float Orbit::getAngularVelocity() {
 
 void Orbit::setOrbitalAngle(float orbital_angle) {
     orbital_angle_ = orbital_angle;
+    previous_orbital_angle_ = orbital_angle;
+    interpolated_orbital_angle_ = orbital_angle;
+    updateMeanAnomaly();
 }
 
 float Orbit::getOrbitalAngle() {
     return orbital_angle_;
 }
 
+float Orbit::getInterpolatedOrbitalAngle() {
+    return interpolated_orbital_angle_;
+}
+
 void Orbit::setOrbitalAxis(glm::vec3 orbital_axis) {
     orbital_orientation_.setNormal(orbital_axis);
 }
@@ -117,23 +150,22 @@ glm::vec3 Orbit::getOrbitalSide() const {
     return orbital_orientation_.getBitangent();
 }
 
+glm::mat3 Orbit::getOrbitalRotation() {
+    return glm::mat3{ orbital_orientation_.orientationMatrix() };
+}
+
 /*
  * Orbit getOrbitMatrix:
- * - Invert scaling to avoid ellipse artifacts.
- * - Invert rotate to avoid rotating the object in orbit.
- * - Translate object to orbit distance (semi-minor axis).
- * - Rotate object around the orbit.
- * - Scale the orbit in one axis to make it elliptical.
+ * - Scale the unit circle into the ellipse of the orbit.
  * - Translate orbit to focus point.
  * - Orient orbit according to oientation parameters.
  */
 glm::mat4 Orbit::getOrbitMatrix() {
     float normalized_major = minor_axis_ > 0.00001f ? major_axis_ / minor_axis_ : 1.0f;
     float focus_point = sqrt(normalized_major * normalized_major - 1.0f);
-    return orbital_orientation_.orientationMatrix(common::kYOrientation)
+    return orbital_orientation_.orientationMatrix()
            * glm::translate(glm::mat4{ 1.0f }, -kFace * minor_axis_ * focus_point)
-           * glm::scale(glm::mat4{ 1.0f }, glm::vec3{ minor_axis_, 1.0f, major_axis_ })
-           * glm::rotate(glm::mat4{ 1.0f }, glm::radians(0.5f * orbital_angle_), kUp);
+           * glm::scale(glm::mat4{ 1.0f }, glm::vec3{ minor_axis_, 1.0f, major_axis_ });
 }
 
 /*
@@ -149,29 +181,59 @@ glm::mat4 Orbit::getOrbitMatrix() {
 glm::mat4 Orbit::getMatrix() {
     float normalized_major = minor_axis_ > 0.00001f ? major_axis_ / minor_axis_ : 1.0f;
     float focus_point = sqrt(normalized_major * normalized_major - 1.0f);
-    return orbital_orientation_.orientationMatrix(common::kYOrientation)
+    return orbital_orientation_.orientationMatrix()
         * glm::translate(glm::mat4{ 1.0f }, -kFace * minor_axis_ * focus_point)
         * glm::scale(glm::mat4{ 1.0f }, glm::vec3{ 1.0f, 1.0f, normalized_major })
-        * glm::rotate(glm::mat4{ 1.0f }, glm::radians(orbital_angle_), kUp)
+        * glm::rotate(glm::mat4{ 1.0f }, glm::radians(interpolated_orbital_angle_), kUp)
         * glm::translate(glm::mat4{ 1.0f }, kFace * minor_axis_)
-        * glm::rotate(glm::mat4{ 1.0f }, -glm::radians(orbital_angle_), kUp)
+        * glm::rotate(glm::mat4{ 1.0f }, -glm::radians(interpolated_orbital_angle_), kUp)
         * glm::scale(glm::mat4{ 1.0f }, glm::vec3{ 1.0f, 1.0f, 1.0f / normalized_major });
 }
 
+void Orbit::elapseTime(double seconds) {
+    setTime(time_ + seconds, seconds);
+}
+
 /*
- * Orbit elapseTime:
- * - Increase orbital angle as much as the angular velocity.
- * - Elapse the time for the Orbitor.
+ * Orbit setTime:
+ * - Derive the orbital angles at the time and the step before from the mean anomaly at time zero, in double.
+ *   Accumulating the mean anomaly step by step would make it differ with the number of steps taken to the time.
  */
-void Orbit::elapseTime(double seconds) {
+void Orbit::setTime(double time, double seconds) {
+    previous_orbital_angle_ = orbitalAngleAt(time - seconds);
+    orbital_angle_ = orbitalAngleAt(time);
+    time_ = time;
+}
+
+/*
+ * Orbit orbitalAngleAt:
+ * - Increase the mean anomaly at time zero as much as the angular velocity over the time.
+ * - Solve the orbital angle from the mean anomaly, it moves faster close to the focus.
+ */
+float Orbit::orbitalAngleAt(double time) {
+    double mean_anomaly{ fmod(mean_anomaly_epoch_ + angular_velocity_ * time, 360.0) };
+    return static_cast<float>(glm::degrees(solveKepler(glm::radians(mean_anomaly), getEccentricity())));
+}
+
+/*
+ * Orbit getEccentricity:
+ * - The ellipse is the unit circle scaled by the major axis relative the minor, with the focus at sqrt(a^2 - 1) of that.
+ * - The eccentricity is the focus distance over the major axis.
+ */
+float Orbit::getEccentricity() {
     float normalized_major = minor_axis_ > 0.00001f ? major_axis_ / minor_axis_ : 1.0f;
-    float focus_point = sqrt(normalized_major * normalized_major - 1.0f);
+    float focus_point = sqrt(std::max(normalized_major * normalized_major - 1.0f, 0.0f));
+    return std::min(focus_point / normalized_major, 0.99f);
+}
 
-    float dist = sqrt(pow(normalized_major * cos(glm::radians(orbital_angle_)) + focus_point, 2.0f) + pow(sin(glm::radians(orbital_angle_)), 2.0f));
+void Orbit::updateMeanAnomaly() {
+    double eccentric_anomaly{ glm::radians(static_cast<double>(orbital_angle_)) };
+    mean_anomaly_epoch_ = glm::degrees(eccentric_anomaly - getEccentricity() * sin(eccentric_anomaly)) - angular_velocity_ * time_;
+}
 
-    orbital_angle_ += angular_velocity_ / sqrt(dist) * seconds;
-    orbital_angle_ = fmod(orbital_angle_, 360.0f);
-} 
+void Orbit::interpolate(float alpha) {
+    interpolated_orbital_angle_ = interpolateAngle(previous_orbital_angle_, orbital_angle_, alpha);
+}
 
 } // namespace object
 } // namespace simulation
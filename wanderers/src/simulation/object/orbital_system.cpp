@@ -41,6 +41,47 @@ void OrbitalSystem::addOrbit(AstronomicalObject* object, Orbit* orbit) {
 	orbits_.push_back(std::make_pair(object, orbit)); 
 }
 
+/*
+ * OrbitalSystem getBodyMatrices:
+ * - Evaluate the matrices if not evaluated since orbits were added.
+ */
+const glm::mat3x4* OrbitalSystem::getBodyMatrices() {
+	if (body_transforms_.getCount() != orbits_.size())
+		body_transforms_.evaluate(orbits_);
+	return body_transforms_.getMatrices();
+}
+
+/* Returns the largest scale of the matrix along its axes. */
+static float maxScale(const glm::mat4& matrix) {
+	return std::max(glm::length(glm::vec3{ matrix[0] }), std::max(glm::length(glm::vec3{ matrix[1] }), glm::length(glm::vec3{ matrix[2] })));
+}
+
+/*
+ * OrbitalSystem getBoundingRadius:
+ * - For each orbit:
+ *   - The ellipse reaches at most its center distance plus its semi-major axis from the system center.
+ *   - Add the radius of the object, the bounding radius if it is a system and the scale of its model otherwise.
+ * - Return the largest radius.
+ */
+float OrbitalSystem::getBoundingRadius() {
+	float radius{ 0.0f };
+	for (std::pair<AstronomicalObject*, Orbit*> orbit : orbits_) {
+		glm::mat4 orbit_matrix{ orbit.second->getOrbitMatrix() };
+		float orbit_radius{ glm::length(glm::vec3{ orbit_matrix[3] }) 
+		                    + std::max(glm::length(glm::vec3{ orbit_matrix[0] }), glm::length(glm::vec3{ orbit_matrix[2] })) };
+
+		float object_radius{ maxScale(orbit.first->getMatrix()) };
+		OrbitalSystem* system{ dynamic_cast<OrbitalSystem*>(orbit.first) };
+		if (system != nullptr)
+			object_radius *= system->getBoundingRadius();
+		else if (orbit.first->getPhysicalObject() != nullptr)
+			object_radius *= maxScale(orbit.first->getPhysicalObject()->getMatrix());
+
+		radius = std::max(radius, orbit_radius + object_radius);
+	}
+	return radius;
+}
+
 /*
  * OrbitalSystem elapseTime:
  * - If simulation is not paused:
@@ -54,6 +95,28 @@ void OrbitalSystem::elapseTime(double seconds) {
 		});
 }
 
+void OrbitalSystem::setTime(double time, double seconds) {
+	std::for_each(orbits_.begin(), orbits_.end(), 
+		[time, seconds](std::pair<AstronomicalObject*, Orbit*> current_orbit) {
+			current_orbit.first->setTime(time, seconds); 
+			current_orbit.second->setTime(time, seconds);  
+		});
+}
+
+/*
+ * OrbitalSystem interpolate:
+ * - Interpolate all orbits and the objects in them.
+ * - Evaluate the matrices of the objects at the interpolated angles.
+ */
+void OrbitalSystem::interpolate(float alpha) {
+	std::for_each(orbits_.begin(), orbits_.end(), 
+		[alpha](std::pair<AstronomicalObject*, Orbit*> current_orbit) {
+			current_orbit.first->interpolate(alpha); 
+			current_orbit.second->interpolate(alpha);  
+		});
+	body_transforms_.evaluate(orbits_);
+}
+
 } // namespace object
 } // namespace simulation
 } // namespace wanderers
@@ -12,7 +12,6 @@
 
 /* Internal Includes */
 #include "simulation/object/model/icosahedron.h"
-#include "simulation/object/model/surface.h"
 
 namespace wanderers {
 namespace simulation {
@@ -20,10 +19,13 @@ namespace object {
 
 Planet::Planet(float radius, glm::vec3 surface_color)
     : Planet{ AstronomicalObject{ AbstractObject{kOrigo, kUp, kFace, glm::vec3{radius}},
-                                  new AggregateObject{Object{model::getDefaultSurface()}}}, surface_color } {}
+                                  new AggregateObject{Object{model::getCoarseIcosahedron()}}}, surface_color } {}
 
 Planet::Planet(AstronomicalObject astronomical_object, glm::vec3 surface_color) 
-	: AstronomicalObject{ astronomical_object }, surface_color_{surface_color} {}
+	: Planet{ astronomical_object, surface_color, kDefaultRoughness, static_cast<unsigned int>(astronomical_object.getObjectId()) } {}
+
+Planet::Planet(AstronomicalObject astronomical_object, glm::vec3 surface_color, float roughness, unsigned int terrain_seed)
+	: AstronomicalObject{ astronomical_object }, surface_color_{ surface_color }, roughness_{ roughness }, terrain_seed_{ terrain_seed } {}
 
 void Planet::setColor(glm::vec3 color) {
 	surface_color_ = color;
@@ -31,6 +33,18 @@ void Planet::setColor(glm::vec3 color) {
 
 glm::vec3 Planet::getColor() { return surface_color_; }
 
+void Planet::setRoughness(float roughness) {
+	roughness_ = roughness;
+}
+
+float Planet::getRoughness() { return roughness_; }
+
+void Planet::setTerrainSeed(unsigned int terrain_seed) {
+	terrain_seed_ = terrain_seed;
+}
+
+unsigned int Planet::getTerrainSeed() { return terrain_seed_; }
+
 } // namespace object
 } // namespace simulation
 } // namespace wanderers
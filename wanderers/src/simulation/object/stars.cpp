@@ -11,24 +11,34 @@
 #include "glm/ext.hpp"
 #include "glm/gtx/rotate_vector.hpp"
 
+/* Internal Includes */
+#include "simulation/object/model/mesh_registry.h"
+
 /* STL Includes */
 #include <random>
 #include <chrono>
+#include <functional>
+#include <thread>
 #include <iostream>
 
 namespace wanderers {
 namespace simulation {
 namespace object {
 
-/* Random generator with seed set as the time of execution. */
-static std::default_random_engine randomizer(std::chrono::system_clock::now().time_since_epoch().count());
+/* Random generator of each thread with seed set as the time of execution and the thread, as stars are generated on workers. */
+static thread_local std::default_random_engine randomizer(
+    std::chrono::system_clock::now().time_since_epoch().count() + std::hash<std::thread::id>{}(std::this_thread::get_id()));
 
 Stars::Stars(float temperature, float size, float distance, model::Points* points) 
-    : AstronomicalObject{ kDefaultObject, new AggregateObject{ new Object{points} } },
+    : AstronomicalObject{ kDefaultObject, new AggregateObject{ new Object{ model::MeshRegistry::getMeshRegistry()->add("stars", points) } } },
       temperature_{ temperature }, size_{ size }, distance_{distance} {}
 
 // TODO: Move generation of stars
 
+void Stars::seedRandomizer(unsigned int seed) {
+    randomizer.seed(seed);
+}
+
 
 glm::vec3 Stars::generateRandomDirection() {
     std::uniform_real_distribution<float> angle(0.0f, 360.0f);
@@ -11,23 +11,27 @@
 #include "glm/ext.hpp"
 
 /* Internal Includes */
+#include "common/scratch_allocator.h"
+#include "common/thread_pool.h"
+#include "simulation/object/aggregate_object.h"
 #include "simulation/object/solar.h"
 #include "simulation/object/planet.h"
 #include "simulation/generator/solar_system_generator.h"
 
 /* STL Includes */
+#include <algorithm>
 #include <typeinfo>
 #include <random>
 #include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
 
 #include <iostream>
 
 namespace wanderers {
 namespace simulation {
 
-/* Random generator with seed set as the time of execution. */
-static std::default_random_engine randomizer(std::chrono::system_clock::now().time_since_epoch().count());
-
 /* 
  * Constructs a catalog of astronomical objects from the passed orbital system. 
  */
@@ -42,62 +46,270 @@ void constructCatalog(std::vector<object::AstronomicalObject*>& catalog, object:
 	}
 }
 
+/*
+ * Collects the meshes of the object, and those of the objects in orbit if it is a system.
+ */
+static void collectMeshes(object::AstronomicalObject* astronomical_object, common::ScratchVector<object::model::Mesh*>& meshes) {
+	object::AggregateObject* physical_object{ astronomical_object->getPhysicalObject() };
+	if (physical_object != nullptr) {
+		for (std::pair<object::Object*, glm::vec3> object : physical_object->getObjects())
+			meshes.push_back(object.first->getModel());
+	}
+	if (typeid(*astronomical_object) == typeid(object::OrbitalSystem)) {
+		for (std::pair<object::AstronomicalObject*, object::Orbit*> orbit : dynamic_cast<object::OrbitalSystem*>(astronomical_object)->getOrbits())
+			collectMeshes(orbit.first, meshes);
+	}
+}
+
+/*
+ * Requests the upload of the meshes of the generated object, packing them on the calling worker.
+ */
+static void requestUploads(object::AstronomicalObject* astronomical_object) {
+	common::ScratchScope scratch_scope{};
+	common::ScratchVector<object::model::Mesh*> meshes{};
+	collectMeshes(astronomical_object, meshes);
+	for (object::model::Mesh* mesh : meshes)
+		mesh->requestUpload();
+}
+
+/*
+ * Uploads the meshes of the object that are not uploaded.
+ * Meshes uploading on the upload thread are only waited for if wait is set, otherwise returns false if any is not done.
+ * Adds the bytes uploaded by the calling thread.
+ */
+static bool uploadMeshes(object::AstronomicalObject* astronomical_object, bool wait, std::size_t& uploaded_bytes) {
+	common::ScratchScope scratch_scope{};
+	common::ScratchVector<object::model::Mesh*> meshes{};
+	collectMeshes(astronomical_object, meshes);
+
+	bool is_uploaded{ true };
+	for (object::model::Mesh* mesh : meshes) {
+		if (mesh->isUploaded())
+			continue;
+		if (mesh->isUploading() && !wait) {
+			is_uploaded = false;
+		} else {
+			const bool is_uploading{ mesh->isUploading() };
+			mesh->upload();
+			if (!is_uploading)
+				uploaded_bytes += mesh->getGpuBytes();
+		}
+	}
+	return is_uploaded;
+}
+
 /*
  * SpaceSimulation: 
- * - Generate solar system.
- * - Generate stars.
- * - Construct catalog.
+ * - Seed the random generators with the time of execution.
+ */
+SpaceSimulation::SpaceSimulation(object::CameraObject* camera_object)
+	: SpaceSimulation{ camera_object, static_cast<unsigned int>(std::chrono::system_clock::now().time_since_epoch().count()) } {}
+
+/*
+ * SpaceSimulation: 
+ * - Seed the random generators of this thread and generate the home solar system and construct its catalog.
+ * - Queue jobs generating the other solar systems, then the stars.
+ *   The parameters and a seed for each job are drawn here, the jobs only draw the positions.
+ * - Submit the first jobs.
  * - Set camera focus to first object in catalog.
  */
-SpaceSimulation::SpaceSimulation(object::CameraObject* camera_object) : solar_systems_{},
+SpaceSimulation::SpaceSimulation(object::CameraObject* camera_object, unsigned int seed) : solar_systems_{},
+	                                 system_schedules_{},
                                      group_of_stars_{},
 	                                 camera_object_{camera_object},
 	                                 astrological_catalog_{},
 	                                 is_paused_{false},
 	                                 simulation_speed_{1.0f},
-	camera_focus_id_{ 0 } {
+	time_step_{ kDefaultTimeStep },
+	max_substeps_{ kDefaultMaxSubsteps },
+	accumulated_time_{ 0.0 },
+	simulated_time_{ 0.0 },
+	interpolation_{ 0.0f },
+	frame_graph_{},
+	system_updates_{ 0 },
+	step_count_{ 0 },
+	camera_focus_id_{ 0 },
+	catalog_mutex_{},
+	waiting_jobs_{},
+	generated_{},
+	running_jobs_{ 0 },
+	submitted_jobs_{ 0 },
+	added_jobs_{ 0 },
+	generated_mutex_{},
+	generated_condition_{} {
 	std::uniform_real_distribution<float> temperature(4000.0f, 10000.0f);
 	std::uniform_real_distribution<float> size(0.2f, 2.0f);
 	std::uniform_real_distribution<float> cluster_count(0.0f, 5.0f);
 	std::uniform_real_distribution<float> cluster_radius(0.2f, 2.0f);
 	std::uniform_real_distribution<float> distance_multiplier(1.0f, 3.0f);
+	std::uniform_int_distribution<unsigned int> job_seed{};
+
+	std::default_random_engine randomizer{ seed };
+	generator::seedRandomizer(seed);
+	object::Stars::seedRandomizer(seed);
 
 	addSolarSystem(generator::generateTheSolarSystem());
+	constructCatalog(astrological_catalog_, solar_systems_.front());
+
 	for (int i = 0; i < 25; i++) {
-		object::OrbitalSystem* system = generator::generateSolarSystem(10.0f);
-		system->setPosition(object::Stars::generateRandomDirection() * 5000.0f * distance_multiplier(randomizer));
-		system->setOrientation(object::Stars::generateRandomDirection());
-		addSolarSystem(system);
+		float distance{ 5000.0f * distance_multiplier(randomizer) };
+		waiting_jobs_.push_back({ job_seed(randomizer), [distance]() {
+			object::OrbitalSystem* system = generator::generateSolarSystem(10.0f);
+			system->setPosition(object::Stars::generateRandomDirection() * distance);
+			system->setOrientation(object::Stars::generateRandomDirection());
+			return GeneratedObject{ system, nullptr };
+		} });
 	}
 
 	for (int i = 0; i < 10; i++) {
-		std::cout << "Group: " << i << std::endl;
-		addStars(new object::Stars{ temperature(randomizer), 1.5f * size(randomizer), 1'000, object::Stars::generateStars(1000, 100) });
-		addStars(new object::Stars{ temperature(randomizer), size(randomizer), 100'000, object::Stars::generateGalaxyDisc(1000) });
+		float stars_temperature{ temperature(randomizer) };
+		float stars_size{ 1.5f * size(randomizer) };
+		waiting_jobs_.push_back({ job_seed(randomizer), [stars_temperature, stars_size]() {
+			return GeneratedObject{ nullptr, new object::Stars{ stars_temperature, stars_size, 1'000, object::Stars::generateStars(1000, 100) } };
+		} });
+		float disc_temperature{ temperature(randomizer) };
+		float disc_size{ size(randomizer) };
+		waiting_jobs_.push_back({ job_seed(randomizer), [disc_temperature, disc_size]() {
+			return GeneratedObject{ nullptr, new object::Stars{ disc_temperature, disc_size, 100'000, object::Stars::generateGalaxyDisc(1000) } };
+		} });
 		float radius = cluster_radius(randomizer);
 		glm::vec3 cluster_center = object::Stars::generateRandomDirection();
 		for (int j = 0; j < 25; j++) {
-			float count = cluster_count(randomizer);
-			addStars(new object::Stars{ temperature(randomizer), size(randomizer) * radius * 0.5f, 10'000, object::Stars::generateCluster(count, radius, cluster_center) });
+			int count = static_cast<int>(cluster_count(randomizer));
+			float cluster_temperature{ temperature(randomizer) };
+			float cluster_size{ size(randomizer) * radius * 0.5f };
+			waiting_jobs_.push_back({ job_seed(randomizer), [count, radius, cluster_center, cluster_temperature, cluster_size]() {
+				return GeneratedObject{ nullptr, new object::Stars{ cluster_temperature, cluster_size, 10'000, object::Stars::generateCluster(count, radius, cluster_center) } };
+			} });
 		}
 	}
 
-	for (object::OrbitalSystem* system : solar_systems_) {
-		constructCatalog(astrological_catalog_, system);
-	}
+	submitGeneration();
 
-	camera_object_->withMutext([this]() { camera_object_->setCameraFocus(astrological_catalog_.at(0)); });
+	std::lock_guard<object::CameraObject> guard{ *camera_object_ };
+	camera_object_->setCameraFocus(astrological_catalog_.at(0));
 }
 
 
+/*
+ * SpaceSimulation addSolarSystem:
+ * - Add the system, updated every step until scheduled.
+ *   Its first update sets it to the simulated time, as far as if it had been there from the start.
+ */
 void SpaceSimulation::addSolarSystem(object::OrbitalSystem* solar_system) {
 	solar_systems_.push_back(solar_system); 
+
+	glm::mat4 system_matrix{ solar_system->getMatrix() };
+	float scale{ std::max(glm::length(glm::vec3{ system_matrix[0] }),
+	                      std::max(glm::length(glm::vec3{ system_matrix[1] }), glm::length(glm::vec3{ system_matrix[2] }))) };
+	system_schedules_.push_back({ scale * solar_system->getBoundingRadius(), 1, 0 });
 }
 
 void SpaceSimulation::addStars(object::Stars* stars) { 
 	group_of_stars_.push_back(stars); 
 }
 
+/*
+ * SpaceSimulation submitGeneration:
+ * - While there are waiting jobs and room for their objects:
+ *   - Submit the next job, numbered in the order submitted.
+ *   - The job seeds the random generators of the worker, generates the object and adds it
+ *     to the generated objects, which are kept in the order of the jobs.
+ */
+void SpaceSimulation::submitGeneration() {
+	std::lock_guard<std::mutex> guard{ generated_mutex_ };
+	while (!waiting_jobs_.empty() && running_jobs_ + generated_.size() < kMaxGenerated) {
+		GenerationJob job{ std::move(waiting_jobs_.front()) };
+		waiting_jobs_.pop_front();
+		running_jobs_++;
+		std::size_t order{ submitted_jobs_++ };
+		common::ThreadPool::getThreadPool()->submit([this, job, order]() {
+			generator::seedRandomizer(job.seed);
+			object::Stars::seedRandomizer(job.seed);
+			GeneratedObject generated{ job.generate() };
+			generated.order = order;
+			if (generated.system != nullptr)
+				requestUploads(generated.system);
+			else
+				requestUploads(generated.stars);
+			std::lock_guard<std::mutex> guard{ generated_mutex_ };
+			generated_.insert(std::find_if(generated_.begin(), generated_.end(),
+			                               [order](const GeneratedObject& other) { return other.order > order; }), generated);
+			running_jobs_--;
+			generated_condition_.notify_all();
+		});
+	}
+}
+
+void SpaceSimulation::streamGenerated(std::size_t upload_budget) {
+	addGenerated(upload_budget, false);
+}
+
+/*
+ * SpaceSimulation addGenerated:
+ * - Until the upload budget is used or the object of the next job is not generated:
+ *   - Look at the object of the next job, only this thread takes objects.
+ *     Objects are added in the order of their jobs, so a seed gives the same catalog whichever job finishes first.
+ *   - Upload its meshes, so the first frame drawing it does not stall.
+ *     Stop if they are on the upload thread and not done, unless waiting.
+ *   - Take it and add it to the simulation, adding systems to the catalog.
+ * - Submit jobs for the objects taken.
+ */
+void SpaceSimulation::addGenerated(std::size_t upload_budget, bool wait) {
+	std::size_t uploaded_bytes{ 0 };
+	do {
+		GeneratedObject generated{};
+		{
+			std::lock_guard<std::mutex> guard{ generated_mutex_ };
+			if (generated_.empty() || generated_.front().order != added_jobs_)
+				break;
+			generated = generated_.front();
+		}
+
+		object::AstronomicalObject* generated_object{ generated.system != nullptr ? 
+		                                              static_cast<object::AstronomicalObject*>(generated.system) : generated.stars };
+		if (!uploadMeshes(generated_object, wait, uploaded_bytes))
+			break;
+
+		{
+			std::lock_guard<std::mutex> guard{ generated_mutex_ };
+			generated_.pop_front();
+			added_jobs_++;
+		}
+
+		if (generated.system != nullptr) {
+			addSolarSystem(generated.system);
+			std::lock_guard<std::mutex> guard{ catalog_mutex_ };
+			constructCatalog(astrological_catalog_, generated.system);
+		} else {
+			addStars(generated.stars);
+		}
+	} while (uploaded_bytes < upload_budget);
+
+	submitGeneration();
+}
+
+/*
+ * SpaceSimulation finishGeneration:
+ * - Until all objects are added:
+ *   - Wait for the object of the next job, or for no job to be running.
+ *   - Add all generated objects.
+ */
+void SpaceSimulation::finishGeneration() {
+	while (!isGenerated()) {
+		{
+			std::unique_lock<std::mutex> lock{ generated_mutex_ };
+			generated_condition_.wait(lock, [this]() { return (!generated_.empty() && generated_.front().order == added_jobs_) || running_jobs_ == 0; });
+		}
+		addGenerated(std::numeric_limits<std::size_t>::max(), true);
+	}
+}
+
+bool SpaceSimulation::isGenerated() {
+	std::lock_guard<std::mutex> guard{ generated_mutex_ };
+	return waiting_jobs_.empty() && running_jobs_ == 0 && generated_.empty();
+}
+
 std::vector<object::OrbitalSystem*> SpaceSimulation::getSolarSystems() {
 	return solar_systems_; 
 }
@@ -107,10 +319,179 @@ std::vector<object::Stars*> SpaceSimulation::getGroupOfStars() {
 }
 
 void SpaceSimulation::elapseTime(double seconds) {
-	for (object::OrbitalSystem* solar_system : solar_systems_) {
-		solar_system->elapseTime(static_cast<int>(!is_paused_) * seconds * simulation_speed_);
+	startElapseTime(seconds);
+	finishElapseTime();
+}
+
+/*
+ * SpaceSimulation startElapseTime:
+ * - Wait for the last advance if not finished.
+ * - Add the passed time to the time not yet simulated.
+ * - Count the steps that fit in it, at most the max number of steps.
+ *   If the max is reached the rest is dropped, so a slow frame does not make the next one slower.
+ *   The seconds of a step are scaled by the speed, or none if paused.
+ * - Build the graph of the frame:
+ *   - Schedule the updates of the solar systems.
+ *   - Then for each chunk of solar systems, take the steps and interpolate the systems updated on the last step
+ *     by the fraction of a step left.
+ *   - Then follow the camera focus at its interpolated position.
+ * - Start the graph.
+ */
+void SpaceSimulation::startElapseTime(double seconds) {
+	finishElapseTime();
+	system_updates_ = 0;
+
+	accumulated_time_ += seconds;
+
+	int substeps{ 0 };
+	while (accumulated_time_ >= time_step_ && substeps < max_substeps_) {
+		accumulated_time_ -= time_step_;
+		substeps++;
 	}
-	camera_object_->withMutext([this, seconds] { camera_object_->elapseTime(static_cast<int>(!is_paused_) * seconds * simulation_speed_); });
+	if (accumulated_time_ >= time_step_)
+		accumulated_time_ = std::fmod(accumulated_time_, time_step_);
+
+	const double step_seconds{ static_cast<int>(!is_paused_) * time_step_ * simulation_speed_ };
+	const double start_time{ simulated_time_ };
+	step_count_ += substeps;
+	for (int step = 0; step < substeps; step++)
+		simulated_time_ += step_seconds;
+	interpolation_ = static_cast<float>(accumulated_time_ / time_step_);
+
+	frame_graph_.clear();
+	const common::TaskGraph::TaskId schedule_task{ frame_graph_.addTask("schedule", [this]() { scheduleSystems(); }) };
+
+	std::vector<common::TaskGraph::TaskId> advance_tasks{};
+	const float interpolation{ interpolation_ };
+	for (std::size_t begin = 0; begin < solar_systems_.size(); begin += kSystemsPerTask) {
+		const std::size_t end{ std::min(begin + kSystemsPerTask, solar_systems_.size()) };
+		advance_tasks.push_back(frame_graph_.addTask("advance systems", [this, begin, end, substeps, step_seconds, start_time, interpolation]() {
+			for (std::size_t i = begin; i < end; i++) {
+				const bool updated{ stepSystem(i, substeps, step_seconds, start_time) };
+				// A system updated before the last step shows its update, and a system not updated keeps
+				// its state, as its angles span its last update and not the steps since.
+				if (system_schedules_[i].steps_behind == 0)
+					solar_systems_[i]->interpolate(interpolation);
+				else if (updated)
+					solar_systems_[i]->interpolate(1.0f);
+			}
+		}, { schedule_task }));
+	}
+
+	frame_graph_.addTask("camera", [this, seconds]() {
+		std::lock_guard<object::CameraObject> guard{ *camera_object_ };
+		camera_object_->elapseTime(seconds);
+	}, advance_tasks);
+
+	frame_graph_.start();
+}
+
+void SpaceSimulation::finishElapseTime() {
+	frame_graph_.wait();
+}
+
+void SpaceSimulation::reportFrame(std::ostream& out) {
+	frame_graph_.report(out);
+}
+
+/*
+ * SpaceSimulation stepSystem:
+ * - For each step:
+ *   - Add the step to the time the same way as the simulated time, and count it as behind.
+ *   - If it is due, set the solar system to the time, with the previous state a single step before
+ *     so the system is interpolated over a single step.
+ *     The state only depends on the time, so it is the same however often the system is updated.
+ * - Return true if it was updated.
+ */
+bool SpaceSimulation::stepSystem(std::size_t index, int steps, double seconds, double time) {
+	bool updated{ false };
+	SystemSchedule& schedule{ system_schedules_[index] };
+	for (int step = 0; step < steps; step++) {
+		time += seconds;
+		schedule.steps_behind++;
+		if (schedule.steps_behind < schedule.interval)
+			continue;
+
+		solar_systems_[index]->setTime(time, seconds);
+		schedule.steps_behind = 0;
+		system_updates_++;
+		updated = true;
+	}
+	return updated;
+}
+
+/*
+ * SpaceSimulation scheduleSystems:
+ * - Find the solar system of the camera focus, it is updated every step.
+ * - For each other solar system:
+ *   - Find the angle it covers seen from the camera.
+ *   - Update it every step if the angle is above the full detail angle, otherwise
+ *     as many times less often as it is smaller, rounded to a power of two.
+ *   - Update it less often if it is entirely behind the camera.
+ */
+void SpaceSimulation::scheduleSystems() {
+	glm::vec3 camera_position;
+	glm::vec3 camera_direction;
+	object::AstronomicalObject* focus_system;
+	{
+		std::lock_guard<object::CameraObject> guard{ *camera_object_ };
+		camera_position = camera_object_->getPosition();
+		camera_direction = camera_object_->getDirection();
+		focus_system = camera_object_->getCameraFocus();
+	}
+	while (focus_system != nullptr && focus_system->getParent() != nullptr)
+		focus_system = focus_system->getParent();
+
+	for (std::size_t i = 0; i < solar_systems_.size(); i++) {
+		SystemSchedule& schedule{ system_schedules_[i] };
+		if (solar_systems_[i] == focus_system) {
+			schedule.interval = 1;
+			continue;
+		}
+
+		glm::vec3 to_system{ solar_systems_[i]->getPosition() - camera_position };
+		float distance{ glm::length(to_system) };
+		float angle{ distance > schedule.radius ? schedule.radius / distance : kFullDetailAngle };
+
+		unsigned int interval{ 1 };
+		while (interval < kMaxUpdateInterval && angle * interval * 2 <= kFullDetailAngle)
+			interval *= 2;
+		if (glm::dot(to_system, camera_direction) < -schedule.radius)
+			interval = std::min(interval * kOffscreenIntervalFactor, kMaxUpdateInterval);
+		schedule.interval = interval;
+	}
+}
+
+void SpaceSimulation::setTimeStep(double time_step) {
+	time_step_ = time_step;
+}
+
+double SpaceSimulation::getTimeStep() {
+	return time_step_;
+}
+
+void SpaceSimulation::setMaxSubsteps(int max_substeps) {
+	max_substeps_ = max_substeps;
+}
+
+int SpaceSimulation::getMaxSubsteps() {
+	return max_substeps_;
+}
+
+unsigned long long SpaceSimulation::getStepCount() {
+	return step_count_;
+}
+
+double SpaceSimulation::getSimulatedTime() {
+	return simulated_time_;
+}
+
+float SpaceSimulation::getInterpolation() {
+	return interpolation_;
+}
+
+unsigned int SpaceSimulation::getSystemUpdates() {
+	return system_updates_;
 }
 
 void SpaceSimulation::pause() {
@@ -138,22 +519,38 @@ unsigned int SpaceSimulation::getCameraFocusId() {
 }
 
 void SpaceSimulation::setCameraFocusId(unsigned int focus_id) {
+	std::lock_guard<std::mutex> catalog_guard{ catalog_mutex_ };
 	camera_focus_id_ = focus_id % astrological_catalog_.size();
-	camera_object_->withMutext([this]() {camera_object_->setCameraFocus(astrological_catalog_.at(camera_focus_id_)); });
+	std::lock_guard<object::CameraObject> guard{ *camera_object_ };
+	camera_object_->setCameraFocus(astrological_catalog_.at(camera_focus_id_));
 }
 
 unsigned int SpaceSimulation::cycleCameraFocusId() {
-	camera_focus_id_ = (camera_focus_id_ + 1) % astrological_catalog_.size();
-	setCameraFocusId(camera_focus_id_);
+	setCameraFocusId(camera_focus_id_ + 1);
 	return camera_focus_id_;
 }
 
 /*
  * SpaceSimulation Destructor:
+ * - Wait for the last advance.
+ * - Drop the waiting jobs and wait for the running ones.
+ * - Destroy the objects generated but not added.
  * - Destroy solar system.
  * - Destroy stars.
  */
 SpaceSimulation::~SpaceSimulation() {
+	finishElapseTime();
+
+	{
+		std::unique_lock<std::mutex> lock{ generated_mutex_ };
+		waiting_jobs_.clear();
+		generated_condition_.wait(lock, [this]() { return running_jobs_ == 0; });
+	}
+	for (GeneratedObject generated : generated_) {
+		delete generated.system;
+		delete generated.stars;
+	}
+
 	for(object::OrbitalSystem* solar_system : solar_systems_)
 		delete solar_system;
 	for (object::Stars* stars : group_of_stars_)
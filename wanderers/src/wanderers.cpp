@@ -16,7 +16,9 @@
 
 /* Internal Includes */
 #include "render/camera.h"
+#include "render/frame_timer.h"
 #include "render/shader/shader_program.h"
+#include "render/upload_thread.h"
 #include "simulation/space_simulation.h"
 #include "simulation/object/stars.h"
 #include "simulation/generator/solar_system_generator.h"
@@ -25,86 +27,317 @@
 /* STL Includes */
 #include <random>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
 
 namespace wanderers {
 
+/* Seed of the universe flown through unless another is set, so every run renders the same frames. */
+static constexpr unsigned int kFlythroughSeed{ 1 };
+
+/*
+ *  parseOptions:
+ *  - For each argument:
+ *    - Set the option it names, reading its value from the next argument.
+ *  - Return the options.
+ */
+RunOptions parseOptions(int argc, char** args) {
+	RunOptions options{};
+	for (int i = 1; i < argc; i++) {
+		const char* option{ args[i] };
+		const char* value{ i + 1 < argc ? args[i + 1] : "" };
+		if (std::strcmp(option, "--offscreen") == 0) {
+			options.offscreen = true;
+		} else if (std::strcmp(option, "--osmesa") == 0) {
+			options.context_api = GLFW_OSMESA_CONTEXT_API;
+		} else if (std::strcmp(option, "--width") == 0) {
+			options.width = std::atoi(value); i++;
+		} else if (std::strcmp(option, "--height") == 0) {
+			options.height = std::atoi(value); i++;
+		} else if (std::strcmp(option, "--samples") == 0) {
+			options.samples = std::atoi(value); i++;
+		} else if (std::strcmp(option, "--frames") == 0) {
+			options.frame_count = std::atoi(value); i++;
+		} else if (std::strcmp(option, "--step") == 0) {
+			options.time_step = std::atof(value); i++;
+		} else if (std::strcmp(option, "--simulation-step") == 0) {
+			options.simulation_step = std::atof(value); i++;
+		} else if (std::strcmp(option, "--max-substeps") == 0) {
+			options.max_substeps = std::atoi(value); i++;
+		} else if (std::strcmp(option, "--output") == 0) {
+			options.output_directory = value; i++;
+		} else if (std::strcmp(option, "--cpu-terrain") == 0) {
+			options.cpu_terrain = true;
+		} else if (std::strcmp(option, "--capture") == 0) {
+			options.capture = true;
+		} else if (std::strcmp(option, "--latency") == 0) {
+			options.measure_latency = true;
+		} else if (std::strcmp(option, "--raw") == 0) {
+			options.frame_format = render::FrameWriter::FrameFormat::Raw;
+		} else if (std::strcmp(option, "--flythrough") == 0) {
+			options.flythrough = true;
+		} else if (std::strcmp(option, "--script") == 0) {
+			options.script = value; i++;
+		} else if (std::strcmp(option, "--report") == 0) {
+			options.report = value; i++;
+		} else if (std::strcmp(option, "--seed") == 0) {
+			options.seed = static_cast<unsigned int>(std::strtoul(value, nullptr, 10)); i++;
+		} else {
+			std::cout << "Warning: Unknown option " << option << "." << std::endl;
+		}
+	}
+	if (options.flythrough && options.seed == 0)
+		options.seed = kFlythroughSeed;
+	return options;
+}
+
 /*  
  *  setupWindow:
- *  - Create window.
- *  - Make window the current context.
+ *  - If offscreen, create a hidden window with the offscreen context creation API.
+ *  - Otherwise create fullscreen window.
+ *  - Make window the current context, return null if it could not be created.
+ *  - Sync swapping with the monitor refresh rate only when on screen and not timing a flythrough.
  */
-GLFWwindow* setupWindow() {
+GLFWwindow* setupWindow(const RunOptions& options) {
 	const char* window_title{ "Wanderers" };
-	constexpr int window_width{ 1920 };
-	constexpr int window_height{ 1080 };
 
-	GLFWwindow* window{ glfwCreateWindow(window_width, window_height, window_title, glfwGetPrimaryMonitor(), nullptr) };
+	GLFWwindow* window;
+	if (options.offscreen) {
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, options.context_api);
+		// The frames are rendered into a framebuffer object, the window surface is never drawn to.
+		window = glfwCreateWindow(1, 1, window_title, nullptr, nullptr);
+	} else {
+		window = glfwCreateWindow(options.width, options.height, window_title, glfwGetPrimaryMonitor(), nullptr);
+	}
+	if (window == nullptr)
+		return nullptr;
 
 	glfwMakeContextCurrent(window);
-	glfwSwapInterval(1);
+	glfwSwapInterval(options.offscreen || options.flythrough ? 0 : 1);
 
 	return window;
 }
 
 /*  
  *  renderLoop:
+ *  - Once the renderer has prepared a frame, start proceeding the simulation by the time since
+ *    the last start, in fixed steps, so it runs while the frame is drawn.
  *  - Until exit is requested:
- *    - Proceed simulation.
+ *    - Wait for the simulation to be proceeded.
+ *    - Add the objects generated since the last frame.
  *    - Render.
+ *    - Let the controller handle the input polled with the frame.
+ *  - Wait for the last proceed of the simulation.
  */
 void renderLoop(simulation::SpaceSimulation* simulation, render::SpaceRenderer* renderer) {
 	double last_time{ glfwGetTime() };
-
-	while (!glfwWindowShouldClose(glfwGetCurrentContext())) {
+	renderer->setFramePrepared([simulation, &last_time]() {
 		double dt = glfwGetTime() - last_time;
 		last_time += dt;
+		simulation->startElapseTime(dt);
+	});
+
+	while (!glfwWindowShouldClose(glfwGetCurrentContext())) {
+		simulation->finishElapseTime();
+
+		simulation->streamGenerated();
+
+		renderer->render(simulation);
 
-		simulation->elapseTime(dt);
+		if (control::Controller::getController() != nullptr)
+			control::Controller::getController()->notifyFrame();
+	}
+
+	simulation->finishElapseTime();
+	renderer->setFramePrepared(nullptr);
+}
+
+/*
+ *  offscreenLoop:
+ *  - Wait for all objects to be generated, so every frame shows the same objects.
+ *  - For each frame:
+ *    - Proceed simulation with the fixed time step.
+ *    - Render into the framebuffer, the renderer captures the frame.
+ *  - Wait for the captured frames to be written.
+ */
+void offscreenLoop(simulation::SpaceSimulation* simulation, render::SpaceRenderer* renderer, const RunOptions& options) {
+	render::FrameCapture* frame_capture{ renderer->getFrameCapture() };
+	frame_capture->setCapturing(true);
+
+	simulation->finishGeneration();
+
+	for (int frame = 0; frame < options.frame_count; frame++) {
+		simulation->elapseTime(options.time_step);
 
 		renderer->render(simulation);
 	}
+
+	frame_capture->flush();
+	std::cout << "Captured " << frame_capture->getCapturedFrames() << " frames, dropped "
+	          << frame_capture->getDroppedFrames() << "." << std::endl;
+}
+
+/*
+ *  flythroughLoop:
+ *  - Wait for all objects to be generated, so every run shows the same objects.
+ *  - Once the renderer has prepared a frame, start proceeding the simulation by the fixed time step.
+ *  - For each frame until the end of the path:
+ *    - Wait for the simulation to be proceeded.
+ *    - Move the camera to where it is on the path.
+ *    - Render, timing the frame on the CPU and the GPU.
+ *  - Wait for the last proceed of the simulation and the times of the last frames.
+ *  - Report the percentiles of the frame times, and write the times as JSON if asked for.
+ */
+void flythroughLoop(simulation::SpaceSimulation* simulation, render::SpaceRenderer* renderer, render::Camera* camera,
+                    control::Flythrough* flythrough, const RunOptions& options) {
+	simulation->finishGeneration();
+
+	const double time_step{ options.time_step };
+	renderer->setFramePrepared([simulation, time_step]() {
+		simulation->startElapseTime(time_step);
+	});
+
+	render::FrameTimer frame_timer{};
+	const int frame_count{ static_cast<int>(flythrough->getDuration() / time_step) + 1 };
+	for (int frame = 0; frame < frame_count && !glfwWindowShouldClose(glfwGetCurrentContext()); frame++) {
+		frame_timer.beginFrame();
+
+		simulation->finishElapseTime();
+
+		flythrough->apply(frame * time_step, simulation, camera);
+
+		renderer->render(simulation);
+
+		frame_timer.endFrame();
+	}
+
+	simulation->finishElapseTime();
+	renderer->setFramePrepared(nullptr);
+
+	frame_timer.finish();
+	frame_timer.report(std::cout);
+	if (!options.report.empty()) {
+		std::ofstream report{ options.report };
+		if (report)
+			frame_timer.writeJson(report);
+		else
+			std::cout << "Error: Could not open " << options.report << " for writing." << std::endl;
+	}
 }
 
 /*
  *  run:
- *  - Init graphics.
+ *  - Init graphics and start the upload thread, stopping if there is no context.
  *  - Setup simulation, render engine and controller.
- *  - Enter render loop until program exit is requested.
+ *  - If flying through, fly the camera along the path and report the frame times, into a framebuffer if offscreen.
+ *  - If offscreen, render the frames into a framebuffer and write them to disk.
+ *  - Otherwise enter render loop until program exit is requested, capturing frames and measuring latency on request.
  */
-void run() {
+void run(const RunOptions& options) {
 	// Init graphics.
-	glfwInit();
+	if (glfwInit() == GLFW_FALSE) {
+		std::cout << "Error: Could not initialize GLFW." << std::endl;
+		return;
+	}
 	
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
 
-	glfwWindowHint(GLFW_SAMPLES, 16);
+	// Offscreen the framebuffer object is multisampled instead of the window.
+	glfwWindowHint(GLFW_SAMPLES, options.offscreen ? 0 : options.samples);
 	
-	GLFWwindow* window{ setupWindow() };
+	GLFWwindow* window{ setupWindow(options) };
+	if (window == nullptr) {
+		std::cout << "Error: Could not create a window with an OpenGL 4.6 context." << std::endl;
+		glfwTerminate();
+		return;
+	}
 	
-	gladLoadGL(glfwGetProcAddress);
+	if (gladLoadGL(glfwGetProcAddress) == 0) {
+		std::cout << "Error: Could not load OpenGL." << std::endl;
+		glfwDestroyWindow(window);
+		glfwTerminate();
+		return;
+	}
+
+	// Upload generated meshes on their own thread.
+	render::UploadThread::initUploadThread(window);
 	
 	// Setup simulation.
 	render::Camera* camera{ new render::Camera{glm::vec3{0.0f, 25.0f, 0.0f}, glm::vec3{0.0f, -1.0f, 0.0f}, glm::vec3{0.0f, 0.0f, 1.0f}, 60.0f, 1.0f, 0.1f, 100000.0f } };
-	simulation::SpaceSimulation* space_simulation = new simulation::SpaceSimulation{camera};
+	simulation::SpaceSimulation* space_simulation = options.seed != 0 ? new simulation::SpaceSimulation{ camera, options.seed }
+	                                                                  : new simulation::SpaceSimulation{ camera };
+	if (options.simulation_step > 0.0)
+		space_simulation->setTimeStep(options.simulation_step);
+	if (options.max_substeps > 0)
+		space_simulation->setMaxSubsteps(options.max_substeps);
 	
 	// Setup render engine.
 	render::shader::ShaderProgram* shader{ new render::shader::ShaderProgram{"shaders/vertex.glsl", "shaders/fragment.glsl"} };
 	shader->link();
 	
 	render::SpaceRenderer* space_renderer = new render::SpaceRenderer{ shader, camera };
+	if (options.cpu_terrain)
+		space_renderer->setTessellateTerrain(false);
 	
-	// Setup controller
-	control::Controller::initController(camera, space_simulation, space_renderer);
-	
-	// Render loop until exit is requested.
-	renderLoop(space_simulation, space_renderer);
-	
-	// Program exit.
-	control::Controller::deinitController();
+	if (options.flythrough) {
+		// The path is flown without input, and timed without capturing the frames.
+		control::Flythrough* flythrough{ new control::Flythrough{} };
+		if (options.script.empty() || flythrough->load(options.script) == 0) {
+			render::FrameBuffer* frame_buffer{ options.offscreen ? new render::FrameBuffer{ options.width, options.height, options.samples } : nullptr };
+			space_renderer->setFrameBuffer(frame_buffer);
+
+			flythroughLoop(space_simulation, space_renderer, camera, flythrough, options);
+
+			space_renderer->setFrameBuffer(nullptr);
+			delete frame_buffer;
+		}
+		delete flythrough;
+	} else if (options.offscreen) {
+		// Render the frames offscreen, no input is taken.
+		render::FrameBuffer* frame_buffer{ new render::FrameBuffer{ options.width, options.height, options.samples } };
+		space_renderer->setFrameBuffer(frame_buffer);
+
+		// Every frame is written, so wait on the GPU and the writer instead of dropping frames.
+		render::FrameCapture* frame_capture{ new render::FrameCapture{ options.output_directory, options.frame_format, 3, false } };
+		space_renderer->setFrameCapture(frame_capture);
+
+		offscreenLoop(space_simulation, space_renderer, options);
+
+		space_renderer->setFrameCapture(nullptr);
+		delete frame_capture;
+
+		space_renderer->setFrameBuffer(nullptr);
+		delete frame_buffer;
+	} else {
+		render::FrameCapture* frame_capture{ new render::FrameCapture{ options.output_directory, options.frame_format } };
+		frame_capture->setCapturing(options.capture);
+		space_renderer->setFrameCapture(frame_capture);
+		space_renderer->getLatencyMeter()->setEnabled(options.measure_latency);
+
+		// Setup controller
+		control::Controller::initController(camera, space_simulation, space_renderer);
+		
+		// Render loop until exit is requested.
+		renderLoop(space_simulation, space_renderer);
+		
+		// Program exit.
+		control::Controller::deinitController();
+
+		if (space_renderer->getLatencyMeter()->getEnabled())
+			space_renderer->getLatencyMeter()->report(std::cout);
+
+		space_renderer->setFrameCapture(nullptr);
+		delete frame_capture;
+	}
 	
 	delete space_renderer;
 	delete space_simulation;
+
+	render::UploadThread::deinitUploadThread();
 	
 	glfwDestroyWindow(window);
 	glfwTerminate();